@@ -0,0 +1,59 @@
+/**
+ * @file PerfCounters.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the optional hardware performance counters reported by the benchmarks.
+ * @version 0.1
+ * @date 2023-02-21
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_BENCH_INCLUDE_PERFCOUNTERS_HPP
+#define LIBBORR_BENCH_INCLUDE_PERFCOUNTERS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace borrbench {
+
+    using std::string;
+    using std::vector;
+
+    constexpr const char* PERF_COUNTERS_FLAG = "--borr_perf_counters"; //!< The command-line flag enabling performance counters
+
+    bool    enablePerfCounters(); //!< Probes which performance counters can be opened; returns false if none can
+    bool    perfCountersEnabled(); //!< Determines whether performance counters were enabled
+
+    /**
+     * @brief Counts hardware and software events of the calling thread for the lifetime of the object.
+     *
+     * Construct one in front of a benchmark's loop; once it goes out of scope, every counter which could be opened
+     * is reported per iteration (cycles, instructions, branch_misses, l1d_misses, llc_misses, page_faults).
+     * Counters which aren't available - no PMU in a container, perf_event_paranoid too strict, no Linux - are omitted.
+     * Only user space events are counted, which is permitted with the default perf_event_paranoid of 2.
+     * Work which is excluded from the wall-clock time with State::PauseTiming() must be excluded with pause() and resume() as well.
+     *
+     * If performance counters weren't enabled with enablePerfCounters(), this does nothing.
+     */
+    class perf_scope {
+        public:
+            explicit perf_scope(benchmark::State& state);
+            ~perf_scope();
+
+            perf_scope(const perf_scope&) = delete;
+            perf_scope& operator=(const perf_scope&) = delete;
+
+            void    pause(); //!< Stops all counters, e.g. together with State::PauseTiming()
+            void    resume(); //!< Restarts all counters after pause()
+
+        private:
+            benchmark::State&   m_state; //!< The benchmark the counters are reported to
+            vector<int32_t>     m_fds{}; //!< One file descriptor per available event; -1 if the event couldn't be opened
+    };
+
+}
+
+#endif // LIBBORR_BENCH_INCLUDE_PERFCOUNTERS_HPP
@@ -0,0 +1,64 @@
+/**
+ * @file SyntheticData.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the synthetic catalogs shared by all benchmarks.
+ * @version 0.1
+ * @date 2023-02-16
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_BENCH_INCLUDE_SYNTHETICDATA_HPP
+#define LIBBORR_BENCH_INCLUDE_SYNTHETICDATA_HPP
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <borr/language.hpp>
+
+namespace borrbench {
+
+    namespace fs = std::filesystem;
+
+    using std::string;
+    using std::vector;
+
+    /**
+     * @brief A single synthetic translation.
+     */
+    struct synthentry_t {
+        string  section; //!< The section (or gettext context) of the translation
+        string  field; //!< The field (or gettext msgid) of the translation
+        string  value; //!< The borr value; may contain ${meta:app_name}
+        string  gettextValue; //!< The gettext value; ${meta:app_name} is replaced with %s
+        string  gettextKey; //!< The key passed to dgettext(): section\x04field
+        bool    hasVariable; //!< Whether or not the value contains a variable
+    };
+
+    /**
+     * @brief A synthetic catalog, generated deterministically for a given size.
+     */
+    struct synthcatalog_t {
+        vector<synthentry_t>    entries{}; //!< All translations
+        vector<size_t>          accessOrder{}; //!< A random permutation of entries used for lookups
+        vector<size_t>          renderOrder{}; //!< Indices of entries containing variables, in random order
+        string                  borrfile{}; //!< The catalog as a borrfile
+        fs::path                moFile{}; //!< The catalog as a .mo file
+        string                  gettextDomain{}; //!< The gettext text domain bound to moFile
+    };
+
+    constexpr const char* APP_NAME_SECTION = "meta"; //!< The section containing the application name
+    constexpr const char* APP_NAME_FIELD = "app_name"; //!< The field containing the application name
+    constexpr const char* APP_NAME_VALUE = "libborr"; //!< The application name
+
+    const synthcatalog_t&   getCatalog(size_t keyCount); //!< Gets (and generates on first use) the catalog of a given size
+    const borr::language&   getLanguage(size_t keyCount); //!< Gets the parsed borrfile of the catalog of a given size
+    const borr::language&   getMoLanguage(size_t keyCount); //!< Gets the mapped .mo file of the catalog of a given size
+
+    bool                    initGettext(); //!< Sets up the locale so glibc's gettext translates; returns false if that isn't possible
+    void                    removeGeneratedFiles(); //!< Removes all generated files
+
+}
+
+#endif // LIBBORR_BENCH_INCLUDE_SYNTHETICDATA_HPP
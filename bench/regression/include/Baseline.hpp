@@ -0,0 +1,60 @@
+/**
+ * @file Baseline.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the checked-in baseline of the performance regression suite.
+ * @version 0.1
+ * @date 2023-02-21
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_BENCH_REGRESSION_INCLUDE_BASELINE_HPP
+#define LIBBORR_BENCH_REGRESSION_INCLUDE_BASELINE_HPP
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace borrperf {
+
+    namespace fs = std::filesystem;
+
+    using std::map;
+    using std::string;
+
+    constexpr double DEFAULT_TOLERANCE = 0.5; //!< The tolerance of scenarios which are added to the baseline
+
+    /**
+     * @brief The expected cost of a single scenario.
+     */
+    struct scenariobaseline_t {
+        double  ratio{0}; //!< The time per operation, relative to the time of one calibration operation
+        double  tolerance{DEFAULT_TOLERANCE}; //!< The allowed relative increase of the ratio; 0.5 allows a scenario to become 50% slower
+    };
+
+    /**
+     * @brief The contents of a baseline file.
+     *
+     * Times depend on the machine, so scenarios are stored relative to a calibration workload which is
+     * measured in the same run; a baseline recorded on one machine is meaningful on another.
+     *
+     * @code
+     * {
+     *     "calibration": "...",
+     *     "scenarios": {
+     *         "parse_borrfile": { "ratio": 1234.5, "tolerance": 0.5 }
+     *     }
+     * }
+     * @endcode
+     */
+    struct baseline_t {
+        string                          calibration{}; //!< A description of the calibration workload
+        map<string, scenariobaseline_t> scenarios{}; //!< The expected cost of every scenario
+    };
+
+    baseline_t  readBaseline(const fs::path& path); //!< Reads a baseline file
+    void        writeBaseline(const fs::path& path, const baseline_t& baseline); //!< Writes a baseline file
+
+}
+
+#endif // LIBBORR_BENCH_REGRESSION_INCLUDE_BASELINE_HPP
@@ -0,0 +1,221 @@
+/**
+ * @file Baseline.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains reading and writing the baseline of the performance regression suite.
+ * @version 0.1
+ * @date 2023-02-21
+ *
+ * Baselines are small JSON documents with a fixed structure, so a minimal reader for objects,
+ * strings and numbers is used instead of a JSON library; the suite has to build on a plain Linux box.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include <borr/extensions.hpp>
+
+#include "Baseline.hpp"
+
+namespace borrperf {
+
+    using std::string_view;
+
+    namespace {
+
+        /**
+         * @brief Reads the subset of JSON used by baseline files.
+         */
+        class json_reader {
+            public:
+                explicit json_reader(string_view contents): m_contents(contents) {}
+
+                /**
+                 * @brief Reads an object, calling onMember for every member; onMember must consume the member's value.
+                 */
+                void readObject(const std::function<void(const string& name)>& onMember) {
+                    expect('{');
+                    if (peek() == '}') {
+                        m_pos++;
+                        return;
+                    }
+
+                    while (true) {
+                        const auto name = readString();
+                        expect(':');
+                        onMember(name);
+
+                        if (peek() == ',') {
+                            m_pos++;
+                            continue;
+                        }
+
+                        expect('}');
+                        return;
+                    }
+                }
+
+                string readString() {
+                    expect('"');
+
+                    string value{};
+                    while (m_pos < m_contents.size() && m_contents[m_pos] != '"') {
+                        if (m_contents[m_pos] == '\\' && m_pos + 1 < m_contents.size()) { m_pos++; }
+                        value += m_contents[m_pos++];
+                    }
+
+                    expect('"');
+                    return value;
+                }
+
+                double readNumber() {
+                    skipWhitespace();
+
+                    const auto start = m_pos;
+                    while (m_pos < m_contents.size() && (std::isdigit(static_cast<unsigned char>(m_contents[m_pos])) || string_view("+-.eE").find(m_contents[m_pos]) != string_view::npos)) {
+                        m_pos++;
+                    }
+
+                    std::istringstream number(string(m_contents.substr(start, m_pos - start)));
+                    number.imbue(std::locale::classic());
+
+                    double value = 0;
+                    if (start == m_pos || !(number >> value)) { fail("number"); }
+
+                    return value;
+                }
+
+                /**
+                 * @brief Skips a value of any supported type.
+                 */
+                void skipValue() {
+                    switch (peek()) {
+                        case '{': readObject([this](const string&) { skipValue(); }); break;
+                        case '"': readString(); break;
+                        default: readNumber(); break;
+                    }
+                }
+
+                void expectEnd() {
+                    if (peek() != '\0') { fail("end of document"); }
+                }
+
+            private:
+                void skipWhitespace() {
+                    while (m_pos < m_contents.size() && std::isspace(static_cast<unsigned char>(m_contents[m_pos]))) { m_pos++; }
+                }
+
+                char peek() {
+                    skipWhitespace();
+                    return m_pos < m_contents.size() ? m_contents[m_pos] : '\0';
+                }
+
+                void expect(char c) {
+                    if (peek() != c) { fail(string("'") + c + "'"); }
+                    m_pos++;
+                }
+
+                [[noreturn]] void fail(const string& expected) const {
+                    throw std::runtime_error("Invalid baseline: expected " + expected + " at offset " + std::to_string(m_pos));
+                }
+
+            private:
+                string_view m_contents;
+                size_t      m_pos{0};
+        };
+
+    }
+
+    /**
+     * @brief Reads a baseline file.
+     *
+     * Unknown members are ignored, so baselines can carry additional information.
+     *
+     * @param path The path to the baseline.
+     *
+     * @return baseline_t The baseline.
+     *
+     * @throws fs::filesystem_error If the file couldn't be opened.
+     * @throws runtime_error If the file isn't a valid baseline.
+     */
+    baseline_t readBaseline(const fs::path& path) {
+        std::ifstream inStream(path);
+        if (!inStream.is_open()) {
+            throw fs::filesystem_error("Failed to open baseline!", path, std::error_code(ENOENT, std::generic_category()));
+        }
+
+        std::stringstream contents{};
+        contents << inStream.rdbuf();
+        const auto document = contents.str();
+
+        baseline_t baseline{};
+        json_reader reader(document);
+
+        reader.readObject([&](const string& name) {
+            if (name == "calibration") {
+                baseline.calibration = reader.readString();
+            } else if (name == "scenarios") {
+                reader.readObject([&](const string& scenarioName) {
+                    auto& scenario = baseline.scenarios[scenarioName];
+
+                    reader.readObject([&](const string& field) {
+                        if (field == "ratio") {
+                            scenario.ratio = reader.readNumber();
+                        } else if (field == "tolerance") {
+                            scenario.tolerance = reader.readNumber();
+                        } else {
+                            reader.skipValue();
+                        }
+                    });
+                });
+            } else {
+                reader.skipValue();
+            }
+        });
+        reader.expectEnd();
+
+        return baseline;
+    }
+
+    /**
+     * @brief Writes a baseline file, with one scenario per line so changes are easy to review.
+     *
+     * @param path The path to write to.
+     * @param baseline The baseline to write.
+     *
+     * @throws fs::filesystem_error If the file couldn't be written.
+     */
+    void writeBaseline(const fs::path& path, const baseline_t& baseline) {
+        std::ofstream outStream(path, std::ios::trunc);
+        if (!outStream.is_open()) {
+            throw fs::filesystem_error("Failed to write baseline!", path, std::error_code(EACCES, std::generic_category()));
+        }
+
+        outStream.imbue(std::locale::classic());
+        outStream << std::setprecision(6);
+
+        outStream << "{\n"
+                  << "    \"calibration\": \"" << borr::extensions::escapeJson(baseline.calibration) << "\",\n"
+                  << "    \"scenarios\": {\n";
+
+        size_t index = 0;
+        for (const auto& scenario : baseline.scenarios) {
+            outStream << "        \"" << borr::extensions::escapeJson(scenario.first) << "\": { "
+                      << "\"ratio\": " << scenario.second.ratio << ", "
+                      << "\"tolerance\": " << scenario.second.tolerance << " }"
+                      << (++index == baseline.scenarios.size() ? "\n" : ",\n");
+        }
+
+        outStream << "    }\n"
+                  << "}\n";
+    }
+
+}
@@ -0,0 +1,352 @@
+/**
+ * @file PerfRegression.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the performance regression suite, which compares a fixed set of scenarios against a checked-in baseline.
+ * @version 0.1
+ * @date 2023-02-21
+ *
+ * Every scenario is run with google-benchmark on the same generated catalog; the fastest repetition is compared,
+ * as it is the least affected by other load on the machine. Times are divided by the time of a calibration workload
+ * (building and searching a std::map of the same catalog), so the baseline is independent of the machine's speed.
+ *
+ * Usage: borrperfcheck --baseline=<file> [--update-baseline] [--repetitions=N] [google-benchmark flags]
+ *
+ * The exit code is 0 if no scenario regressed beyond its tolerance, 1 otherwise.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include <borr/language.hpp>
+
+#include "Baseline.hpp"
+#include "SyntheticData.hpp"
+
+namespace fs = std::filesystem;
+
+using std::map;
+using std::string;
+using std::vector;
+
+using borrbench::getCatalog;
+
+namespace {
+
+    constexpr size_t    CATALOG_SIZE = 1000; //!< The amount of translations in the catalog all scenarios use
+    constexpr int32_t   DEFAULT_REPETITIONS = 5; //!< How often every scenario is repeated
+    constexpr double    MIN_TIME = 0.1; //!< The minimum duration of every repetition, in seconds
+
+    constexpr const char* CALIBRATION = "calibration"; //!< The name of the calibration workload
+    constexpr const char* CALIBRATION_DESCRIPTION = "Building and searching a std::map<string, string> of the 1000-key synthetic catalog";
+
+    /**
+     * @brief Command-line options of the suite; google-benchmark's own flags are passed through.
+     */
+    struct options_t {
+        fs::path    baselinePath{}; //!< The checked-in baseline
+        bool        updateBaseline{false}; //!< Write the measured ratios to the baseline instead of comparing
+        int32_t     repetitions{DEFAULT_REPETITIONS}; //!< How often every scenario is repeated
+    };
+
+    /**
+     * @brief Collects the time per operation of every repetition, instead of printing a report.
+     */
+    class collecting_reporter: public benchmark::BenchmarkReporter {
+        public:
+            bool ReportContext(const Context&) override { return true; }
+
+            void ReportRuns(const vector<Run>& runs) override {
+                for (const auto& run : runs) {
+                    if (run.run_type != Run::RT_Iteration) { continue; }
+
+                    const auto& name = run.run_name.function_name;
+                    if (run.error_occurred) {
+                        m_errors[name] = run.error_message;
+                        continue;
+                    }
+
+                    m_times[name].push_back(run.GetAdjustedRealTime());
+                    std::fprintf(stderr, "borrperfcheck: %-16s %12.1f ns\n", name.c_str(), run.GetAdjustedRealTime());
+                }
+            }
+
+            map<string, double> getFastest() const {
+                map<string, double> fastest{};
+                for (const auto& times : m_times) { fastest[times.first] = *std::min_element(times.second.begin(), times.second.end()); }
+
+                return fastest;
+            }
+
+            const map<string, string>& getErrors() const { return m_errors; }
+
+        private:
+            map<string, vector<double>> m_times{};
+            map<string, string>         m_errors{};
+    };
+
+    const fs::path& getPackPath() {
+        static const auto packPath = fs::temp_directory_path() / ("borrperfcheck-" + std::to_string(::getpid()) + ".borrpack");
+        return packPath;
+    }
+
+    /**
+     * @brief Runs a lookup function over an access order, one translation per iteration.
+     */
+    template<typename Lookup>
+    void runLookups(benchmark::State& state, const vector<size_t>& order, Lookup&& lookup) {
+        size_t pos = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(lookup(order[pos]));
+            if (++pos == order.size()) { pos = 0; }
+        }
+    }
+
+    void calibration(benchmark::State& state) {
+        const auto& catalog = getCatalog(CATALOG_SIZE);
+
+        for (auto _ : state) {
+            map<string, string> table{};
+            for (const auto& entry : catalog.entries) { table.emplace(entry.section + ':' + entry.field, entry.value); }
+            for (const auto index : catalog.accessOrder) {
+                const auto& entry = catalog.entries[index];
+                benchmark::DoNotOptimize(table.find(entry.section + ':' + entry.field));
+            }
+        }
+    }
+
+    void parseBorrfile(benchmark::State& state) {
+        const auto& catalog = getCatalog(CATALOG_SIZE);
+
+        for (auto _ : state) {
+            auto lang = borr::language::fromString(catalog.borrfile);
+            benchmark::DoNotOptimize(lang);
+        }
+    }
+
+    void parseStream(benchmark::State& state) {
+        const auto& catalog = getCatalog(CATALOG_SIZE);
+
+        for (auto _ : state) {
+            std::istringstream inStream(catalog.borrfile);
+            auto lang = borr::language::fromStream(inStream);
+            benchmark::DoNotOptimize(lang);
+        }
+    }
+
+    void loadPack(benchmark::State& state) {
+        const fs::directory_entry packFile(getPackPath());
+
+        for (auto _ : state) {
+            auto lang = borr::language::fromPackFile(packFile);
+            benchmark::DoNotOptimize(lang);
+        }
+    }
+
+    void loadMo(benchmark::State& state) {
+        const fs::directory_entry moFile(getCatalog(CATALOG_SIZE).moFile);
+
+        for (auto _ : state) {
+            auto lang = borr::language::fromMoFile(moFile);
+            benchmark::DoNotOptimize(lang);
+        }
+    }
+
+    void lookup(benchmark::State& state) {
+        const auto& catalog = getCatalog(CATALOG_SIZE);
+        const auto& lang = borrbench::getLanguage(CATALOG_SIZE);
+
+        runLookups(state, catalog.accessOrder, [&](size_t index) {
+            const auto& entry = catalog.entries[index];
+            return lang.getString(entry.section, entry.field, false);
+        });
+    }
+
+    void lookupMo(benchmark::State& state) {
+        const auto& catalog = getCatalog(CATALOG_SIZE);
+        const auto& lang = borrbench::getMoLanguage(CATALOG_SIZE);
+
+        runLookups(state, catalog.accessOrder, [&](size_t index) {
+            const auto& entry = catalog.entries[index];
+            return lang.getString(entry.section, entry.field, false);
+        });
+    }
+
+    void render(benchmark::State& state) {
+        const auto& catalog = getCatalog(CATALOG_SIZE);
+        const auto& lang = borrbench::getLanguage(CATALOG_SIZE);
+
+        runLookups(state, catalog.renderOrder, [&](size_t index) {
+            const auto& entry = catalog.entries[index];
+            return lang.getString(entry.section, entry.field);
+        });
+    }
+
+    const std::pair<const char*, void(*)(benchmark::State&)> SCENARIOS[] = {
+        { CALIBRATION,      calibration },
+        { "parse_borrfile", parseBorrfile },
+        { "parse_stream",   parseStream },
+        { "load_pack",      loadPack },
+        { "load_mo",        loadMo },
+        { "lookup",         lookup },
+        { "lookup_mo",      lookupMo },
+        { "render",         render },
+    };
+
+    /**
+     * @brief Removes the suite's own flags from argv, so google-benchmark doesn't reject them.
+     */
+    bool parseOptions(int32_t& argc, char** argv, options_t& outOptions) {
+        int32_t kept = 1;
+
+        for (int32_t i = 1; i < argc; i++) {
+            const string arg = argv[i];
+
+            if (arg.rfind("--baseline=", 0) == 0) {
+                outOptions.baselinePath = arg.substr(std::strlen("--baseline="));
+            } else if (arg == "--update-baseline") {
+                outOptions.updateBaseline = true;
+            } else if (arg.rfind("--repetitions=", 0) == 0) {
+                outOptions.repetitions = std::max(1, std::atoi(arg.c_str() + std::strlen("--repetitions=")));
+            } else {
+                argv[kept++] = argv[i];
+            }
+        }
+        argc = kept;
+
+        return !outOptions.baselinePath.empty();
+    }
+
+    string formatChange(double change) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%+.1f%%", change * 100);
+
+        return buffer;
+    }
+
+    /**
+     * @brief Compares the measured ratios with the baseline and prints one line per scenario.
+     *
+     * @return true If no scenario regressed beyond its tolerance and every measured scenario has a baseline.
+     */
+    bool compare(const borrperf::baseline_t& baseline, const map<string, double>& ratios) {
+        bool passed = true;
+
+        std::printf("%-16s %12s %12s %9s %9s  %s\n", "scenario", "baseline", "measured", "change", "allowed", "result");
+        for (const auto& measured : ratios) {
+            const auto expected = baseline.scenarios.find(measured.first);
+            if (expected == baseline.scenarios.end() || expected->second.ratio <= 0) {
+                std::printf("%-16s %12s %12.4g %9s %9s  %s\n", measured.first.c_str(), "-", measured.second, "-", "-", "NO BASELINE (run with --update-baseline)");
+                passed = false;
+                continue;
+            }
+
+            const auto& scenario = expected->second;
+            const auto change = measured.second / scenario.ratio - 1;
+
+            string result = "ok";
+            if (change > scenario.tolerance) {
+                result = "REGRESSED";
+                passed = false;
+            } else if (change < -scenario.tolerance) {
+                result = "faster (consider --update-baseline)";
+            }
+
+            std::printf("%-16s %12.4g %12.4g %9s %9s  %s\n", measured.first.c_str(), scenario.ratio, measured.second,
+                        formatChange(change).c_str(), formatChange(scenario.tolerance).c_str(), result.c_str());
+        }
+
+        for (const auto& expected : baseline.scenarios) {
+            if (ratios.count(expected.first) == 0) { std::printf("%-16s %12.4g %12s %9s %9s  %s\n", expected.first.c_str(), expected.second.ratio, "-", "-", "-", "not run"); }
+        }
+
+        return passed;
+    }
+
+}
+
+int main(int32_t argc, char** argv) {
+    options_t options{};
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s --baseline=<file> [--update-baseline] [--repetitions=N] [google-benchmark flags]\n", argv[0]);
+        return 2;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 2; }
+
+    borrperf::baseline_t baseline{};
+    if (fs::exists(options.baselinePath) || !options.updateBaseline) {
+        try {
+            baseline = borrperf::readBaseline(options.baselinePath);
+        } catch (const std::exception& ex) {
+            std::fprintf(stderr, "borrperfcheck: %s\n", ex.what());
+            return 2;
+        }
+    }
+
+    // generate everything up front, so no scenario pays for it
+    borrbench::getLanguage(CATALOG_SIZE).toPackFile(getPackPath());
+    borrbench::getMoLanguage(CATALOG_SIZE);
+
+    for (const auto& scenario : SCENARIOS) {
+        benchmark::RegisterBenchmark(scenario.first, scenario.second)
+            ->Repetitions(options.repetitions)
+            ->MinTime(MIN_TIME)
+            ->Unit(benchmark::kNanosecond);
+    }
+
+    collecting_reporter reporter{};
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    std::error_code error{};
+    fs::remove(getPackPath(), error);
+    borrbench::removeGeneratedFiles();
+
+    for (const auto& failure : reporter.getErrors()) {
+        std::fprintf(stderr, "borrperfcheck: %s failed: %s\n", failure.first.c_str(), failure.second.c_str());
+    }
+    if (!reporter.getErrors().empty()) { return 1; }
+
+    auto fastest = reporter.getFastest();
+    const auto calibrationTime = fastest.find(CALIBRATION);
+    if (calibrationTime == fastest.end() || calibrationTime->second <= 0) {
+        std::fprintf(stderr, "borrperfcheck: the calibration workload must be run\n");
+        return 2;
+    }
+
+    const auto calibrationNs = calibrationTime->second;
+    fastest.erase(calibrationTime);
+
+    map<string, double> ratios{};
+    for (const auto& scenario : fastest) { ratios[scenario.first] = scenario.second / calibrationNs; }
+
+    if (options.updateBaseline) {
+        baseline.calibration = CALIBRATION_DESCRIPTION;
+        for (const auto& ratio : ratios) { baseline.scenarios[ratio.first].ratio = ratio.second; }
+
+        borrperf::writeBaseline(options.baselinePath, baseline);
+        std::printf("borrperfcheck: wrote %zu scenarios to %s\n", ratios.size(), options.baselinePath.c_str());
+
+        return 0;
+    }
+
+    std::printf("borrperfcheck: %s; calibration took %.0f ns; ratios are relative to it\n\n", options.baselinePath.c_str(), calibrationNs);
+    const auto passed = compare(baseline, ratios);
+    std::printf("\nborrperfcheck: %s\n", passed ? "no regressions" : "performance regressed; see above");
+
+    return passed ? 0 : 1;
+}
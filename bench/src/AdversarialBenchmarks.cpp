@@ -0,0 +1,101 @@
+/**
+ * @file AdversarialBenchmarks.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains benchmarks for loading and rendering pathological borrfiles.
+ * @version 0.1
+ * @date 2023-02-26
+ *
+ * Every input is generated at several sizes; the time per byte must stay flat as the size grows.
+ * A time per byte growing with the input means that parsing or expansion is no longer linear.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <borr/language.hpp>
+
+#include "PerfCounters.hpp"
+
+using std::string;
+using std::vector;
+
+namespace {
+
+    const string HEADER = "lang_id = \"en_GB\"\nlang_ver = \"1.0.0\"\nlang_desc = \"Adversarial\"\n\n[test]\n";
+
+    /**
+     * @brief The kinds of pathological input.
+     */
+    enum class adversarialkind_t: int64_t {
+        LongLine,               //!< A single translation of the given size
+        UnterminatedQuote,      //!< A translation without its closing quote
+        Hashes,                 //!< Lines consisting of '#'
+        VariableOpeners,        //!< "${" repeated without a single valid variable
+        NestedBraces,           //!< "${${${...}}}"
+        Variables,              //!< Valid (but unknown) variables back to back
+        References,             //!< References to a different translation back to back
+        Whitespace,             //!< A field name followed by a long run of spaces
+        Count
+    };
+
+    const vector<string> KIND_NAMES = {
+        "long_line", "unterminated_quote", "hashes", "variable_openers", "nested_braces", "variables", "references", "whitespace"
+    };
+
+    string repeat(const string& str, size_t count) {
+        string repeated{};
+        repeated.reserve(str.size() * count);
+        for (size_t i = 0; i < count; i++) { repeated += str; }
+
+        return repeated;
+    }
+
+    /**
+     * @brief Generates a pathological borrfile of roughly the given size.
+     */
+    string makeBorrfile(adversarialkind_t kind, size_t size) {
+        switch (kind) {
+            case adversarialkind_t::LongLine:           return HEADER + "long_line = \"" + string(size, 'a') + "\"\n";
+            case adversarialkind_t::UnterminatedQuote:  return HEADER + "unterminated = \"" + string(size, 'a') + "\n";
+            case adversarialkind_t::Hashes:             return HEADER + string(size / 2, '#') + "x\nhashes = \"" + string(size / 2, '#') + "\"\n";
+            case adversarialkind_t::VariableOpeners:    return HEADER + "openers = \"" + repeat("${", size / 2) + "\"\n";
+            case adversarialkind_t::NestedBraces:       return HEADER + "nested = \"" + repeat("${", size / 4) + repeat("}", size / 4) + "\"\n";
+            case adversarialkind_t::Variables:          return HEADER + "variables = \"" + repeat("${abcd}", size / 7) + "\"\n";
+            case adversarialkind_t::References:         return HEADER + "target = \"x\"\nreferences = \"" + repeat("${test:target}", size / 14) + "\"\n";
+            case adversarialkind_t::Whitespace:         return HEADER + "whitespace" + string(size, ' ') + "= \"x\"\n";
+            default:                                    return HEADER;
+        }
+    }
+
+    void adversarialArgs(benchmark::internal::Benchmark* bench) {
+        for (int64_t kind = 0; kind < static_cast<int64_t>(adversarialkind_t::Count); kind++) {
+            for (const int64_t size : { 64 * 1024, 256 * 1024, 1024 * 1024 }) { bench->Args({ kind, size }); }
+        }
+    }
+
+}
+
+/**
+ * @brief Parses a pathological borrfile and renders all of its translations.
+ */
+static void BM_BorrAdversarial(benchmark::State& state) {
+    const auto kind = static_cast<adversarialkind_t>(state.range(0));
+    const auto borrfile = makeBorrfile(kind, static_cast<size_t>(state.range(1)));
+    state.SetLabel(KIND_NAMES[static_cast<size_t>(kind)]);
+
+    const borrbench::perf_scope perf(state);
+    for (auto _ : state) {
+        const auto lang = borr::language::fromString(borrfile);
+        for (const auto& sectionName : lang.getSectionNames()) {
+            const auto section = lang.getSection(sectionName);
+            for (const auto& field : *section) { benchmark::DoNotOptimize(lang.getString(sectionName, field.first)); }
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(borrfile.size()));
+}
+BENCHMARK(BM_BorrAdversarial)->Apply(adversarialArgs)->Unit(benchmark::kMillisecond);
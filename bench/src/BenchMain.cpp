@@ -0,0 +1,42 @@
+/**
+ * @file BenchMain.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the entry point for the benchmark suite.
+ * @version 0.1
+ * @date 2023-02-16
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#include "PerfCounters.hpp"
+#include "SyntheticData.hpp"
+
+int main(int32_t argc, char** argv) {
+    // our own flag must be removed before google-benchmark rejects it as unrecognised
+    bool perfCounters = false;
+    for (int32_t i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], borrbench::PERF_COUNTERS_FLAG) != 0) { continue; }
+
+        perfCounters = true;
+        std::memmove(argv + i, argv + i + 1, static_cast<size_t>(argc - i) * sizeof(char*));
+        argc--;
+        i--;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+
+    // must happen before any benchmark threads are started; setenv() isn't thread-safe
+    borrbench::initGettext();
+    if (perfCounters) { borrbench::enablePerfCounters(); }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    borrbench::removeGeneratedFiles();
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file GettextComparison.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains benchmarks comparing libborr lookups and renders with glibc's gettext.
+ * @version 0.1
+ * @date 2023-02-16
+ *
+ * All benchmarks in this file use the same synthetic catalogs, the same access order and the same thread counts.
+ * "Lookup" retrieves a translation without expanding anything.
+ * "Render" retrieves a translation containing one variable, which references another translation:
+ * libborr expands ${meta:app_name}, gettext formats %s with the result of a second dgettext() call.
+ *
+ * Note that libborr always returns an owned std::string, whereas dgettext() returns a pointer into the mapped catalog.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libintl.h>
+
+#include <borr/language.hpp>
+
+#include "PerfCounters.hpp"
+#include "SyntheticData.hpp"
+
+using std::string;
+using std::vector;
+
+using borrbench::getCatalog;
+
+namespace {
+
+    constexpr int64_t MIN_CATALOG_SIZE = 1000;
+    constexpr int64_t MAX_CATALOG_SIZE = 100000;
+    constexpr int32_t MAX_THREADS = 8;
+
+    /**
+     * @brief Applies the catalog sizes and thread counts shared by all comparison benchmarks.
+     */
+    void comparisonArgs(benchmark::internal::Benchmark* bench) {
+        bench->RangeMultiplier(10)->Range(MIN_CATALOG_SIZE, MAX_CATALOG_SIZE)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+    }
+
+    /**
+     * @brief Runs a lookup function over an access order; every thread starts at a different offset.
+     */
+    template<typename Lookup>
+    void runLookups(benchmark::State& state, const vector<size_t>& order, Lookup&& lookup) {
+        auto pos = (order.size() / static_cast<size_t>(state.threads())) * static_cast<size_t>(state.thread_index());
+        const borrbench::perf_scope perf(state);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(lookup(order[pos]));
+            if (++pos == order.size()) { pos = 0; }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /**
+     * @brief Skips a gettext benchmark if glibc isn't translating with the generated catalogs.
+     */
+    bool checkGettext(benchmark::State& state, const borrbench::synthcatalog_t& catalog) {
+        const auto& entry = catalog.entries.front();
+        if (!borrbench::initGettext() || entry.gettextValue != dgettext(catalog.gettextDomain.c_str(), entry.gettextKey.c_str())) {
+            state.SkipWithError("glibc gettext doesn't translate; is a UTF-8 locale available?");
+            return false;
+        }
+
+        return true;
+    }
+
+}
+
+/**
+ * @brief Looks up translations in a parsed borrfile.
+ */
+static void BM_BorrLookup(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+    const auto& lang = borrbench::getLanguage(static_cast<size_t>(state.range(0)));
+
+    runLookups(state, catalog.accessOrder, [&](size_t index) {
+        const auto& entry = catalog.entries[index];
+        return lang.getString(entry.section, entry.field, false);
+    });
+}
+BENCHMARK(BM_BorrLookup)->Apply(comparisonArgs);
+
+/**
+ * @brief Looks up translations in a .mo file mapped by libborr.
+ */
+static void BM_BorrMoLookup(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+    const auto& lang = borrbench::getMoLanguage(static_cast<size_t>(state.range(0)));
+
+    runLookups(state, catalog.accessOrder, [&](size_t index) {
+        const auto& entry = catalog.entries[index];
+        return lang.getString(entry.section, entry.field, false);
+    });
+}
+BENCHMARK(BM_BorrMoLookup)->Apply(comparisonArgs);
+
+/**
+ * @brief Looks up translations with glibc's dgettext().
+ */
+static void BM_GettextLookup(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+    if (!checkGettext(state, catalog)) { return; }
+
+    const auto domain = catalog.gettextDomain.c_str();
+    runLookups(state, catalog.accessOrder, [&](size_t index) {
+        return dgettext(domain, catalog.entries[index].gettextKey.c_str());
+    });
+}
+BENCHMARK(BM_GettextLookup)->Apply(comparisonArgs);
+
+/**
+ * @brief Renders translations containing a reference from a parsed borrfile.
+ */
+static void BM_BorrRender(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+    const auto& lang = borrbench::getLanguage(static_cast<size_t>(state.range(0)));
+
+    runLookups(state, catalog.renderOrder, [&](size_t index) {
+        const auto& entry = catalog.entries[index];
+        return lang.getString(entry.section, entry.field);
+    });
+}
+BENCHMARK(BM_BorrRender)->Apply(comparisonArgs);
+
+/**
+ * @brief Renders the same translations with dgettext() and snprintf().
+ */
+static void BM_GettextRender(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+    if (!checkGettext(state, catalog)) { return; }
+
+    const auto domain = catalog.gettextDomain.c_str();
+    const auto appNameKey = string(borrbench::APP_NAME_SECTION) + '\x04' + borrbench::APP_NAME_FIELD;
+
+    runLookups(state, catalog.renderOrder, [&](size_t index) {
+        const auto format = dgettext(domain, catalog.entries[index].gettextKey.c_str());
+        const auto appName = dgettext(domain, appNameKey.c_str());
+
+        char buffer[512];
+        const auto length = std::snprintf(buffer, sizeof(buffer), format, appName);
+        return string(buffer, static_cast<size_t>(std::max(length, 0)));
+    });
+}
+BENCHMARK(BM_GettextRender)->Apply(comparisonArgs);
@@ -0,0 +1,80 @@
+/**
+ * @file ParseBenchmarks.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains benchmarks for loading languages.
+ * @version 0.1
+ * @date 2023-02-16
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include <borr/language.hpp>
+
+#include "PerfCounters.hpp"
+#include "SyntheticData.hpp"
+
+namespace fs = std::filesystem;
+
+using borrbench::getCatalog;
+
+/**
+ * @brief Parses a borrfile from memory.
+ */
+static void BM_BorrParse(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+
+    const borrbench::perf_scope perf(state);
+    for (auto _ : state) {
+        auto lang = borr::language::fromString(catalog.borrfile);
+        benchmark::DoNotOptimize(lang);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(catalog.borrfile.size()));
+}
+BENCHMARK(BM_BorrParse)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Parses the same borrfile from a stream, through a small reusable buffer.
+ */
+static void BM_BorrStreamParse(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+
+    // building the stream copies the borrfile, so it's excluded from the counters as well as the wall-clock time
+    borrbench::perf_scope perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        perf.pause();
+        std::istringstream inStream(catalog.borrfile);
+        perf.resume();
+        state.ResumeTiming();
+
+        auto lang = borr::language::fromStream(inStream);
+        benchmark::DoNotOptimize(lang);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(catalog.borrfile.size()));
+}
+BENCHMARK(BM_BorrStreamParse)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Maps the same catalog as a .mo file.
+ */
+static void BM_BorrMoLoad(benchmark::State& state) {
+    const auto& catalog = getCatalog(static_cast<size_t>(state.range(0)));
+    const fs::directory_entry moFile(catalog.moFile);
+
+    const borrbench::perf_scope perf(state);
+    for (auto _ : state) {
+        auto lang = borr::language::fromMoFile(moFile);
+        benchmark::DoNotOptimize(lang);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BorrMoLoad)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
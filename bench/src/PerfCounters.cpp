@@ -0,0 +1,204 @@
+/**
+ * @file PerfCounters.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the optional hardware performance counters.
+ * @version 0.1
+ * @date 2023-02-21
+ *
+ * The counters are read with perf_event_open(2). Each event is opened on its own rather than as a group,
+ * so a single unsupported event (LLC misses are often missing in virtual machines) doesn't disable the others;
+ * if the kernel multiplexes events, their values are scaled by the time they were actually counting.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if __has_include(<linux/perf_event.h>)
+#   define BORRBENCH_HAS_PERF_EVENTS 1
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#else
+#   define BORRBENCH_HAS_PERF_EVENTS 0
+#endif
+
+#include "PerfCounters.hpp"
+
+namespace borrbench {
+
+    namespace {
+
+        /**
+         * @brief A single event which is reported per iteration.
+         */
+        struct perfevent_t {
+            const char* name; //!< The name of the benchmark counter
+            uint32_t    type; //!< The perf_event_attr type
+            uint64_t    config; //!< The perf_event_attr config
+        };
+
+#if BORRBENCH_HAS_PERF_EVENTS
+        constexpr uint64_t cacheReadMisses(uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        const perfevent_t EVENTS[] = {
+            { "cycles",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { "instructions",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { "branch_misses",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { "l1d_misses",     PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_L1D) },
+            { "llc_misses",     PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_LL) },
+            { "page_faults",    PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+        };
+#else
+        const perfevent_t EVENTS[] = {
+            { "cycles", 0, 0 }, { "instructions", 0, 0 }, { "branch_misses", 0, 0 },
+            { "l1d_misses", 0, 0 }, { "llc_misses", 0, 0 }, { "page_faults", 0, 0 },
+        };
+#endif
+
+        constexpr size_t EVENT_COUNT = sizeof(EVENTS) / sizeof(EVENTS[0]);
+
+        bool g_enabled = false; //!< Set once by enablePerfCounters(), before any benchmark runs
+        bool g_available[EVENT_COUNT]{}; //!< Which events could be opened while probing
+
+        /**
+         * @brief Opens a disabled counter for the calling thread.
+         *
+         * @return int32_t The file descriptor, or -1 (with errno set) if the event isn't available.
+         */
+        int32_t openEvent(const perfevent_t& event) {
+#if BORRBENCH_HAS_PERF_EVENTS
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            return static_cast<int32_t>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+#else
+            (void)event;
+            errno = ENOSYS;
+            return -1;
+#endif
+        }
+
+        /**
+         * @brief Reads a counter, scaled up if the kernel multiplexed it.
+         */
+        bool readEvent(int32_t fd, double& outValue) {
+#if BORRBENCH_HAS_PERF_EVENTS
+            uint64_t values[3]{}; // value, time enabled, time running
+            if (::read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) { return false; }
+
+            outValue = static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+            return true;
+#else
+            (void)fd;
+            (void)outValue;
+            return false;
+#endif
+        }
+
+    }
+
+    /**
+     * @brief Enables performance counters, probing which events can be opened in this environment.
+     *
+     * Events which can't be opened are listed on stderr once, with the reason; the benchmarks run regardless.
+     * Must be called before any benchmark runs.
+     *
+     * @return true If at least one event is available.
+     */
+    bool enablePerfCounters() {
+        size_t availableCount = 0;
+
+        for (size_t i = 0; i < EVENT_COUNT; i++) {
+            const auto fd = openEvent(EVENTS[i]);
+            g_available[i] = fd >= 0;
+
+            if (fd < 0) {
+                std::fprintf(stderr, "borrbench: performance counter %s is unavailable: %s\n", EVENTS[i].name, std::strerror(errno));
+                continue;
+            }
+
+            availableCount++;
+#if BORRBENCH_HAS_PERF_EVENTS
+            ::close(fd);
+#endif
+        }
+
+        if (availableCount == 0) {
+            std::fprintf(stderr, "borrbench: no performance counters available (check /proc/sys/kernel/perf_event_paranoid); reporting wall-clock times only\n");
+        }
+
+        g_enabled = availableCount > 0;
+        return g_enabled;
+    }
+
+    bool perfCountersEnabled() { return g_enabled; }
+
+    /**
+     * @brief Opens and starts all available counters for the calling thread.
+     */
+    perf_scope::perf_scope(benchmark::State& state): m_state(state) {
+        if (!g_enabled) { return; }
+
+        m_fds.assign(EVENT_COUNT, -1);
+        for (size_t i = 0; i < EVENT_COUNT; i++) {
+            if (g_available[i]) { m_fds[i] = openEvent(EVENTS[i]); }
+        }
+
+        resume();
+    }
+
+    /**
+     * @brief Stops all counters and reports them per iteration.
+     *
+     * With multiple threads, google-benchmark sums the counters of all threads before dividing by the total iterations.
+     */
+    perf_scope::~perf_scope() {
+        pause();
+
+        for (size_t i = 0; i < m_fds.size(); i++) {
+            if (m_fds[i] < 0) { continue; }
+
+            if (double value = 0; readEvent(m_fds[i], value)) {
+                m_state.counters[EVENTS[i].name] = benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+            }
+#if BORRBENCH_HAS_PERF_EVENTS
+            ::close(m_fds[i]);
+#endif
+        }
+    }
+
+    /**
+     * @brief Stops all counters; events are no longer counted until resume() is called.
+     */
+    void perf_scope::pause() {
+#if BORRBENCH_HAS_PERF_EVENTS
+        for (const auto fd : m_fds) {
+            if (fd >= 0) { ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+        }
+#endif
+    }
+
+    /**
+     * @brief Starts all counters, or restarts them after pause(); counts accumulate.
+     */
+    void perf_scope::resume() {
+#if BORRBENCH_HAS_PERF_EVENTS
+        for (const auto fd : m_fds) {
+            if (fd >= 0) { ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+        }
+#endif
+    }
+
+}
@@ -0,0 +1,96 @@
+/**
+ * @file SearchBenchmarks.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains benchmarks searching the values of all translations.
+ * @version 0.1
+ * @date 2023-03-04
+ *
+ * "Scan" searches the way callers did before search_index existed: getSection() for every section, followed by
+ * a case-insensitive search of every value. "Index" answers the same query with a search_index;
+ * "Build" measures building the index, on one thread and with one worker per CPU.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <borr/search_index.hpp>
+
+#include "PerfCounters.hpp"
+#include "SyntheticData.hpp"
+
+using std::string;
+
+namespace {
+
+    const string QUERY = "could not be applied"; //!< Rare enough that the scan can't stop early
+
+    void searchArgs(benchmark::internal::Benchmark* bench) {
+        bench->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMicrosecond);
+    }
+
+}
+
+/**
+ * @brief Searches by copying every section and comparing every value.
+ */
+static void BM_BorrSearchScan(benchmark::State& state) {
+    const auto& lang = borrbench::getLanguage(static_cast<size_t>(state.range(0)));
+    const borrbench::perf_scope perf(state);
+
+    const auto equalsFolded = [](char lhs, char rhs) { return std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs)); };
+
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& sectionName : lang.getSectionNames()) {
+            const auto section = lang.getSection(sectionName);
+            for (const auto& field : *section) {
+                if (std::search(field.second.begin(), field.second.end(), QUERY.begin(), QUERY.end(), equalsFolded) != field.second.end()) { hits++; }
+            }
+        }
+
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BorrSearchScan)->Apply(searchArgs);
+
+/**
+ * @brief Searches with a prebuilt trigram index.
+ */
+static void BM_BorrSearchIndex(benchmark::State& state) {
+    const auto& lang = borrbench::getLanguage(static_cast<size_t>(state.range(0)));
+    const auto index = borr::search_index::fromLanguages({ &lang });
+    const borrbench::perf_scope perf(state);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.findSubstring(QUERY, 0).size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["posting_bytes"] = static_cast<double>(index.getPostingBytes());
+}
+BENCHMARK(BM_BorrSearchIndex)->Apply(searchArgs);
+
+/**
+ * @brief Builds the index; range(1) is the amount of threads (0: one per CPU).
+ */
+static void BM_BorrSearchBuild(benchmark::State& state) {
+    const auto& lang = borrbench::getLanguage(static_cast<size_t>(state.range(0)));
+    const borrbench::perf_scope perf(state);
+
+    borr::indexopts_t options{};
+    options.threads = static_cast<size_t>(state.range(1));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(borr::search_index::fromLanguages({ &lang }, options).getTrigramCount());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BorrSearchBuild)->ArgsProduct({ { 10000, 100000, 1000000 }, { 1, 0 } })->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,98 @@
+/**
+ * @file SectionBenchmarks.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains benchmarks rendering entire sections.
+ * @version 0.1
+ * @date 2023-02-27
+ *
+ * "Loop" renders a section the way callers did before getSectionExpanded() existed: getSection() followed by
+ * one getString() per field. "Expanded" renders the same section with a single getSectionExpanded() call,
+ * on one thread and with one worker per CPU.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include <borr/language.hpp>
+
+#include "PerfCounters.hpp"
+
+using std::string;
+using std::string_view;
+
+namespace {
+
+    constexpr size_t VARIABLE_FREQUENCY = 4; //!< One in this many translations contains variables
+
+    /**
+     * @brief Generates a language with a single section of the given size; every fourth translation references
+     * a shared translation twice, so memoisation across fields pays off.
+     */
+    borr::language generateSection(size_t fieldCount) {
+        std::ostringstream source{};
+        source << "lang_id = \"xx\"\nlang_ver = \"1.0.0\"\nlang_desc = \"Sections\"\n\n[big]\n";
+        source << "app_name = \"libborr\"\n";
+
+        for (size_t i = 0; i < fieldCount; i++) {
+            source << "field_" << i << " = \"";
+            if (i % VARIABLE_FREQUENCY == 0) {
+                source << "Welcome to ${big:app_name}; ${big:app_name} translation " << i;
+            } else {
+                source << "Plain translation number " << i;
+            }
+            source << "\"\n";
+        }
+
+        return borr::language::fromString(source.str());
+    }
+
+    void sectionArgs(benchmark::internal::Benchmark* bench) {
+        bench->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+    }
+
+}
+
+/**
+ * @brief Renders a section by copying it and looking up every field again.
+ */
+static void BM_BorrSectionLoop(benchmark::State& state) {
+    const auto lang = generateSection(static_cast<size_t>(state.range(0)));
+    const borrbench::perf_scope perf(state);
+
+    for (auto _ : state) {
+        size_t bytes = 0;
+        const auto section = lang.getSection("big");
+        for (const auto& field : *section) { bytes += lang.getString("big", field.first)->size(); }
+
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_BorrSectionLoop)->Apply(sectionArgs);
+
+/**
+ * @brief Renders a section in one pass with getSectionExpanded(); range(1) is the amount of threads (0: one per CPU).
+ */
+static void BM_BorrSectionExpanded(benchmark::State& state) {
+    const auto lang = generateSection(static_cast<size_t>(state.range(0)));
+    const borrbench::perf_scope perf(state);
+
+    borr::expandopts_t options{};
+    options.threads = static_cast<size_t>(state.range(1));
+
+    for (auto _ : state) {
+        size_t bytes = 0;
+        lang.getSectionExpanded("big", [&](const string&, string_view value) { bytes += value.size(); }, options);
+
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_BorrSectionExpanded)->ArgsProduct({ { 1000, 10000, 100000 }, { 1, 0 } })->Unit(benchmark::kMicrosecond)->UseRealTime();
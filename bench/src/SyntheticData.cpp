@@ -0,0 +1,231 @@
+/**
+ * @file SyntheticData.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the generation of the synthetic catalogs shared by all benchmarks.
+ * @version 0.1
+ * @date 2023-02-16
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <algorithm>
+#include <clocale>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <libintl.h>
+#include <unistd.h>
+
+#include <borr/mo_catalog.hpp>
+
+#include "SyntheticData.hpp"
+
+namespace borrbench {
+
+    using std::map;
+    using std::unique_ptr;
+
+    namespace {
+
+        constexpr size_t    KEYS_PER_SECTION = 100; //!< The amount of translations per section
+        constexpr size_t    VARIABLE_FREQUENCY = 4; //!< One in this many translations contains a variable
+        constexpr uint32_t  RANDOM_SEED = 0xb022; //!< Keeps all catalogs identical between runs
+        constexpr const char* GETTEXT_LANGUAGE = "xx"; //!< The language the .mo files are installed for
+
+        const vector<string> WORDS = {
+            "open", "close", "save", "file", "settings", "about", "window", "help", "search", "the",
+            "a", "of", "your", "changes", "could", "not", "be", "applied", "please", "try",
+            "again", "later", "welcome", "to", "account", "password", "user", "name", "is", "invalid"
+        };
+
+        std::mutex g_cacheMutex{};
+        map<size_t, unique_ptr<synthcatalog_t>> g_catalogs{};
+        map<size_t, unique_ptr<borr::language>> g_languages{};
+        map<size_t, unique_ptr<borr::language>> g_moLanguages{};
+
+        /**
+         * @brief Section names may not contain digits, so section indices are encoded as letters.
+         */
+        string toSectionName(size_t index) {
+            string name = "sect_";
+            do {
+                name += static_cast<char>('a' + index % 26);
+                index /= 26;
+            } while (index != 0);
+
+            return name;
+        }
+
+        /**
+         * @brief Gets the directory all generated files are written to.
+         */
+        const fs::path& getWorkDirectory() {
+            static const auto workDirectory = fs::temp_directory_path() / ("borrbench-" + std::to_string(::getpid()));
+            return workDirectory;
+        }
+
+        /**
+         * @brief Generates a catalog; all randomness is seeded from the catalog size, so catalogs are reproducible.
+         */
+        unique_ptr<synthcatalog_t> generateCatalog(size_t keyCount) {
+            auto catalog = std::make_unique<synthcatalog_t>();
+            std::mt19937 random(RANDOM_SEED ^ static_cast<uint32_t>(keyCount));
+            std::uniform_int_distribution<size_t> wordCount(3, 12);
+            std::uniform_int_distribution<size_t> word(0, WORDS.size() - 1);
+
+            catalog->entries.reserve(keyCount);
+            for (size_t i = 0; i < keyCount; i++) {
+                synthentry_t entry{};
+                entry.section = toSectionName(i / KEYS_PER_SECTION);
+                entry.field = "field_" + std::to_string(i);
+                entry.gettextKey = entry.section + borr::mo_catalog::CONTEXT_SEPARATOR + entry.field;
+                entry.hasVariable = i % VARIABLE_FREQUENCY == 0;
+
+                const auto words = wordCount(random);
+                const auto variablePos = entry.hasVariable ? random() % words : words;
+                for (size_t j = 0; j < words; j++) {
+                    const auto separator = j == 0 ? "" : " ";
+                    if (j == variablePos) {
+                        entry.value += separator + string("${") + APP_NAME_SECTION + ":" + APP_NAME_FIELD + "}";
+                        entry.gettextValue += separator + string("%s");
+                    } else {
+                        const auto& nextWord = WORDS[word(random)];
+                        entry.value += separator + nextWord;
+                        entry.gettextValue += separator + nextWord;
+                    }
+                }
+
+                catalog->entries.push_back(std::move(entry));
+            }
+
+            catalog->accessOrder.resize(keyCount);
+            std::iota(catalog->accessOrder.begin(), catalog->accessOrder.end(), 0);
+            std::shuffle(catalog->accessOrder.begin(), catalog->accessOrder.end(), random);
+
+            std::copy_if(
+                catalog->accessOrder.begin(), catalog->accessOrder.end(), std::back_inserter(catalog->renderOrder),
+                [&](size_t index) { return catalog->entries[index].hasVariable; }
+            );
+
+            std::stringstream borrfile{};
+            borrfile << R"(lang_id = "xx_XX")" << '\n'
+                     << R"(lang_ver = "1.0.0")" << '\n'
+                     << R"(lang_desc = "Synthetic benchmark catalog")" << "\n\n"
+                     << '[' << APP_NAME_SECTION << "]\n"
+                     << APP_NAME_FIELD << R"( = ")" << APP_NAME_VALUE << "\"\n";
+
+            string currentSection{};
+            vector<borr::moentry_t> moEntries{
+                { "", "", "Project-Id-Version: Synthetic benchmark catalog\nLanguage: xx_XX\nContent-Type: text/plain; charset=UTF-8\n" },
+                { APP_NAME_SECTION, APP_NAME_FIELD, APP_NAME_VALUE }
+            };
+            for (const auto& entry : catalog->entries) {
+                if (entry.section != currentSection) {
+                    currentSection = entry.section;
+                    borrfile << "\n[" << currentSection << "]\n";
+                }
+
+                borrfile << entry.field << R"( = ")" << entry.value << "\"\n";
+                moEntries.push_back({ entry.section, entry.field, entry.gettextValue });
+            }
+            catalog->borrfile = borrfile.str();
+
+            catalog->gettextDomain = "borrbench_" + std::to_string(keyCount);
+            const auto moDirectory = getWorkDirectory() / GETTEXT_LANGUAGE / "LC_MESSAGES";
+            fs::create_directories(moDirectory);
+            catalog->moFile = moDirectory / (catalog->gettextDomain + ".mo");
+            borr::mo_catalog::writeFile(catalog->moFile, std::move(moEntries));
+
+            bindtextdomain(catalog->gettextDomain.c_str(), getWorkDirectory().c_str());
+
+            return catalog;
+        }
+
+    }
+
+    /**
+     * @brief Gets the synthetic catalog of a given size, generating it on first use.
+     *
+     * @param keyCount The amount of translations in the catalog.
+     *
+     * @return const synthcatalog_t& The catalog.
+     */
+    const synthcatalog_t& getCatalog(size_t keyCount) {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+
+        auto& catalog = g_catalogs[keyCount];
+        if (!catalog) { catalog = generateCatalog(keyCount); }
+
+        return *catalog;
+    }
+
+    /**
+     * @brief Gets the parsed borrfile of the synthetic catalog of a given size.
+     */
+    const borr::language& getLanguage(size_t keyCount) {
+        const auto& catalog = getCatalog(keyCount);
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+
+        auto& lang = g_languages[keyCount];
+        if (!lang) {
+            lang = std::make_unique<borr::language>();
+            borr::language::fromString(catalog.borrfile, *lang);
+        }
+
+        return *lang;
+    }
+
+    /**
+     * @brief Gets the mapped .mo file of the synthetic catalog of a given size.
+     */
+    const borr::language& getMoLanguage(size_t keyCount) {
+        const auto& catalog = getCatalog(keyCount);
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+
+        auto& lang = g_moLanguages[keyCount];
+        if (!lang) {
+            lang = std::make_unique<borr::language>();
+            borr::language::fromMoFile(fs::directory_entry(catalog.moFile), *lang);
+        }
+
+        return *lang;
+    }
+
+    /**
+     * @brief Sets up the process locale so glibc's gettext uses the generated catalogs.
+     *
+     * gettext ignores LANGUAGE in the "C" locale, so a UTF-8 locale is selected first.
+     *
+     * @return true If a suitable locale could be selected.
+     * @return false Otherwise; gettext benchmarks should be skipped.
+     */
+    bool initGettext() {
+        static const bool initialised = [] {
+            for (const auto locale : { "C.UTF-8", "C.utf8", "en_US.UTF-8", "" }) {
+                if (const auto selected = std::setlocale(LC_ALL, locale); selected != nullptr && string(selected) != "C") {
+                    ::setenv("LANGUAGE", GETTEXT_LANGUAGE, 1);
+                    return true;
+                }
+            }
+
+            return false;
+        }();
+
+        return initialised;
+    }
+
+    /**
+     * @brief Removes all files generated by the benchmarks.
+     */
+    void removeGeneratedFiles() {
+        std::error_code error{};
+        fs::remove_all(getWorkDirectory(), error);
+    }
+
+}
@@ -0,0 +1,87 @@
+/**
+ * @file access_profile.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a sampled key access profile.
+ * @version 0.1
+ * @date 2023-02-12
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_ACCESS_PROFILE_HPP
+#define LIBBORR_INCLUDE_BORR_ACCESS_PROFILE_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace borr {
+
+    namespace fs = std::filesystem;
+
+    using std::map;
+    using std::pair;
+    using std::string;
+    using std::vector;
+
+    using keypair_t = pair<string, string>; //!< A section/field pair
+
+    /**
+     * @brief Records how often translations are accessed, so hot translations can be laid out together on the next load.
+     *
+     * Recording is sampled: only every n-th call to @c record() (per thread and profile) is counted, and each counted access
+     * is weighted by n. The remaining calls cost a thread-local increment; they never write to memory shared between threads.
+     *
+     * Profiles can be saved to and loaded from a simple text file:
+     *
+     * @code
+     * # borr access profile v1
+     * 1024	start_page	page_title
+     * 64	about_page	about_text
+     * @endcode
+     */
+    class access_profile {
+        public: // +++ Static Const +++
+            static constexpr uint32_t   DEFAULT_SAMPLE_RATE = 64; //!< By default, one in 64 accesses is recorded
+            static constexpr const char* FILE_HEADER = "# borr access profile v1"; //!< The first line of a profile file
+
+        public: // +++ Static +++
+            static access_profile fromFile(const fs::path& path, uint32_t sampleRate = DEFAULT_SAMPLE_RATE); //!< Loads a profile from disk
+
+        public: // +++ Constructor / Destructor +++
+            explicit access_profile(uint32_t sampleRate = DEFAULT_SAMPLE_RATE);
+            access_profile(const access_profile&); //!< Copy ctor
+            ~access_profile() = default; //!< Default dtor
+
+        public: // +++ Recording +++
+            void            record(const string& section, const string& field); //!< Records a (sampled) access
+            void            add(const string& section, const string& field, uint64_t count); //!< Adds a weighted access without sampling
+
+            void            save(const fs::path& path) const; //!< Saves the profile to disk
+
+        public: // +++ Getters +++
+            uint32_t        getSampleRate() const { return m_sampleRate; }
+            uint64_t        getCount(const string& section, const string& field) const; //!< Gets the recorded count of a translation
+            size_t          size() const; //!< Gets the amount of distinct translations in the profile
+
+            vector<keypair_t> getHottest(size_t maxKeys) const; //!< Gets the most frequently accessed translations, hottest first
+
+        private:
+            uint32_t                m_sampleRate; //!< One in m_sampleRate accesses is recorded
+            uint64_t                m_samplerId; //!< Identifies this profile's per-thread sample counters
+
+            mutable std::mutex      m_countsMutex{}; //!< Protects the counts
+            map<keypair_t, uint64_t> m_counts{}; //!< The weighted access counts
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_ACCESS_PROFILE_HPP
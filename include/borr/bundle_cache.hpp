@@ -0,0 +1,126 @@
+/**
+ * @file bundle_cache.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a cache for rendered section bundles served to clients.
+ * @version 0.1
+ * @date 2023-03-03
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_BUNDLE_CACHE_HPP
+#define LIBBORR_INCLUDE_BORR_BUNDLE_CACHE_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace borr {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    class language;
+
+    /**
+     * @brief The formats a bundle can be rendered in.
+     */
+    enum class bundleformat_t: uint8_t {
+        Json,   //!< {"lang_id": "...", "fingerprint": "...", "sections": {"section": {"field": "value"}}}
+        Binary, //!< A compact, length-prefixed encoding; see bundle_cache::visitBinary()
+    };
+
+    /**
+     * @brief A rendered bundle, ready to be sent as the body of a response.
+     */
+    struct bundle_t {
+        string      etag{}; //!< The strong entity tag of the body, including its quotes
+        string_view contentType{}; //!< The content type of the body
+        string      body{}; //!< The rendered sections
+        uint64_t    fingerprint{0}; //!< The fingerprint of the language the bundle was rendered from
+    };
+
+    /**
+     * @brief Renders selected sections of a language into a bundle for web and mobile clients, and caches the result.
+     *
+     * Bundles are cached per language ID, set of sections and format, and are only valid for the language's current fingerprint:
+     * once a language is reloaded with different contents, the next request renders the bundle again and replaces the stale one.
+     * Languages with equal contents share their bundles and entity tags, even across processes.
+     * All variables are expanded through language::getSectionExpanded(), so bundles containing dynamic expanders
+     * (such as the date) keep the value they had when they were rendered.
+     *
+     * A bundle_cache may be used by multiple threads at once. At most getCapacity() bundles are kept;
+     * the oldest bundle is dropped first.
+     *
+     * @code
+     * const auto bundle = cache.get(lang, { "start_page", "errors" });
+     * if (borr::bundle_cache::matchesIfNoneMatch(request.header("If-None-Match"), bundle->etag)) { return response(304); }
+     * return response(200, bundle->body, { { "ETag", bundle->etag }, { "Content-Type", bundle->contentType } });
+     * @endcode
+     */
+    class bundle_cache {
+        public: // +++ Types +++
+            using bundleptr_t = std::shared_ptr<const bundle_t>;
+            using bundlevisitor_t = std::function<void(string_view section, string_view field, string_view value)>;
+
+        public: // +++ Static Const +++
+            static constexpr size_t         DEFAULT_CAPACITY = 64; //!< By default, 64 bundles are kept
+            static constexpr string_view    JSON_CONTENT_TYPE = "application/json; charset=utf-8";
+            static constexpr string_view    BINARY_CONTENT_TYPE = "application/vnd.borr.bundle";
+            static constexpr string_view    BINARY_MAGIC = "BORRBNDL"; //!< The first bytes of every binary bundle
+            static constexpr uint8_t        BINARY_VERSION = 1; //!< The version of the binary layout
+
+        public: // +++ Constructor / Destructor +++
+            explicit bundle_cache(size_t capacity = DEFAULT_CAPACITY);
+            ~bundle_cache() = default; //!< Default dtor
+
+            bundle_cache(const bundle_cache&) = delete;
+            bundle_cache& operator=(const bundle_cache&) = delete;
+
+        public: // +++ Caching +++
+            bundleptr_t     get(const language& lang, const vector<string>& sections, bundleformat_t format = bundleformat_t::Json); //!< Gets a cached bundle, rendering it if required
+            void            clear(); //!< Removes all bundles
+
+        public: // +++ Getters +++
+            size_t          getCapacity() const { return m_capacity; }
+            size_t          size() const; //!< Gets the amount of cached bundles
+            uint64_t        getHits() const { return m_hits; }
+            uint64_t        getMisses() const { return m_misses; }
+
+        public: // +++ Rendering +++
+            static bundle_t render(const language& lang, const vector<string>& sections, bundleformat_t format = bundleformat_t::Json); //!< Renders a bundle without caching it
+            static string   getETag(string_view body); //!< Gets the entity tag of a rendered bundle
+            static bool     matchesIfNoneMatch(string_view ifNoneMatch, string_view etag); //!< Determines whether a client's cached copy is still valid
+            static bool     visitBinary(string_view body, uint64_t& outFingerprint, const bundlevisitor_t& visitor); //!< Decodes a binary bundle
+
+        private:
+            using bundlekey_t = std::tuple<string, vector<string>, bundleformat_t>;
+
+            static vector<string> normaliseSections(const language& lang, const vector<string>& sections); //!< Sorts the requested sections and removes duplicates
+
+            size_t                      m_capacity; //!< The maximum amount of cached bundles
+
+            mutable std::shared_mutex   m_bundlesMutex{}; //!< Protects the bundles and their order
+            std::map<bundlekey_t, bundleptr_t> m_bundles{}; //!< The cached bundles
+            std::deque<bundlekey_t>     m_order{}; //!< The keys of all cached bundles, oldest first
+
+            std::atomic<uint64_t>       m_hits{0}; //!< The amount of requests served from the cache
+            std::atomic<uint64_t>       m_misses{0}; //!< The amount of requests which rendered a bundle
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_BUNDLE_CACHE_HPP
@@ -0,0 +1,134 @@
+/**
+ * @file catalog.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a collection of languages with Accept-Language negotiation.
+ * @version 0.1
+ * @date 2023-02-23
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_CATALOG_HPP
+#define LIBBORR_INCLUDE_BORR_CATALOG_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "language.hpp"
+#include "search_index.hpp"
+
+namespace borr {
+
+    using std::map;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * @brief A single language range of an Accept-Language header.
+     */
+    struct langrange_t {
+        string  tag{}; //!< The canonical language tag, or "*"
+        double  quality{1.0}; //!< The quality value; 0 means "not acceptable"
+    };
+
+    /**
+     * @brief A collection of languages, e.g. all translations of an application, which negotiates the language of a request.
+     *
+     * Languages are identified by the canonical form of their lang_id: lower case, with hyphens as separators and
+     * without POSIX encoding or modifier suffixes, so "en_GB", "en-gb" and "en_GB.UTF-8" all name the same language.
+     *
+     * negotiate() implements the lookup scheme of RFC 4647 with quality values:
+     *  1. Ranges are tried in order of descending quality; ranges of equal quality keep their order in the header.
+     *  2. A range matches a language with the same tag, or - by removing subtags from its end - a more general language
+     *     ("de-ch-1996" matches "de-ch", then "de").
+     *  3. If no range matches, a language with the same primary subtag as a range is chosen ("en-us" matches "en-gb").
+     *  4. "*" matches the default language; if nothing matches, the default language (if any) is returned.
+     * Languages excluded with q=0 (including their more specific tags, so "en;q=0" excludes "en-gb") are never chosen.
+     *
+     * Results are cached per raw header in a bounded, sharded map, so repeated headers - the common case for a server -
+     * cost a hash and a shared lock instead of parsing.
+     *
+     * @remarks negotiate() and all getters may be called concurrently; adding or removing languages must not happen concurrently with them.
+     */
+    class catalog {
+        public: // +++ Static Const +++
+            static constexpr size_t DEFAULT_CACHE_CAPACITY = 4096; //!< The default maximum amount of cached headers
+            static constexpr size_t MAX_CACHED_HEADER_LENGTH = 512; //!< Longer headers are negotiated without caching
+            static constexpr size_t MAX_LANGUAGE_RANGES = 32; //!< Further ranges of a header are ignored
+
+        public: // +++ Static +++
+            static string   canonicaliseTag(string_view tag); //!< Gets the canonical form of a language tag
+            static vector<langrange_t> parseAcceptLanguage(string_view header); //!< Parses an Accept-Language header, sorted by quality
+
+        public: // +++ Constructor / Destructor +++
+            explicit catalog(size_t cacheCapacity = DEFAULT_CACHE_CAPACITY);
+            catalog(const catalog&) = delete;
+            catalog& operator=(const catalog&) = delete;
+            ~catalog() = default; //!< Default dtor
+
+        public: // +++ Languages +++
+            const language& addLanguage(language lang); //!< Adds a language, replacing a language with the same canonical lang_id
+            bool            removeLanguage(string_view langId); //!< Removes a language
+
+            void            setDefaultLanguage(string_view langId); //!< Sets the language used when negotiation finds no match
+            const language* getDefaultLanguage() const { return m_defaultLanguage; }
+
+            const language* getLanguage(string_view langId) const; //!< Gets a language by (any form of) its lang_id
+            vector<const language*> getLanguages() const; //!< Gets all languages, sorted by canonical lang_id
+            size_t          size() const { return m_languages.size(); }
+
+        public: // +++ Negotiation +++
+            const language* negotiate(string_view acceptLanguage) const; //!< Chooses the best language for an Accept-Language header
+            size_t          getCachedHeaderCount() const; //!< Gets the amount of headers in the negotiation cache
+
+        public: // +++ Search +++
+            std::shared_ptr<const search_index> getSearchIndex(const indexopts_t& options = {}) const; //!< Gets the full-text index of all languages, building it on first use
+
+        private: // +++ Internal +++
+            /**
+             * @brief One shard of the negotiation cache; headers are evicted in insertion order.
+             */
+            struct cacheshard_t {
+                mutable std::shared_mutex                           mutex{};
+                std::unordered_multimap<uint64_t, std::pair<string, const language*>> entries{}; //!< Header hash to header and result
+                std::deque<uint64_t>                                order{}; //!< Hashes in insertion order
+            };
+
+            static constexpr size_t CACHE_SHARDS = 16; //!< The amount of independently locked shards
+
+            const language* negotiateUncached(string_view acceptLanguage) const;
+            void            clearCache();
+            void            clearSearchIndex();
+
+        private:
+            map<string, std::unique_ptr<language>, std::less<>> m_languages{}; //!< The languages by canonical lang_id
+            const language*                                     m_defaultLanguage{nullptr}; //!< The fallback language
+
+            size_t                                              m_shardCapacity; //!< The maximum amount of headers per shard
+            mutable std::array<cacheshard_t, CACHE_SHARDS>      m_cache{}; //!< The negotiation cache
+
+            mutable std::mutex                                  m_searchIndexMutex{}; //!< Serialises building the search index
+            mutable std::shared_ptr<const search_index>         m_searchIndex{}; //!< The full-text index of all languages; nullptr until first used
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_CATALOG_HPP
@@ -0,0 +1,116 @@
+/**
+ * @file columnar_catalog.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a column-oriented view over the translations of many languages.
+ * @version 0.1
+ * @date 2023-02-24
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_COLUMNAR_CATALOG_HPP
+#define LIBBORR_INCLUDE_BORR_COLUMNAR_CATALOG_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace borr {
+
+    using std::optional;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    class catalog;
+    class language;
+
+    using keyid_t = uint32_t;
+    using keyname_t = std::pair<string, string>; //!< A (section, field) pair
+
+    /**
+     * @brief A column-oriented copy of the raw translations of many languages.
+     *
+     * All languages share one key dictionary which maps every (section, field) pair to a dense key ID;
+     * each language (locale) is a column holding one cell per key ID. Values are stored unexpanded in one string pool per column.
+     *
+     * This turns questions across languages - "what is key X in every language?", "which languages lack key X?" -
+     * into a single key lookup followed by a scan over the columns, and fallback chains into a few array accesses.
+     *
+     * @remarks This is a snapshot: changes to the languages after they were added aren't reflected.
+     *          Reading may happen concurrently; adding languages must not happen concurrently with reads.
+     */
+    class columnar_catalog {
+        public: // +++ Static Const +++
+            static constexpr keyid_t INVALID_KEY = UINT32_MAX; //!< Returned for unknown keys
+            static constexpr size_t  INVALID_LOCALE = SIZE_MAX; //!< Returned for unknown locales
+
+        public: // +++ Constructor / Destructor +++
+            columnar_catalog() = default;
+            explicit columnar_catalog(const catalog& languages); //!< Adds all languages of a catalog
+            ~columnar_catalog() = default; //!< Default dtor
+
+        public: // +++ Building +++
+            size_t          addLanguage(const language& lang); //!< Adds (or replaces) the column of a language
+
+        public: // +++ Keys +++
+            keyid_t         getKeyId(string_view section, string_view field) const; //!< Gets the ID of a key, or INVALID_KEY
+            const keyname_t& getKeyName(keyid_t keyId) const { return m_keys.at(keyId); }
+            size_t          getKeyCount() const { return m_keys.size(); }
+
+        public: // +++ Locales +++
+            size_t          getLocaleIndex(string_view langId) const; //!< Gets the column of a language (by any form of its lang_id), or INVALID_LOCALE
+            const string&   getLocaleId(size_t locale) const { return m_columns.at(locale).langId; }
+            size_t          getLocaleCount() const { return m_columns.size(); }
+
+        public: // +++ Values +++
+            optional<string_view>   getValue(keyid_t keyId, size_t locale) const; //!< Gets the raw value of a key in a single locale
+            optional<string_view>   getValue(keyid_t keyId, const vector<size_t>& fallbackChain) const; //!< Gets the value from the first locale of a chain which has it
+
+            vector<optional<string_view>> getAllValues(keyid_t keyId) const; //!< Gets the value of a key in every locale, by column
+            vector<size_t>  getMissingLocales(keyid_t keyId) const; //!< Gets the columns which lack a key
+            vector<keyid_t> getMissingKeys(size_t locale) const; //!< Gets the keys a column lacks
+
+        private: // +++ Internal +++
+            /**
+             * @brief A single cell of a column.
+             */
+            struct cell_t {
+                uint32_t    offset{0}; //!< The offset of the value in the column's pool
+                uint32_t    length{MISSING}; //!< The length of the value, or MISSING
+            };
+
+            /**
+             * @brief The translations of a single locale, indexed by key ID.
+             */
+            struct column_t {
+                string          langId{}; //!< The lang_id of the locale
+                string          canonicalId{}; //!< The canonical lang_id; see catalog::canonicaliseTag()
+                string          pool{}; //!< All values of the column, back to back
+                vector<cell_t>  cells{}; //!< One cell per key ID
+            };
+
+            static constexpr uint32_t MISSING = UINT32_MAX; //!< The length of a missing cell
+
+            static uint64_t hashKey(string_view section, string_view field);
+
+            keyid_t         internKey(string_view section, string_view field); //!< Gets the ID of a key, adding it if necessary
+            const cell_t*   getCell(keyid_t keyId, size_t locale) const;
+
+        private:
+            vector<keyname_t>                               m_keys{}; //!< The key names by key ID
+            std::unordered_multimap<uint64_t, keyid_t>      m_keyIds{}; //!< Key hashes to key IDs
+            vector<column_t>                                m_columns{}; //!< One column per locale
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_COLUMNAR_CATALOG_HPP
@@ -0,0 +1,130 @@
+/**
+ * @file compiled_template.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a pre-tokenised translation template.
+ * @version 0.1
+ * @date 2023-02-10
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_COMPILED_TEMPLATE_HPP
+#define LIBBORR_INCLUDE_BORR_COMPILED_TEMPLATE_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/expander_registry.hpp"
+
+namespace borr {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    struct entry_t;
+
+    /**
+     * @brief A translation which has been split into literal text and variables.
+     *
+     * Templates are compiled once when a language is loaded, so rendering a translation never has to search for variables again.
+     * Binding a template resolves every variable to the kind of expansion it requires; expanders are bound to their registry slot.
+     *
+     * A template does not own its source; offsets refer to the translation it was compiled from.
+     */
+    class compiled_template {
+        public: // +++ Types +++
+            /**
+             * @brief The different kinds of segments a template consists of.
+             */
+            enum class segkind_t: uint8_t {
+                Literal,    //!< Literal text which is copied as-is
+                Expander,   //!< A variable bound to a slot in the expander registry
+                Reference,  //!< A reference to a different translation (${section:field})
+                Dynamic,    //!< A variable which must be resolved by name on every render
+                Empty       //!< A variable which can never be resolved and expands to an empty string
+            };
+
+            /**
+             * @brief A single segment of a template.
+             */
+            struct segment_t {
+                segkind_t   kind{segkind_t::Literal}; //!< The kind of segment
+                size_t      offset{0}; //!< The offset of the text (or variable name) in the source
+                size_t      length{0}; //!< The length of the text (or variable name)
+                size_t      separator{string::npos}; //!< The position of the ':' in a reference, relative to offset
+                size_t      slot{expander_registry::NPOS}; //!< The registry slot of an expander
+                const entry_t* target{nullptr}; //!< The target of a resolved reference
+            };
+
+        public: // +++ Static +++
+            static compiled_template compile(const string& source); //!< Splits a translation into segments
+            static bool     isVariableName(string_view name); //!< Determines whether a string is a valid variable name
+            static size_t   findVariable(string_view source, size_t startPos, size_t& outNameLength); //!< Finds the next variable in a string
+
+        public: // +++ Constructor / Destructor +++
+            compiled_template() = default;
+            ~compiled_template() = default; //!< Default dtor
+
+        public: // +++ Binding +++
+            void            bind(const string& source, const expander_registry& registry); //!< Resolves all variables against the registry
+
+            /**
+             * @brief Resolves all references in this template to their target entries.
+             *
+             * References whose target doesn't exist are turned into empty segments.
+             *
+             * @param source The translation this template was compiled from.
+             * @param resolver A callable taking the section and field name (as strings) and returning a const entry_t* or nullptr.
+             *
+             * @return size_t The amount of references which were resolved to an entry.
+             */
+            template<typename Resolver>
+            size_t          resolveReferences(const string& source, Resolver&& resolver) {
+                size_t resolved = 0;
+
+                for (auto& segment : m_segments) {
+                    if (segment.kind != segkind_t::Reference) { continue; }
+
+                    segment.target = resolver(
+                        source.substr(segment.offset, segment.separator),
+                        source.substr(segment.offset + segment.separator + 1, segment.length - segment.separator - 1)
+                    );
+
+                    if (segment.target == nullptr) {
+                        segment.kind = segkind_t::Empty;
+                    } else {
+                        resolved++;
+                    }
+                }
+
+                return resolved;
+            }
+
+        public: // +++ Getters +++
+            bool            isCompiled() const { return m_compiled; }
+            bool            isBound() const { return m_bound; }
+            bool            hasVariables() const { return m_hasVariables; }
+
+            const vector<segment_t>& getSegments() const { return m_segments; }
+
+        private:
+            vector<segment_t>   m_segments{}; //!< The segments of the template
+
+            bool                m_compiled{false}; //!< Whether or not the template was compiled
+            bool                m_bound{false}; //!< Whether or not the template was bound
+            bool                m_hasVariables{false}; //!< Whether or not the template contains at least one variable
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_COMPILED_TEMPLATE_HPP
@@ -0,0 +1,84 @@
+/**
+ * @file consistency.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the consistency checks between a reference language and its translations.
+ * @version 0.1
+ * @date 2023-02-25
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_CONSISTENCY_HPP
+#define LIBBORR_INCLUDE_BORR_CONSISTENCY_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace borr {
+
+    class language;
+
+}
+
+/**
+ * @brief Consistency checks between a reference language (usually the source language of an application) and its translations.
+ *
+ * Both languages are walked once, in their sorted order, and compared key by key; no translation is copied or looked up.
+ * The variables of each translation are taken from its compiled template.
+ */
+namespace borr::consistency {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    using keyname_t = std::pair<string, string>; //!< A (section, field) pair
+
+    /**
+     * @brief A translation whose variables differ from the reference.
+     */
+    struct varmismatch_t {
+        keyname_t       key{}; //!< The translation
+        vector<string>  missingVariables{}; //!< Variables (and references) of the reference which the translation lacks
+        vector<string>  extraVariables{}; //!< Variables (and references) which only the translation has
+    };
+
+    /**
+     * @brief A multiline translation whose line count differs from the reference.
+     */
+    struct linemismatch_t {
+        keyname_t   key{}; //!< The translation
+        size_t      referenceLines{0}; //!< The amount of lines in the reference
+        size_t      lines{0}; //!< The amount of lines in the translation
+    };
+
+    /**
+     * @brief The result of checking a single language against the reference.
+     */
+    struct langreport_t {
+        string                  langId{}; //!< The lang_id of the checked language
+        vector<keyname_t>       missingKeys{}; //!< Translations only the reference has
+        vector<keyname_t>       extraKeys{}; //!< Translations the reference doesn't have
+        vector<varmismatch_t>   variableMismatches{}; //!< Translations whose variables differ
+        vector<linemismatch_t>  lineCountMismatches{}; //!< Translations whose line count differs
+
+        bool    isConsistent() const { return missingKeys.empty() && extraKeys.empty() && variableMismatches.empty() && lineCountMismatches.empty(); }
+        size_t  getIssueCount() const { return missingKeys.size() + extraKeys.size() + variableMismatches.size() + lineCountMismatches.size(); }
+    };
+
+    langreport_t    checkLanguage(const language& reference, const language& lang); //!< Checks a single language against the reference
+    vector<langreport_t> check(const language& reference, const vector<const language*>& languages, size_t jobs = 0); //!< Checks languages against the reference in parallel
+
+    string  toJson(string_view referenceId, const vector<langreport_t>& reports); //!< Serialises reports as JSON
+    void    writeJson(std::ostream& outStream, string_view referenceId, const vector<langreport_t>& reports); //!< Writes reports as JSON to a stream
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_CONSISTENCY_HPP
@@ -0,0 +1,98 @@
+/**
+ * @file expander_registry.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the registry holding all variable expanders known to libborr.
+ * @version 0.1
+ * @date 2023-02-10
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_EXPANDER_REGISTRY_HPP
+#define LIBBORR_INCLUDE_BORR_EXPANDER_REGISTRY_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace borr {
+
+    using std::function;
+    using std::map;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    // callback definitions
+    using varexpansioncallback_t = function<string(const string&)>;
+    using expanderfn_t = string(*)(const string&);
+
+    /**
+     * @brief A registry of variable expanders which can be frozen into a minimal perfect hash.
+     *
+     * Every name registered with the registry is assigned a stable slot.
+     * Slots never move, so compiled templates may bind a variable to its slot once and invoke the expander directly on every render.
+     *
+     * Each slot holds an optional default expander (a plain function pointer provided by the library)
+     * and an optional custom expander (provided by the application). Custom expanders take precedence.
+     *
+     * Once @c freeze() has been called, no new names can be registered. The registry then builds a minimal perfect hash
+     * (hash-and-displace) over all names, so that the remaining by-name lookups cost one hash and one string comparison.
+     * Custom expanders for names which already exist may still be replaced or removed after freezing.
+     */
+    class expander_registry {
+        public: // +++ Static Const +++
+            static constexpr size_t NPOS = SIZE_MAX; //!< Returned by @c find() if a name isn't registered
+
+        public: // +++ Constructor / Destructor +++
+            expander_registry() = default;
+            ~expander_registry() = default; //!< Default dtor
+
+        public: // +++ Registration +++
+            bool        addDefault(const string& varName, expanderfn_t expander); //!< Registers a default expander
+            bool        addCallback(const string& varName, const varexpansioncallback_t& cb); //!< Registers a custom expander
+            void        removeCallback(const string& varName); //!< Removes a custom expander
+
+            void        freeze(); //!< Freezes the registry and builds the perfect hash
+
+        public: // +++ Lookup +++
+            bool        isFrozen() const { return m_frozen; }
+            size_t      size() const { return m_entries.size(); }
+
+            size_t      find(string_view varName) const; //!< Finds the slot of a given variable name
+            bool        invoke(size_t slot, const string& varName, string& outValue) const; //!< Invokes the expander in a given slot
+
+        private: // +++ Internal +++
+            struct entry_t {
+                string                  name{};
+                expanderfn_t            defaultExpander{nullptr};
+                varexpansioncallback_t  customExpander{};
+            };
+
+            static uint64_t hashName(string_view varName, uint64_t seed);
+
+            bool        buildPerfectHash(uint64_t seed); //!< Attempts to build the perfect hash with a given seed
+
+            size_t      getOrCreateSlot(const string& varName); //!< Gets the slot for a name, or creates one if possible
+
+        private:
+            bool                        m_frozen{false}; //!< Whether or not the registry is frozen
+
+            vector<entry_t>             m_entries{}; //!< All registered expanders, indexed by slot
+            map<string, size_t, std::less<>> m_nameIndex{}; //!< Name to slot lookup used before freezing
+
+            uint64_t                    m_hashSeed{0}; //!< The seed of the perfect hash
+            vector<uint32_t>            m_displacements{}; //!< The displacement of each bucket
+            vector<size_t>              m_hashTable{}; //!< Maps perfect hash positions to slots
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_EXPANDER_REGISTRY_HPP
@@ -11,14 +11,20 @@
 #ifndef LIBBORR_INCLUDE_BORR_EXTENSIONS_HPP
 #define LIBBORR_INCLUDE_BORR_EXTENSIONS_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace borr::extensions {
 
     using std::function;
     using std::string;
+    using std::string_view;
     using std::vector;
 
 
@@ -115,6 +121,107 @@ namespace borr::extensions {
      */
     inline string trim(const string& nonTrimmed, const string& trimChar = " \t\r") { return trimStart(trimEnd(nonTrimmed, trimChar), trimChar); }
 
+    /**
+     * @brief Computes the 64-bit FNV-1a hash of a given string.
+     *
+     * @param str The string to hash.
+     * @param seed An optional seed which is mixed into the offset basis. (default: 0)
+     *
+     * @return The hash of the string.
+     */
+    inline uint64_t fnv1a(string_view str, uint64_t seed = 0) {
+        uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+
+        for (const auto c : str) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ULL;
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief Escapes a string for use within a JSON string literal.
+     *
+     * @param str The string to escape.
+     *
+     * @return The escaped string, without surrounding quotes.
+     */
+    inline string escapeJson(string_view str) {
+        constexpr const char* HEX_DIGITS = "0123456789abcdef";
+
+        string escaped{};
+        escaped.reserve(str.size());
+
+        for (const auto c : str) {
+            switch (c) {
+                case '"':  escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\r': escaped += "\\r"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<uint8_t>(c) < 0x20) {
+                        escaped += "\\u00";
+                        escaped += HEX_DIGITS[static_cast<uint8_t>(c) >> 4];
+                        escaped += HEX_DIGITS[static_cast<uint8_t>(c) & 0xf];
+                    } else {
+                        escaped += c;
+                    }
+                    break;
+            }
+        }
+
+        return escaped;
+    }
+
+    /**
+     * @brief Gets a new, process-wide unique ID for a sampler; see shouldSample().
+     *
+     * @return uint64_t The ID; never 0.
+     */
+    inline uint64_t nextSamplerId() {
+        static std::atomic<uint64_t> lastId{0};
+        return lastId.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /**
+     * @brief Determines whether the current call of a sampled operation should be sampled.
+     *
+     * Calls are counted per thread and per sampler, so one in sampleRate calls on each thread returns true,
+     * regardless of other samplers, and counting never writes to memory shared between threads.
+     * Each thread keeps the counters of its SAMPLER_SLOTS most recently started samplers; a thread alternating between
+     * more samplers than that restarts their counts, which only shifts when they sample next.
+     *
+     * @param samplerId The ID of the sampler, from nextSamplerId().
+     * @param sampleRate One in sampleRate calls is sampled; must be at least 1.
+     *
+     * @return true If this call should be sampled.
+     * @return false Otherwise.
+     */
+    inline bool shouldSample(uint64_t samplerId, uint32_t sampleRate) {
+        constexpr size_t SAMPLER_SLOTS = 8;
+
+        struct samplerslot_t {
+            uint64_t    samplerId{0};
+            uint32_t    count{0};
+        };
+
+        thread_local std::array<samplerslot_t, SAMPLER_SLOTS> slots{};
+        thread_local size_t nextSlot = 0;
+
+        auto slot = std::find_if(slots.begin(), slots.end(), [samplerId](const samplerslot_t& candidate) { return candidate.samplerId == samplerId; });
+        if (slot == slots.end()) {
+            slot = slots.begin() + (nextSlot++ % SAMPLER_SLOTS);
+            *slot = { samplerId, 0 };
+        }
+
+        if (++slot->count < sampleRate) { return false; }
+
+        slot->count = 0;
+        return true;
+    }
+
 }
 
 #endif // LIBBORR_INCLUDE_BORR_EXTENSIONS_HPP
\ No newline at end of file
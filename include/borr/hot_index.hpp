@@ -0,0 +1,93 @@
+/**
+ * @file hot_index.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a compact index for frequently accessed translations.
+ * @version 0.1
+ * @date 2023-02-12
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_HOT_INDEX_HPP
+#define LIBBORR_INCLUDE_BORR_HOT_INDEX_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace borr {
+
+    using std::function;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    struct entry_t;
+
+    /**
+     * @brief A compact, open-addressing index over the hottest translations of a language.
+     *
+     * All keys and values are copied into a single contiguous pool in hotness order, so the hottest translations
+     * share a handful of cache lines and pages instead of being scattered across map nodes.
+     * A lookup costs one hash, a short linear probe over a small table and one comparison within the pool.
+     */
+    class hot_index {
+        public: // +++ Types +++
+            using resolver_t = function<const entry_t*(const string&, const string&)>;
+
+            /**
+             * @brief The result of a successful lookup.
+             */
+            struct hit_t {
+                string_view     value{}; //!< The raw value, stored in the pool
+                const entry_t*  entry{nullptr}; //!< The entry the value was copied from
+            };
+
+        public: // +++ Static Const +++
+            static constexpr size_t DEFAULT_MAX_POOL_BYTES = 256 * 1024; //!< The default maximum size of the pool
+
+        public: // +++ Constructor / Destructor +++
+            hot_index() = default;
+            ~hot_index() = default; //!< Default dtor
+
+        public: // +++ Building +++
+            size_t          build(const vector<std::pair<string, string>>& hotKeys, const resolver_t& resolver, size_t maxPoolBytes = DEFAULT_MAX_POOL_BYTES); //!< Builds the index
+            void            rebind(const resolver_t& resolver); //!< Resolves all entries again, e.g. after a copy
+            void            clear(); //!< Clears the index
+
+        public: // +++ Lookup +++
+            bool            empty() const { return m_records.empty(); }
+            size_t          size() const { return m_records.size(); }
+            size_t          getPoolSize() const { return m_pool.size(); }
+            size_t          getResidentBytes() const { return m_pool.capacity() + m_records.capacity() * sizeof(record_t) + m_slots.capacity() * sizeof(uint32_t); }
+
+            bool            find(const string& section, const string& field, hit_t& outHit) const; //!< Looks up a translation
+            bool            containsSection(string_view section) const; //!< Determines whether any translation of a section is in the index
+
+        private: // +++ Internal +++
+            struct record_t {
+                uint64_t        hash; //!< The hash of the section and field
+                uint32_t        keyOffset; //!< The offset of the section name in the pool; the field follows directly
+                uint32_t        sectionLength; //!< The length of the section name
+                uint32_t        fieldLength; //!< The length of the field name
+                uint32_t        valueLength; //!< The length of the value, which follows the field name
+                const entry_t*  entry; //!< The entry the value was copied from
+            };
+
+            static uint64_t hashKey(string_view section, string_view field);
+
+        private:
+            string              m_pool{}; //!< Keys and values in hotness order
+            vector<record_t>    m_records{}; //!< The records in hotness order
+            vector<uint32_t>    m_slots{}; //!< Open-addressing table of record indices + 1; 0 marks an empty slot
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_HOT_INDEX_HPP
@@ -0,0 +1,121 @@
+/**
+ * @file key_index.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of stable key IDs and the handles built on top of them.
+ * @version 0.1
+ * @date 2023-02-28
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_KEY_INDEX_HPP
+#define LIBBORR_INCLUDE_BORR_KEY_INDEX_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace borr {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    struct entry_t;
+
+    using stablekey_t = uint64_t;
+
+    /**
+     * @brief An index from stable key IDs to the translations of a language.
+     *
+     * The stable key of a translation only depends on its section and field name: it is the 64-bit FNV-1a hash
+     * of "section:field". It is therefore identical for every version of a borrfile or language pack, in every
+     * process and on every machine, and can be stored or compiled into an application.
+     *
+     * Keys whose hashes collide are marked as ambiguous and can only be looked up by name.
+     */
+    class key_index {
+        public: // +++ Types +++
+            /**
+             * @brief The result of a successful lookup.
+             */
+            struct keyref_t {
+                string_view     section{}; //!< The section of the translation, stored in the index
+                string_view     field{}; //!< The field of the translation, stored in the index
+                const entry_t*  entry{nullptr}; //!< The entry; nullptr if the index was built without entries
+            };
+
+        public: // +++ Static Const +++
+            static constexpr stablekey_t INVALID_KEY = 0; //!< Never produced by getStableKey()
+
+        public: // +++ Static +++
+            static stablekey_t getStableKey(string_view section, string_view field); //!< Computes the stable key of a translation
+
+        public: // +++ Constructor / Destructor +++
+            key_index() = default;
+            ~key_index() = default; //!< Default dtor
+
+        public: // +++ Building +++
+            void            add(string_view section, string_view field, const entry_t* entry); //!< Adds a translation to the index
+            void            finalise(); //!< Sorts the index; must be called once all translations were added
+
+        public: // +++ Lookup +++
+            bool            empty() const { return m_records.empty(); }
+            size_t          size() const { return m_records.size(); }
+            size_t          getCollisionCount() const { return m_collisions; }
+            size_t          getResidentBytes() const { return m_pool.capacity() + m_records.capacity() * sizeof(record_t); }
+
+            bool            find(stablekey_t key, keyref_t& outRef) const; //!< Looks up a translation by its stable key
+
+        private: // +++ Internal +++
+            struct record_t {
+                stablekey_t     key; //!< The stable key of the translation
+                uint32_t        keyOffset; //!< The offset of the section name in the pool; the field follows directly
+                uint32_t        sectionLength; //!< The length of the section name
+                uint32_t        fieldLength; //!< The length of the field name
+                const entry_t*  entry; //!< The entry; nullptr if the key is ambiguous or the index was built without entries
+            };
+
+        private:
+            string              m_pool{}; //!< The names of all indexed translations
+            vector<record_t>    m_records{}; //!< The records, sorted by key after finalise()
+            size_t              m_collisions{0}; //!< The amount of keys which are ambiguous
+    };
+
+    /**
+     * @brief A long-lived reference to a single translation of a language.
+     *
+     * A handle caches the translation it was last resolved to, together with the generation of the language it
+     * was resolved in. Every (re)load of a language starts a new generation, after which the handle is resolved
+     * again by its stable key - without hashing any strings. If the translation no longer exists, the handle
+     * remembers that until the next reload.
+     *
+     * @remarks A handle is updated by lookups, so it must not be shared between threads without synchronisation.
+     */
+    class key_handle {
+        public: // +++ Constructor / Destructor +++
+            key_handle() = default;
+            explicit key_handle(stablekey_t key): m_key(key) {}
+            key_handle(string_view section, string_view field): m_key(key_index::getStableKey(section, field)) {}
+
+        public: // +++ Getters +++
+            stablekey_t     getKey() const { return m_key; }
+            bool            isValid() const { return m_key != key_index::INVALID_KEY; }
+
+        private:
+            friend class language;
+
+            stablekey_t     m_key{key_index::INVALID_KEY}; //!< The stable key of the translation
+            uint64_t        m_generation{0}; //!< The generation of the language the handle was last resolved in; 0 if it never was
+            const entry_t*  m_entry{nullptr}; //!< The cached entry; only used if the language has no memory budget
+            bool            m_missing{false}; //!< Whether the translation didn't exist when the handle was resolved
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_KEY_INDEX_HPP
@@ -0,0 +1,134 @@
+/**
+ * @file lang_metrics.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the counters each language keeps about its usage.
+ * @version 0.1
+ * @date 2023-02-19
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_LANG_METRICS_HPP
+#define LIBBORR_INCLUDE_BORR_LANG_METRICS_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace borr {
+
+    /**
+     * @brief Lock-free usage counters of a single language.
+     *
+     * Counters are incremented by concurrent readers on the hot path, so they are sharded:
+     * every thread increments its own cache line (one of SHARD_COUNT) with a relaxed atomic add,
+     * and reading a counter sums all shards. Readers and scrapers never block each other.
+     * Values read while other threads are incrementing are consistent per counter, but not across counters.
+     *
+     * Copying metrics copies their current values.
+     */
+    class lang_metrics {
+        public: // +++ Types +++
+            /**
+             * @brief The counters kept per language.
+             */
+            enum class counter_t : size_t {
+                Lookups, //!< Calls to getString()
+                Misses, //!< Lookups which didn't find a translation
+                Expansions, //!< Variables and references which were expanded
+                HotLookups, //!< Lookups which consulted the hot index
+                HotHits, //!< Lookups which were answered by the hot index
+                Loads, //!< Completed loads (fromFile(), fromString(), ...)
+                LoadNanoseconds, //!< The total time spent loading
+                Evictions, //!< Sections evicted to stay within the memory budget
+                Rematerialisations, //!< Evicted sections which were loaded again on access
+
+                Count //!< The amount of counters
+            };
+
+        public: // +++ Static Const +++
+            static constexpr size_t SHARD_COUNT = 8; //!< The amount of cache lines counters are spread across
+
+        public: // +++ Constructor / Destructor +++
+            lang_metrics() = default;
+            lang_metrics(const lang_metrics& other) { copyFrom(other); }
+            ~lang_metrics() = default; //!< Default dtor
+
+            lang_metrics& operator=(const lang_metrics& other) {
+                if (this != &other) { copyFrom(other); }
+                return *this;
+            }
+
+        public: // +++ Counting +++
+            /**
+             * @brief Adds a value to a counter of the calling thread's shard.
+             */
+            void        add(counter_t counter, uint64_t value = 1) const {
+                m_shards[getShardIndex()].values[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Records a completed load and its duration.
+             */
+            void        recordLoad(std::chrono::nanoseconds duration) const {
+                add(counter_t::Loads);
+                add(counter_t::LoadNanoseconds, static_cast<uint64_t>(duration.count()));
+                m_lastLoadNanoseconds.store(static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+            }
+
+        public: // +++ Getters +++
+            /**
+             * @brief Gets the current value of a counter, summed across all shards.
+             */
+            uint64_t    get(counter_t counter) const {
+                uint64_t value = 0;
+                for (const auto& shard : m_shards) { value += shard.values[static_cast<size_t>(counter)].load(std::memory_order_relaxed); }
+
+                return value;
+            }
+
+            uint64_t    getLastLoadNanoseconds() const { return m_lastLoadNanoseconds.load(std::memory_order_relaxed); }
+
+        private: // +++ Internal +++
+            /**
+             * @brief Counters are grouped per shard, so all counters of one thread share a single cache line.
+             */
+            struct alignas(64) shard_t {
+                std::array<std::atomic<uint64_t>, static_cast<size_t>(counter_t::Count)> values{};
+            };
+
+            /**
+             * @brief Threads are assigned to shards round-robin on their first increment.
+             */
+            static size_t getShardIndex() {
+                static std::atomic<size_t> nextIndex{0};
+                thread_local const size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+
+                return index;
+            }
+
+            void        copyFrom(const lang_metrics& other) {
+                for (size_t i = 0; i < static_cast<size_t>(counter_t::Count); i++) {
+                    const auto value = other.get(static_cast<counter_t>(i));
+                    for (size_t shard = 0; shard < SHARD_COUNT; shard++) {
+                        m_shards[shard].values[i].store(shard == 0 ? value : 0, std::memory_order_relaxed);
+                    }
+                }
+
+                m_lastLoadNanoseconds.store(other.getLastLoadNanoseconds(), std::memory_order_relaxed);
+            }
+
+        private:
+            mutable std::array<shard_t, SHARD_COUNT> m_shards{}; //!< The per-thread counters
+            mutable std::atomic<uint64_t> m_lastLoadNanoseconds{0}; //!< The duration of the last load
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_LANG_METRICS_HPP
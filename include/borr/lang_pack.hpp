@@ -0,0 +1,123 @@
+/**
+ * @file lang_pack.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the precompiled language pack format written by borrc.
+ * @version 0.1
+ * @date 2023-02-17
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_LANG_PACK_HPP
+#define LIBBORR_INCLUDE_BORR_LANG_PACK_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "mapped_file.hpp"
+
+namespace borr {
+
+    namespace fs = std::filesystem;
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * @brief A single translation as it is written to a language pack.
+     */
+    struct packentry_t {
+        string  section{}; //!< The section of the translation
+        string  field{}; //!< The field of the translation
+        string  value{}; //!< The raw (unexpanded) translation; multiline fields are already joined
+    };
+
+    /**
+     * @brief The metadata stored in the header of a language pack.
+     */
+    struct packmeta_t {
+        string      langId{}; //!< The lang_id of the language
+        string      langDescription{}; //!< The lang_desc of the language
+        string      langVersion{}; //!< The lang_ver of the language as "major.minor.revision"
+        uint64_t    sourceHash{0}; //!< The content hash of the borrfile the pack was compiled from
+    };
+
+    using packvisitor_t = std::function<void(string_view section, string_view field, string_view value)>;
+
+    /**
+     * @brief The precompiled language pack format.
+     *
+     * A language pack contains the already parsed contents of a borrfile: a small header, a table of
+     * (section, field, value) string references sorted by section and field, and a string pool in which
+     * every section name is stored only once.
+     * Loading a pack requires no regex matching and no sorting, so it is considerably faster than parsing the borrfile.
+     *
+     * The header contains the content hash of the source file, which lets borrc skip files which haven't changed.
+     * Packs are written in the byte order of the machine which compiled them; packs with a different byte order
+     * or format version are rejected (and recompiled by borrc).
+     *
+     * Besides the one-shot readers, a pack can be opened as an instance over a mapped file; the instance reads
+     * individual sections on demand by binary search, which is what languages with a memory budget use to
+     * re-materialise evicted sections.
+     */
+    class lang_pack {
+        public: // +++ Static Const +++
+            static constexpr string_view    PACK_MAGIC = string_view("BORRPAK\0", 8); //!< The magic bytes at the start of every pack
+            static constexpr uint32_t       PACK_VERSION = 1; //!< The version of the pack format
+            static constexpr string_view    FILE_EXTENSION = ".borrpack"; //!< The extension of language packs
+
+        public: // +++ Static +++
+            static void     writeFile(const fs::path& path, const packmeta_t& meta, vector<packentry_t> entries); //!< Writes a language pack
+            static string   writeString(const packmeta_t& meta, vector<packentry_t> entries); //!< Serialises a language pack into memory
+            static void     readFile(const fs::path& path, packmeta_t& outMeta, const packvisitor_t& visitor); //!< Reads a language pack, visiting every translation in order
+            static void     readString(string_view contents, packmeta_t& outMeta, const packvisitor_t& visitor); //!< Reads a language pack from memory
+
+            static std::optional<uint64_t> readSourceHash(const fs::path& path); //!< Reads only the source hash from a pack's header
+
+            static uint64_t hashContents(string_view contents); //!< Hashes the contents of a borrfile
+
+            static std::shared_ptr<const lang_pack> fromFile(const fs::path& path); //!< Maps and validates a language pack
+            static std::shared_ptr<const lang_pack> fromString(string contents); //!< Validates a language pack held in memory
+
+        public: // +++ Getters +++
+            const packmeta_t&   getMeta() const { return m_meta; }
+            size_t              getEntryCount() const { return m_entryCount; }
+            size_t              getSize() const { return m_contents.size(); }
+            bool                isMapped() const { return m_file != nullptr && m_file->isMapped(); }
+
+            vector<string>      getSectionNames() const; //!< Gets the names of all sections, in order
+
+            void                visitAll(const packvisitor_t& visitor) const; //!< Visits every translation in order
+            bool                visitSection(string_view section, const packvisitor_t& visitor) const; //!< Visits the translations of a single section
+
+        private:
+            explicit lang_pack(string_view contents);
+
+            void                getRecord(size_t index, string_view& outSection, string_view& outField, string_view& outValue) const;
+            string_view         getSection(size_t index) const;
+
+        private:
+            std::shared_ptr<const mapped_file>  m_file{}; //!< Owns the contents; empty for transient packs
+            string_view                         m_contents{}; //!< The entire pack
+            string_view                         m_pool{}; //!< The string pool
+            size_t                              m_entryCount{0}; //!< The amount of records
+            packmeta_t                          m_meta{}; //!< The metadata from the header
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_LANG_PACK_HPP
@@ -15,17 +15,35 @@
 // SYSTEM INCLUDES //
 /////////////////////
 // stl
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <istream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 /////////////////////
 // LOCAL  INCLUDES //
 /////////////////////
+#include "access_profile.hpp"
+#include "compiled_template.hpp"
+#include "expander_registry.hpp"
+#include "hot_index.hpp"
+#include "key_index.hpp"
+#include "lang_metrics.hpp"
+#include "lang_pack.hpp"
+#include "load_trace.hpp"
 #include "langversion.hpp"
+#include "mo_catalog.hpp"
+#include "render_memo.hpp"
+#include "render_profiler.hpp"
 
 /**
  * @brief Root namespace of the libborr.
@@ -40,6 +58,7 @@ namespace borr {
     using std::optional;
     using std::string;
     using std::string_view;
+    using std::vector;
 
 
     using sect_t = map<string, string>;
@@ -50,9 +69,120 @@ namespace borr {
     using optstr_t = optional<string>;
 
     // callback definitions
-    using varexpansioncallback_t = function<string(const string&)>;
     using varcbacklist_t = map<string, varexpansioncallback_t>;
 
+    /**
+     * @brief A single translation as it is held by a language; the raw value and its compiled template.
+     */
+    struct entry_t {
+        string              value{}; //!< The raw (unexpanded) translation
+        compiled_template   compiled{}; //!< The compiled template of the translation
+    };
+
+    using entrysect_t = map<string, entry_t>;
+    using entrydict_t = map<string, entrysect_t>;
+    using entryvisitor_t = function<void(const string& section, const string& field, const entry_t& entry)>;
+    using fieldsink_t = function<void(const string& field, string_view value)>;
+
+    /**
+     * @brief Options controlling how @c language::getSectionExpanded() renders a section.
+     */
+    struct expandopts_t {
+        size_t  threads{1}; //!< The maximum amount of threads rendering the section; 0 uses one per CPU
+        size_t  parallelThreshold{2048}; //!< Sections with fewer translations are always rendered on the calling thread
+        size_t  chunkSize{256}; //!< The amount of translations rendered by a worker at a time
+    };
+
+    /**
+     * @brief Options controlling which work is performed by @c language::warm() .
+     */
+    struct warmopts_t {
+        bool                            prefaultPages{true}; //!< Touch every page holding translations so no page faults occur later
+        bool                            compileTemplates{true}; //!< (Re-)compile and bind all templates against the current expanders
+        bool                            resolveReferences{true}; //!< Bind cross-references directly to their target translations
+        vector<std::pair<string, string>> hotKeys{}; //!< Section/field pairs which are rendered once
+    };
+
+    /**
+     * @brief Statistics about the work performed by @c language::warm() .
+     */
+    struct warmstats_t {
+        size_t  bytesTouched{0}; //!< The amount of translation bytes which were touched
+        size_t  templatesCompiled{0}; //!< The amount of templates which were compiled
+        size_t  referencesResolved{0}; //!< The amount of references bound to their target
+        size_t  hotKeysRendered{0}; //!< The amount of hot keys which were rendered
+        size_t  hotKeysMissing{0}; //!< The amount of hot keys which don't exist
+    };
+
+    /**
+     * @brief Options controlling how @c language::fromStream() reads its input.
+     */
+    struct streamopts_t {
+        size_t  bufferSize{64 * 1024}; //!< The size of the buffer the stream is read through
+        size_t  maxLineLength{0}; //!< The maximum length of a single line; 0 means unlimited
+    };
+
+    /**
+     * @brief The optional size hints from the header of a borrfile, as returned by @c language::peekMetadata() .
+     *
+     * Hints let tools size their tables before loading a file; 0 means "no (valid) hint". They are never trusted for correctness.
+     * Loading ignores them: once a language is loaded, @c language::getStats() reports the actual counts.
+     */
+    struct sizehints_t {
+        size_t  sections{0}; //!< The lang_sections field
+        size_t  keys{0}; //!< The lang_keys field
+    };
+
+    /**
+     * @brief The header of a language file, as returned by @c language::peekMetadata() .
+     */
+    struct langmeta_t {
+        string          langId{}; //!< The lang_id field
+        ver_t           langVer{}; //!< The lang_ver field
+        string          langDescription{}; //!< The lang_desc field
+        sizehints_t     sizeHints{}; //!< The lang_sections and lang_keys fields
+        map<string, string> fields{}; //!< Any further fields in front of the first section, by name
+    };
+
+    /**
+     * @brief Key counts and memory usage of a language, as returned by @c language::getStats() .
+     */
+    struct langstats_t {
+        size_t  sections{0}; //!< The amount of resident sections
+        size_t  keys{0}; //!< The amount of translations
+        size_t  multilineKeys{0}; //!< The amount of translations spanning multiple lines
+        size_t  keysWithVariables{0}; //!< The amount of translations containing at least one variable
+        size_t  keyBytes{0}; //!< The total length of all section and field names
+        size_t  valueBytes{0}; //!< The total length of all raw translations
+        size_t  residentBytes{0}; //!< An estimate of the heap memory held by the translation tables, templates and hot index
+        size_t  hotKeys{0}; //!< The amount of translations in the hot index
+        size_t  moMessages{0}; //!< The amount of messages in a mapped .mo catalog
+        size_t  moMappedBytes{0}; //!< The size of a mapped .mo catalog
+        size_t  evictedSections{0}; //!< The amount of sections which are currently evicted to stay within the memory budget
+    };
+
+    /**
+     * @brief The residency of a single section of a language with a memory budget.
+     */
+    struct sectionresidency_t {
+        size_t      bytes{0}; //!< The estimated resident size of the section, as of its last materialisation
+        uint64_t    lastUse{0}; //!< The logical time of the last access
+        bool        resident{true}; //!< Whether the section is currently held in the translation dictionary
+    };
+
+    /**
+     * @brief The state of a language's memory budget; see @c language::setMemoryBudget() .
+     */
+    struct membudget_t {
+        size_t                          budgetBytes{0}; //!< The maximum resident size of the translation tables
+        std::atomic<size_t>             residentBytes{0}; //!< The estimated resident size of all resident sections; may be read without the lock
+        std::atomic<size_t>             residentSections{0}; //!< The amount of resident sections; may be read without the lock
+        uint64_t                        clock{0}; //!< Incremented on every section access; orders sections by recency
+        size_t                          depth{0}; //!< The nesting depth of lookups holding the mutex; the budget is enforced when it drops to 0
+        map<string, sectionresidency_t> sections{}; //!< The residency of every section of the language
+        std::recursive_mutex            mutex{}; //!< Serialises lookups, re-materialisation and eviction
+    };
+
     /**
      * @brief The language class - a language manager and file parser.
      * 
@@ -151,29 +281,93 @@ namespace borr {
             static constexpr string_view LANG_ID_FIELD = "lang_id"; //!< The lang_id field name
             static constexpr string_view LANG_VER_FIELD = "lang_ver"; //!< The lang_ver field name
             static constexpr string_view LANG_DESC_FIELD = "lang_desc"; //!< The lang_desc field name
-            static constexpr string_view VARIABLE_REGEX = R"(\$\{([A-z_]([A-z_]+):?)[A-z_][A-z0-9_]+\})"; //!< The regex used to find variables for expansion
-            static constexpr string_view SECTION_REGEX = R"(^\[[A-z_]([A-z_]+)?\]$)"; //!< The regex used to find sections in a file
-            static constexpr string_view TRANSLATION_REGEX = R"(^[A-z_][A-z0-9_]+(\[\])?[\s]+?=[\s]+?"([^"]+)?"$)"; //!< The regex used to find translations in a file
+            static constexpr string_view LANG_SECTIONS_FIELD = "lang_sections"; //!< The optional hint for the amount of sections
+            static constexpr string_view LANG_KEYS_FIELD = "lang_keys"; //!< The optional hint for the amount of translations
+            static constexpr size_t      MAX_SIZE_HINT = 1 << 22; //!< Larger size hints are considered invalid
+            static constexpr string_view VARIABLE_REGEX = R"(\$\{([A-z_]([A-z_]+):?)[A-z_][A-z0-9_]+\})"; //!< The grammar of variables; matched in linear time by compiled_template::findVariable()
+            static constexpr string_view SECTION_REGEX = R"(^\[[A-z_]([A-z_]+)?\]$)"; //!< The grammar of section lines; matched in linear time without std::regex
+            static constexpr string_view TRANSLATION_REGEX = R"(^[A-z_][A-z0-9_]+(\[\])?[\s]+?=[\s]+?"([^"]+)?"$)"; //!< The grammar of translation lines; matched in linear time without std::regex
+            static constexpr size_t      MAX_EXPANSION_DEPTH = 32; //!< The maximum depth of nested expansions and references
+            static constexpr size_t      DEFAULT_HOT_KEYS = 512; //!< The default amount of translations laid out by applyAccessProfile()
 
         public: // +++ Static +++
             static language fromFile(const fs::directory_entry&); //!< Load a language from disk
             static language fromString(const string&); //!< Load a pre-loaded language file from memory
 
+            static void     fromFile(const fs::directory_entry&, language& outLang); //!< Load a language from disk into an existing object
+            static void     fromString(const string&, language& outLang); //!< Load a pre-loaded language file from memory into an existing object
+
+            static language fromStream(std::istream&, const streamopts_t& options = {}); //!< Load a language file from a stream, line by line
+            static void     fromStream(std::istream&, language& outLang, const streamopts_t& options = {}); //!< Load a language file from a stream into an existing object
+
+            static language fromMoFile(const fs::directory_entry&); //!< Map a GNU gettext .mo catalog
+            static void     fromMoFile(const fs::directory_entry&, language& outLang); //!< Map a GNU gettext .mo catalog into an existing object
+
+            static language fromPackFile(const fs::directory_entry&); //!< Load a language pack compiled by borrc
+            static void     fromPackFile(const fs::directory_entry&, language& outLang); //!< Load a language pack compiled by borrc into an existing object
+
+            static langmeta_t peekMetadata(const fs::path&); //!< Reads only the header of a language file or pack
+
+            static void     setLoadTracer(loadtracer_t tracer); //!< Reports the phases of all subsequent loads to a callback; an empty function removes it
+
         public: // +++ Constructor / Destructor +++
-                            // language(const language&) = default;
+                            language(const language&); //!< Copy ctor; rebinds resolved references to the copy
+                            language(language&&) = default; //!< Default move ctor
             ~               language() = default; //!< Default dtor
 
+            language&       operator=(const language&); //!< Copy assignment
+            language&       operator=(language&&) = default; //!< Default move assignment
+
         public: // +++ Getters +++
             optsect_t       getSection(const string&) const; //!< Gets a complete translation section. No variables are expanded!
             optstr_t        getString(const string&, const string&, bool expandVariables = true) const; //!< Gets a single translation with optional variable expansion
+            bool            getSectionExpanded(const string&, const fieldsink_t& sink, const expandopts_t& options = {}) const; //!< Renders every translation of a section in one pass
 
             const ver_t&    getLanguageVersion() const { return m_langVer; }
             const string&   getLangId() const { return m_langId; }
             const string&   getLangDescription() const { return m_langDescription; }
+            uint64_t        getFingerprint() const; //!< A hash of the header and all translations; equal contents give equal fingerprints on every platform
+
+            vector<string>  getSectionNames() const; //!< Gets the names of all sections, in sorted order
+            void            visitTranslations(const entryvisitor_t& visitor) const; //!< Visits every translation in sorted order, without copying
+            langstats_t     getStats() const; //!< Gets key counts and an estimate of the memory used by this language
+            const lang_metrics& getMetrics() const { return m_metrics; } //!< Gets the lookup, expansion and load counters of this language
+
+        public: // +++ Stable Keys +++
+            static stablekey_t getStableKey(string_view section, string_view field) { return key_index::getStableKey(section, field); }
+
+            optstr_t        getString(stablekey_t key, bool expandVariables = true) const; //!< Gets a single translation by its stable key
+            optstr_t        getString(key_handle& handle, bool expandVariables = true) const; //!< Gets a single translation through a handle, resolving it if the language was reloaded
+            uint64_t        getGeneration() const { return m_generation; } //!< Changes with every (re)load; handles from older generations are resolved again
+
+        public: // +++ Serialisation +++
+            void            toPackFile(const fs::path& path, uint64_t sourceHash = 0) const; //!< Writes this language as a language pack
+
+        public: // +++ Memory Budget +++
+            void            setMemoryBudget(size_t bytes); //!< Limits the resident size of the translation tables; 0 removes the limit
+            size_t          getMemoryBudget() const { return m_budget ? m_budget->budgetBytes : 0; }
+
+            void            pinSection(const string& section); //!< Keeps a section resident regardless of the memory budget
+            void            unpinSection(const string& section); //!< Allows a pinned section to be evicted again
+            bool            isSectionPinned(const string& section) const; //!< Determines whether a section is pinned
+
+        public: // +++ Warm-up +++
+            warmstats_t     warm(const warmopts_t& options = {}); //!< Performs all lazy initialisation up front
+
+        public: // +++ Access Profiling +++
+            void            setAccessProfile(const std::shared_ptr<access_profile>& profile) { m_accessProfile = profile; } //!< Records all lookups into the given profile; nullptr disables recording
+            const std::shared_ptr<access_profile>& getAccessProfile() const { return m_accessProfile; }
+
+            size_t          applyAccessProfile(const access_profile& profile, size_t maxHotKeys = DEFAULT_HOT_KEYS); //!< Lays out the hottest translations contiguously
+
+        public: // +++ Render Profiling +++
+            void            setRenderProfiler(const std::shared_ptr<render_profiler>& profiler) { m_renderProfiler = profiler; } //!< Samples renders into the given profiler; nullptr disables sampling
+            const std::shared_ptr<render_profiler>& getRenderProfiler() const { return m_renderProfiler; }
 
         public: // +++ Callback Management +++
             static bool     addVarExpansionCallback(const string& varName, const varexpansioncallback_t& cb); //!< Adds a new variable expander
             static void     removeVarExpansionCallback(const string& varName); //!< Removes the variable expander for a given variable name
+            static void     freezeVarExpansionCallbacks(); //!< Prevents new variable names from being registered and enables perfect-hash lookups
 
         public: // +++ Constructor ++
                             language(); //!< Protected default ctor
@@ -187,13 +381,38 @@ namespace borr {
             virtual string  removeInlineComments(const string&) const; //!< Removes any inline comments
 
             virtual void    clear(); //!< Clears all variales and translation tables.
+            virtual void    compileTemplates(); //!< Compiles and binds the templates of all translations
+            size_t          resolveReferences(); //!< Binds all cross-references to their target translations
             virtual void    parseLine(const string&); //!< Parses a single line
+            size_t          parseChunk(string_view chunk, string& pendingLine, size_t maxLineLength); //!< Parses all complete lines in a chunk of input
 
         protected: // +++ Translation retrieval +++
             virtual bool    containsVariable(const string&, string& outVarName) const; //!< Determines whether or not a translation contains a variable
 
             virtual string  expandVariable(const string&) const; //!< Expands a given variable.
 
+            const entry_t*  findEntry(const string& section, const string& field) const; //!< Finds a single translation entry
+            optsect_t       getMoSection(const string& sectionName) const; //!< Gets a section from the mapped .mo catalog
+
+            string          renderEntry(const entry_t&, size_t depth) const; //!< Renders a translation with all variables expanded
+            string          renderEntry(const entry_t&, size_t depth, render_memo& memo) const; //!< Renders a translation as part of a larger render
+            string          renderTemplate(const string& source, const compiled_template&, size_t depth, render_memo& memo) const; //!< Renders a compiled template
+            void            appendTemplate(string& output, const string& source, const compiled_template&, size_t depth, render_memo& memo) const; //!< Renders a compiled template into an existing buffer
+            string          renderNested(const string& value, size_t depth, render_memo& memo) const; //!< Expands variables contained in the result of an expansion
+
+        protected: // +++ Memory Budget +++
+            packmeta_t      getPackMeta(uint64_t sourceHash) const; //!< Gets the metadata written to language packs
+            vector<packentry_t> getPackEntries() const; //!< Gets all translations, including evicted sections, as pack entries
+
+            void            rebuildResidency(); //!< Initialises the residency of all sections after a load
+            void            ensureResident(const string& section) const; //!< Re-materialises a section if it was evicted
+            void            enforceMemoryBudget() const; //!< Evicts the least recently used sections until the budget is met
+
+            std::unique_lock<std::recursive_mutex> lockBudget() const; //!< Locks the memory budget, if any
+
+        protected: // +++ Stable Keys +++
+            const key_index& getKeyIndex() const; //!< Gets the index of all stable keys, building it on first use
+
         protected: // +++ Default expanders +++
             static string   dateExpander(const string&); //!< Expands the "date" variable
             static string   timeExpander(const string&); //!< Expands the "time" variable
@@ -202,10 +421,19 @@ namespace borr {
             static string   liburlExpander(const string&); //!< Expands the "liburl" variable
 
         protected: // +++ Inheritable members +++
-            static varcbacklist_t _defaultExpandersList; //!< The list of default expanders provided by the lib
+            static expander_registry _expanderRegistry; //!< The registry containing the default expanders and all custom expanders
 
         private:
-            dict_t          m_translationDict{}; //!< The translation dictionary containing sections and translations
+            class budget_scope; //!< Holds the budget lock during a lookup and enforces the budget once the outermost lookup completes
+            class load_trace; //!< Reports the phases of a load to the load tracer and USDT probes
+
+            language(const language& other, std::unique_lock<std::recursive_mutex> otherLock); //!< Copies a language while its budget is locked
+
+            void            finishLoad(load_trace& trace); //!< Links the loaded translations and sets up the memory budget
+            uint64_t        computeFingerprint() const; //!< Hashes the header and all translations
+
+        private:
+            entrydict_t     m_translationDict{}; //!< The translation dictionary containing sections and translations
 
             langversion     m_langVer{}; //!< The language file's version
 
@@ -213,8 +441,25 @@ namespace borr {
             string          m_langId{}; //!< The language's ID (region_COUNTRY)
             string          m_langDescription{}; //!< The language's description
 
-        private: // +++ Static +++
-            static varcbacklist_t  _callbackList; //!< The list of callbacks for variable expansion
+            bool            m_referencesResolved{false}; //!< Whether or not references point directly to their targets
+
+            std::shared_ptr<access_profile> m_accessProfile{}; //!< The profile lookups are recorded into, if any
+            std::shared_ptr<render_profiler> m_renderProfiler{}; //!< The profiler renders are sampled into, if any
+            hot_index       m_hotIndex{}; //!< The hottest translations, laid out contiguously
+
+            std::shared_ptr<const mo_catalog> m_moCatalog{}; //!< A mapped .mo catalog backing this language, if any
+
+            lang_metrics    m_metrics{}; //!< Usage counters; updated by concurrent readers without locking
+
+            std::shared_ptr<const lang_pack> m_backingPack{}; //!< The pack evicted sections are re-materialised from
+            std::unique_ptr<membudget_t> m_budget{}; //!< The memory budget; nullptr if the translation tables may grow without limit
+            std::set<string> m_pinnedSections{}; //!< Sections which are never evicted
+
+            mutable std::shared_ptr<const key_index> m_keyIndex{}; //!< The index of all stable keys; built on first use, accessed atomically
+            uint64_t        m_generation{0}; //!< Identifies the current contents of the translation tables; unique across all languages
+            mutable std::shared_ptr<const uint64_t> m_fingerprint{}; //!< The hash of the loaded contents; computed on first use, accessed atomically
+            langstats_t     m_loadStats{}; //!< The key counts and sizes of the loaded translation tables; computed once per load
+            load_trace*     m_loadTrace{nullptr}; //!< The trace of the load in progress, if any
     };
 
 }
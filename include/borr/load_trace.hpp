@@ -0,0 +1,72 @@
+/**
+ * @file load_trace.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the events reported while a language is loaded.
+ * @version 0.1
+ * @date 2023-03-01
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_LOAD_TRACE_HPP
+#define LIBBORR_INCLUDE_BORR_LOAD_TRACE_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace borr {
+
+    using std::string_view;
+
+    /**
+     * @brief The phases of a load, as reported to load tracers and USDT probes.
+     *
+     * The numeric values are passed to the phase__start and phase__done probes and won't change.
+     */
+    enum class loadphase_t: uint8_t {
+        Load        = 0, //!< An entire load; the name is the source (a path, "string" or "stream"), items the amount of translations
+        Read        = 1, //!< Reading a chunk of a stream (the last read of a stream reaches EOF and reads 0 bytes), or mapping and validating a pack or .mo file; items is the amount of bytes
+        Parse       = 2, //!< Splitting the input into lines and parsing them; items is the amount of lines (translations for packs)
+        Section     = 3, //!< Parsing a single block of a section; the name is the section, items the translations it holds so far
+        Link        = 4, //!< Compiling all templates and binding their variables; items is the amount of translations
+        Residency   = 5, //!< Setting up the memory budget, if any; items is the amount of sections
+    };
+
+    /**
+     * @brief A single completed phase of a load.
+     */
+    struct loadevent_t {
+        loadphase_t                             phase{loadphase_t::Load}; //!< The phase which completed
+        string_view                             name{}; //!< The source of a Load, the section of a Section; empty otherwise
+        std::chrono::steady_clock::time_point   start{}; //!< When the phase started
+        std::chrono::nanoseconds                duration{0}; //!< How long the phase took
+        size_t                                  items{0}; //!< What was processed by the phase; see loadphase_t
+    };
+
+    using loadtracer_t = std::function<void(const loadevent_t& event)>;
+
+    /**
+     * @brief Gets the name of a load phase, e.g. for log messages.
+     */
+    constexpr string_view getPhaseName(loadphase_t phase) {
+        switch (phase) {
+            case loadphase_t::Load:         return "load";
+            case loadphase_t::Read:         return "read";
+            case loadphase_t::Parse:        return "parse";
+            case loadphase_t::Section:      return "section";
+            case loadphase_t::Link:         return "link";
+            case loadphase_t::Residency:    return "residency";
+        }
+
+        return "unknown";
+    }
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_LOAD_TRACE_HPP
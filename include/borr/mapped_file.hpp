@@ -0,0 +1,68 @@
+/**
+ * @file mapped_file.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a read-only file mapping shared by the binary catalog formats.
+ * @version 0.1
+ * @date 2023-02-20
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_MAPPED_FILE_HPP
+#define LIBBORR_INCLUDE_BORR_MAPPED_FILE_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace borr {
+
+    namespace fs = std::filesystem;
+
+    using std::string;
+    using std::string_view;
+
+    /**
+     * @brief A read-only file which is mapped into memory.
+     *
+     * Mapped pages are clean, so the kernel can drop them under memory pressure and fault them back in on access.
+     * If the platform has no mmap() or mapping fails, the file is read into memory instead.
+     */
+    class mapped_file {
+        public: // +++ Static +++
+            static std::shared_ptr<const mapped_file> fromFile(const fs::path& path); //!< Maps a file into memory
+            static std::shared_ptr<const mapped_file> fromString(string contents); //!< Wraps contents which are already in memory
+
+        public: // +++ Constructor / Destructor +++
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+            ~mapped_file(); //!< Unmaps the file
+
+        public: // +++ Getters +++
+            const uint8_t*  data() const { return m_data; }
+            size_t          size() const { return m_size; }
+            bool            isMapped() const { return m_mapped; }
+
+            string_view     view() const { return string_view(reinterpret_cast<const char*>(m_data), m_size); }
+
+            size_t          prefault() const; //!< Touches every page
+
+        private:
+            mapped_file() = default;
+
+        private:
+            const uint8_t*  m_data{nullptr}; //!< The start of the file
+            size_t          m_size{0}; //!< The size of the file
+            bool            m_mapped{false}; //!< Whether m_data is a memory mapping
+            string          m_buffer{}; //!< Holds the file if it isn't mapped
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_MAPPED_FILE_HPP
@@ -0,0 +1,111 @@
+/**
+ * @file mo_catalog.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a memory-mapped GNU gettext message catalog.
+ * @version 0.1
+ * @date 2023-02-14
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_MO_CATALOG_HPP
+#define LIBBORR_INCLUDE_BORR_MO_CATALOG_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "mapped_file.hpp"
+
+namespace borr {
+
+    namespace fs = std::filesystem;
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * @brief A single message as written to a .mo file.
+     */
+    struct moentry_t {
+        string  context{}; //!< The message context (msgctxt); empty if the message has no context
+        string  msgid{}; //!< The original string
+        string  msgstr{}; //!< The translated string
+    };
+
+    /**
+     * @brief A GNU gettext .mo catalog which is mapped into memory.
+     *
+     * Lookups use the hash table stored in the file itself (falling back to a binary search over the sorted originals
+     * if the file has no hash table), so opening a catalog only requires validating its header and tables.
+     * Both byte orders are supported.
+     *
+     * Messages with a context (msgctxt) are stored as "context\x04msgid" in .mo files; libborr maps contexts to sections.
+     * For plural messages, only the first (singular) form is exposed.
+     */
+    class mo_catalog {
+        public: // +++ Static Const +++
+            static constexpr uint32_t   MO_MAGIC = 0x950412de; //!< The magic number of a .mo file
+            static constexpr uint32_t   MO_MAGIC_SWAPPED = 0xde120495; //!< The magic number of a .mo file in the opposite byte order
+            static constexpr char       CONTEXT_SEPARATOR = '\x04'; //!< Separates the context from the msgid
+
+        public: // +++ Static +++
+            static std::shared_ptr<const mo_catalog> fromFile(const fs::path& path); //!< Maps a .mo file into memory
+            static void     writeFile(const fs::path& path, vector<moentry_t> entries); //!< Writes a .mo file, including its hash table
+
+            static uint32_t hashString(string_view context, string_view msgid); //!< The hash function used by GNU gettext
+
+        public: // +++ Constructor / Destructor +++
+            mo_catalog(const mo_catalog&) = delete;
+            mo_catalog& operator=(const mo_catalog&) = delete;
+            ~mo_catalog() = default; //!< Default dtor
+
+        public: // +++ Lookup +++
+            bool            find(string_view context, string_view msgid, string_view& outTranslation) const; //!< Finds a translation
+            bool            getEntry(size_t index, string_view& outContext, string_view& outMsgid, string_view& outTranslation) const; //!< Gets an entry by index
+
+            size_t          size() const { return m_stringCount; }
+            size_t          getMappedSize() const { return m_size; }
+            bool            isMapped() const { return m_file->isMapped(); }
+            bool            hasHashTable() const { return m_hashSize > 2; }
+
+            string_view     getHeader() const; //!< Gets the catalog header (the translation of the empty msgid)
+            string          getHeaderField(string_view fieldName) const; //!< Gets a single field from the catalog header
+
+            size_t          prefault() const; //!< Touches every mapped page
+
+        private: // +++ Internal +++
+            mo_catalog() = default;
+
+            uint32_t        readWord(size_t offset) const; //!< Reads a 32-bit word in the file's byte order
+            bool            getString(uint32_t tableOffset, size_t index, string_view& outString) const; //!< Gets a string from a string table
+            bool            matches(size_t index, string_view context, string_view msgid) const; //!< Whether an original matches context and msgid
+            void            validate(); //!< Validates the header and tables
+
+        private:
+            std::shared_ptr<const mapped_file> m_file{}; //!< The mapped file
+            const uint8_t*  m_data{nullptr}; //!< The start of the file
+            size_t          m_size{0}; //!< The size of the file
+
+            bool            m_swapped{false}; //!< Whether the file's byte order differs from ours
+            uint32_t        m_stringCount{0}; //!< The amount of strings in the catalog
+            uint32_t        m_originalsOffset{0}; //!< The offset of the table of originals
+            uint32_t        m_translationsOffset{0}; //!< The offset of the table of translations
+            uint32_t        m_hashSize{0}; //!< The size of the hash table
+            uint32_t        m_hashOffset{0}; //!< The offset of the hash table
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_MO_CATALOG_HPP
@@ -0,0 +1,50 @@
+/**
+ * @file openmetrics.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the serialisation of libborr's metrics into the OpenMetrics text format.
+ * @version 0.1
+ * @date 2023-02-19
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_OPENMETRICS_HPP
+#define LIBBORR_INCLUDE_BORR_OPENMETRICS_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace borr {
+
+    class language;
+
+}
+
+/**
+ * @brief Serialisation of metrics into the OpenMetrics (and Prometheus) text exposition format.
+ *
+ * libborr doesn't contain a server; pass the output to an existing metrics endpoint,
+ * served with the content type CONTENT_TYPE.
+ */
+namespace borr::openmetrics {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    constexpr string_view CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8"; //!< The content type of the exposition
+
+    string  format(const vector<const language*>& languages); //!< Serialises the metrics of the given languages
+    void    write(std::ostream& outStream, const vector<const language*>& languages); //!< Writes the metrics of the given languages to a stream
+
+    string  escapeLabelValue(string_view value); //!< Escapes a label value
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_OPENMETRICS_HPP
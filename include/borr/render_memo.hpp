@@ -0,0 +1,104 @@
+/**
+ * @file render_memo.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of the memo table which is shared by all expansions of a single render.
+ * @version 0.1
+ * @date 2023-02-22
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_RENDER_MEMO_HPP
+#define LIBBORR_INCLUDE_BORR_RENDER_MEMO_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstddef>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace borr {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * @brief Remembers the expansion of every variable during a single top-level render.
+     *
+     * A translation (or a chain of references) often uses the same variable several times;
+     * with a memo, every distinct variable is expanded - and its expander invoked - at most once per render.
+     * This also means that every occurrence of a variable such as ${time} expands to the same value.
+     *
+     * Renders rarely contain more than a handful of distinct variables, so the first INLINE_CAPACITY
+     * expansions are stored inside the object itself, which lives on the stack of the render.
+     * Only renders with more distinct variables allocate.
+     */
+    class render_memo {
+        public: // +++ Static Const +++
+            static constexpr size_t INLINE_CAPACITY = 8; //!< The amount of expansions stored without allocating
+
+        public: // +++ Constructor / Destructor +++
+            render_memo() = default;
+            ~render_memo() { for (size_t i = 0; i < m_inlineSize; i++) { getInline()[i].~memoentry_t(); } }
+
+            render_memo(const render_memo&) = delete;
+            render_memo& operator=(const render_memo&) = delete;
+
+        public: // +++ Memoisation +++
+            /**
+             * @brief Finds the expansion of a variable.
+             *
+             * @return const string* The expansion, or nullptr if the variable hasn't been expanded during this render.
+             */
+            const string* find(string_view name) const {
+                for (size_t i = 0; i < m_inlineSize; i++) {
+                    if (getInline()[i].name == name) { return &getInline()[i].value; }
+                }
+
+                for (const auto& entry : m_overflow) {
+                    if (entry.name == name) { return &entry.value; }
+                }
+
+                return nullptr;
+            }
+
+            /**
+             * @brief Remembers the expansion of a variable.
+             *
+             * @return const string& The stored expansion; valid until the next call to insert().
+             */
+            const string& insert(string_view name, string value) {
+                if (m_inlineSize < INLINE_CAPACITY) {
+                    return (new (m_inline + m_inlineSize++ * sizeof(memoentry_t)) memoentry_t{ string(name), std::move(value) })->value;
+                }
+
+                m_overflow.push_back({ string(name), std::move(value) });
+                return m_overflow.back().value;
+            }
+
+            size_t      size() const { return m_inlineSize + m_overflow.size(); }
+
+        private:
+            struct memoentry_t {
+                string  name; //!< The name of the variable, as written between ${ and }
+                string  value; //!< The rendered expansion
+            };
+
+            memoentry_t*        getInline() { return std::launder(reinterpret_cast<memoentry_t*>(m_inline)); }
+            const memoentry_t*  getInline() const { return std::launder(reinterpret_cast<const memoentry_t*>(m_inline)); }
+
+        private:
+            alignas(memoentry_t) unsigned char  m_inline[INLINE_CAPACITY * sizeof(memoentry_t)]; //!< Storage for the first INLINE_CAPACITY entries
+            size_t                              m_inlineSize{0}; //!< The amount of constructed entries in m_inline
+            vector<memoentry_t>                 m_overflow{}; //!< Entries beyond INLINE_CAPACITY
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_RENDER_MEMO_HPP
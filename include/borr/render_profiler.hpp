@@ -0,0 +1,115 @@
+/**
+ * @file render_profiler.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a sampling profiler for slow renders.
+ * @version 0.1
+ * @date 2023-03-02
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_RENDER_PROFILER_HPP
+#define LIBBORR_INCLUDE_BORR_RENDER_PROFILER_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace borr {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * @brief Records where the time of sampled renders is spent, keeping only the slowest spans.
+     *
+     * Sampling works like @c access_profile : only every n-th call to @c language::getString() (per thread and profiler) which expands variables
+     * is timed. A sampled render is broken down into the lookup of the translation and every variable it expands -
+     * bound expanders (user callbacks and default expanders), dynamic expansions through expandVariable() and cross-references,
+     * including the nested expansions of referenced translations. Memoised expansions cost nothing and aren't reported.
+     *
+     * Spans are keyed by the rendered translation and the variable (empty for the render itself), so a slow callback or a deeply
+     * nested reference chain shows up as its own entry. Only the getCapacity() slowest keys are kept; the remaining calls cost
+     * a thread-local increment and never write to memory shared between threads.
+     */
+    class render_profiler {
+        public: // +++ Types +++
+            /**
+             * @brief What a span measured.
+             */
+            enum class spankind_t: uint8_t {
+                Render,     //!< An entire getString() call
+                Expander,   //!< A variable bound to an expander at load time
+                Dynamic,    //!< A variable expanded through expandVariable(), e.g. one registered after the language was loaded
+                Reference,  //!< A cross-reference to another translation, including all of its nested expansions
+            };
+
+            /**
+             * @brief The slowest observation of a single key, and how often the key was sampled.
+             */
+            struct slowspan_t {
+                string                      section{}; //!< The section of the rendered translation
+                string                      field{}; //!< The field of the rendered translation
+                string                      variable{}; //!< The expanded variable; empty for Render spans
+                spankind_t                  kind{spankind_t::Render}; //!< What was measured
+                std::chrono::nanoseconds    slowest{0}; //!< The slowest sampled duration
+                std::chrono::nanoseconds    lookup{0}; //!< Render spans: the part of the slowest render spent finding the translation
+                size_t                      depth{0}; //!< The nesting depth of the slowest expansion; 0 for variables of the translation itself
+                std::chrono::nanoseconds    total{0}; //!< The sum of all sampled durations
+                uint64_t                    samples{0}; //!< How often the key was sampled
+            };
+
+        public: // +++ Static Const +++
+            static constexpr uint32_t   DEFAULT_SAMPLE_RATE = 64; //!< By default, one in 64 renders is sampled
+            static constexpr size_t     DEFAULT_CAPACITY = 64; //!< By default, the 64 slowest keys are kept
+
+        public: // +++ Constructor / Destructor +++
+            explicit render_profiler(uint32_t sampleRate = DEFAULT_SAMPLE_RATE, size_t capacity = DEFAULT_CAPACITY);
+            ~render_profiler() = default; //!< Default dtor
+
+            render_profiler(const render_profiler&) = delete;
+            render_profiler& operator=(const render_profiler&) = delete;
+
+        public: // +++ Recording +++
+            bool            shouldSample() const; //!< Determines whether the current render should be sampled
+            void            add(const slowspan_t& span); //!< Merges a sampled span into the profile
+            void            addRender() { m_renders++; } //!< Counts a sampled render
+            void            clear(); //!< Removes all spans
+
+        public: // +++ Getters +++
+            uint32_t        getSampleRate() const { return m_sampleRate; }
+            size_t          getCapacity() const { return m_capacity; }
+            uint64_t        getSampledRenders() const { return m_renders; }
+
+            vector<slowspan_t> getSlowest() const; //!< Gets all kept spans, slowest first
+            void            write(std::ostream& outStream) const; //!< Writes the kept spans as a tab-separated table, slowest first
+
+        private:
+            using spankey_t = std::tuple<string, string, string>;
+
+            uint32_t                    m_sampleRate; //!< One in m_sampleRate renders is sampled
+            size_t                      m_capacity; //!< The maximum amount of kept keys
+
+            mutable std::mutex          m_spansMutex{}; //!< Protects the spans
+            std::map<spankey_t, slowspan_t> m_spans{}; //!< The slowest keys
+            std::atomic<uint64_t>       m_renders{0}; //!< The amount of sampled renders
+            uint64_t                    m_samplerId; //!< Identifies this profiler's per-thread sample counters
+    };
+
+    string_view getSpanKindName(render_profiler::spankind_t kind); //!< Gets the name of a span kind, e.g. for reports
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_RENDER_PROFILER_HPP
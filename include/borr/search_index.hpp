@@ -0,0 +1,129 @@
+/**
+ * @file search_index.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declaration of a trigram full-text index over the translations of one or more languages.
+ * @version 0.1
+ * @date 2023-03-04
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#ifndef LIBBORR_INCLUDE_BORR_SEARCH_INDEX_HPP
+#define LIBBORR_INCLUDE_BORR_SEARCH_INDEX_HPP
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace borr {
+
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    class language;
+
+    /**
+     * @brief Controls how a search_index is built.
+     */
+    struct indexopts_t {
+        size_t  threads{0}; //!< The amount of threads extracting and sorting trigrams; 0 uses one per CPU
+        size_t  chunkSize{4096}; //!< The amount of translations a worker takes at once
+    };
+
+    /**
+     * @brief A full-text index over the raw values of all translations of one or more languages.
+     *
+     * Every value is split into overlapping trigrams (three bytes, ASCII letters folded to lower case). Each trigram maps to
+     * the sorted list of translations containing it, stored as LEB128 varints of the differences between consecutive
+     * translation numbers, so frequent trigrams cost about a byte per translation.
+     * A query intersects the lists of its trigrams, shortest first, and verifies the remaining candidates against the values,
+     * so results are exact; queries shorter than three characters have no trigrams and scan all values.
+     *
+     * The index holds a copy of all values and doesn't refer to the languages once it's built; it doesn't change when they are
+     * reloaded. Values are indexed as written, with variables unexpanded, i.e. as translators see them.
+     * Sections of mapped .mo catalogs aren't indexed.
+     *
+     * All queries may be called concurrently.
+     */
+    class search_index {
+        public: // +++ Types +++
+            /**
+             * @brief A translation matching a query; all views point into the index.
+             */
+            struct searchhit_t {
+                string_view langId{}; //!< The lang_id of the language containing the translation
+                string_view section{}; //!< The section of the translation
+                string_view field{}; //!< The field of the translation
+                string_view value{}; //!< The raw value of the translation
+            };
+
+        public: // +++ Static Const +++
+            static constexpr size_t DEFAULT_MAX_HITS = 100; //!< By default, the first 100 matches are returned
+
+        public: // +++ Static +++
+            static search_index fromLanguages(const vector<const language*>& languages, const indexopts_t& options = {}); //!< Indexes all translations of the given languages
+
+        public: // +++ Constructor / Destructor +++
+            search_index() = default; //!< Constructs an empty index
+            ~search_index() = default; //!< Default dtor
+
+        public: // +++ Queries +++
+            vector<searchhit_t> findSubstring(string_view needle, size_t maxHits = DEFAULT_MAX_HITS) const; //!< Finds translations containing a string
+            vector<searchhit_t> findWords(string_view words, size_t maxHits = DEFAULT_MAX_HITS) const; //!< Finds translations containing all given words
+
+        public: // +++ Getters +++
+            size_t          getDocumentCount() const { return m_documents.size(); } //!< Gets the amount of indexed translations
+            size_t          getTrigramCount() const { return m_postings.size(); } //!< Gets the amount of distinct trigrams
+            size_t          getPostingBytes() const { return m_postingData.size(); } //!< Gets the size of all encoded posting lists
+            size_t          getMemoryUsage() const; //!< Gets an estimate of the memory used by the index
+
+        private:
+            /**
+             * @brief A single indexed translation; field and value are stored in m_pool.
+             */
+            struct document_t {
+                uint32_t    language; //!< The index of the lang_id in m_langIds
+                uint32_t    section; //!< The index of the section in m_sections
+                uint64_t    fieldOffset; //!< The offset of the field in m_pool
+                uint64_t    valueOffset; //!< The offset of the value in m_pool
+                uint32_t    fieldLength; //!< The length of the field
+                uint32_t    valueLength; //!< The length of the value
+            };
+
+            /**
+             * @brief The posting list of a single trigram.
+             */
+            struct posting_t {
+                uint32_t    trigram; //!< The folded trigram; the first byte is the most significant one
+                uint32_t    count; //!< The amount of translations containing the trigram
+                uint64_t    offset; //!< The offset of the encoded list in m_postingData
+            };
+
+            using candidates_t = vector<uint32_t>;
+
+            bool            findCandidates(const vector<string>& terms, candidates_t& outCandidates) const; //!< Intersects the posting lists of all trigrams of the terms
+            const posting_t* findPosting(uint32_t trigram) const; //!< Finds the posting list of a trigram
+            string_view     getValue(uint32_t document) const; //!< Gets the value of an indexed translation
+            searchhit_t     getHit(uint32_t document) const; //!< Gets an indexed translation as a hit
+
+            template<typename Predicate>
+            vector<searchhit_t> collectHits(const vector<string>& terms, size_t maxHits, const Predicate& matches) const; //!< Verifies candidates and collects the matching translations
+
+        private:
+            vector<string>      m_langIds{}; //!< The lang_ids of all indexed languages
+            vector<string>      m_sections{}; //!< The names of all indexed sections
+            string              m_pool{}; //!< The fields and values of all indexed translations
+            vector<document_t>  m_documents{}; //!< All indexed translations, ordered by language, section and field
+            vector<posting_t>   m_postings{}; //!< All posting lists, sorted by trigram
+            vector<uint8_t>     m_postingData{}; //!< The delta-encoded posting lists
+    };
+
+}
+
+#endif // LIBBORR_INCLUDE_BORR_SEARCH_INDEX_HPP
@@ -0,0 +1,35 @@
+/**
+ * @file Commands.hpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the declarations of the subcommands of the borr CLI.
+ * @version 0.1
+ * @date 2023-02-18
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors
+ */
+
+#ifndef LIBBORR_REFERENCE_INCLUDE_COMMANDS_HPP
+#define LIBBORR_REFERENCE_INCLUDE_COMMANDS_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <borr/language.hpp>
+
+namespace borrcli {
+
+    namespace fs = std::filesystem;
+
+    using std::string;
+
+    borr::language  loadLanguage(const fs::path& path); //!< Loads a borrfile, language pack or .mo file, depending on its extension
+
+    int32_t         lookupCommand(int32_t argc, char** argv); //!< borr lookup: resolves keys read from stdin
+    int32_t         dumpCommand(int32_t argc, char** argv); //!< borr dump: exports a language as a borrfile or JSON
+    int32_t         statsCommand(int32_t argc, char** argv); //!< borr stats: prints key counts and memory usage
+    int32_t         benchCommand(int32_t argc, char** argv); //!< borr bench: times loading and lookups
+
+}
+
+#endif // LIBBORR_REFERENCE_INCLUDE_COMMANDS_HPP
@@ -0,0 +1,476 @@
+/**
+ * @file Commands.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the subcommands of the borr CLI.
+ * @version 0.1
+ * @date 2023-02-18
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <getopt.h>
+
+#include <borr/extensions.hpp>
+#include <borr/lang_pack.hpp>
+
+#include "Commands.hpp"
+
+namespace borrcli {
+
+    using std::cerr;
+    using std::cout;
+    using std::endl;
+    using std::exception;
+    using std::vector;
+
+    using borr::language;
+
+    using clock_type = std::chrono::steady_clock;
+    using keylist_t = vector<std::pair<string, string>>;
+
+    namespace {
+
+        /**
+         * @brief Gets the file argument of a command, which must be the only positional argument.
+         */
+        bool getFileArgument(int32_t argc, char** argv, fs::path& outFile) {
+            if (optind != argc - 1) {
+                cerr << "Expected exactly one file!" << endl;
+                return false;
+            }
+
+            outFile = argv[optind];
+            return true;
+        }
+
+        /**
+         * @brief Loads a language and prints an error if that fails.
+         */
+        bool tryLoadLanguage(const fs::path& path, language& outLang) {
+            try {
+                outLang = loadLanguage(path);
+                return true;
+            } catch (const exception& ex) {
+                cerr << "Failed to load " << path.string() << ": " << ex.what() << endl;
+                return false;
+            }
+        }
+
+        /**
+         * @brief Collects all keys of a language, in sorted order.
+         */
+        keylist_t getAllKeys(const language& lang) {
+            keylist_t keys{};
+            for (const auto& sectionName : lang.getSectionNames()) {
+                for (const auto& field : lang.getSection(sectionName).value_or(borr::sect_t{})) {
+                    keys.emplace_back(sectionName, field.first);
+                }
+            }
+
+            return keys;
+        }
+
+        /**
+         * @brief Formats a byte count for humans.
+         */
+        string formatBytes(size_t bytes) {
+            constexpr const char* UNITS[] = { "B", "KiB", "MiB", "GiB" };
+
+            auto value = static_cast<double>(bytes);
+            size_t unit = 0;
+            while (value >= 1024 && unit < std::size(UNITS) - 1) {
+                value /= 1024;
+                unit++;
+            }
+
+            std::stringstream formatted{};
+            formatted << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << UNITS[unit];
+            return formatted.str();
+        }
+
+        /**
+         * @brief Formats the version of a language the way borrfiles expect it; empty if the language has no version.
+         */
+        string formatVersion(const borr::ver_t& version) {
+            if (version.getMajorVersion() == string::npos) { return {}; }
+
+            return std::to_string(version.getMajorVersion()) + "." + std::to_string(version.getMinorVersion()) + "." + std::to_string(version.getRevision());
+        }
+
+        /**
+         * @brief Replaces line breaks so every translation occupies a single line of output.
+         */
+        string escapeLineBreaks(const string& value) {
+            string escaped{};
+            escaped.reserve(value.size());
+
+            for (const auto c : value) {
+                if (c == '\n') {
+                    escaped += "\\n";
+                } else {
+                    escaped += c;
+                }
+            }
+
+            return escaped;
+        }
+
+        /**
+         * @brief Gets the minimum, median and maximum of a set of durations.
+         */
+        string summarise(vector<double> milliseconds) {
+            std::sort(milliseconds.begin(), milliseconds.end());
+
+            std::stringstream summary{};
+            summary << std::fixed << std::setprecision(3)
+                    << "min " << milliseconds.front() << " ms, median " << milliseconds[milliseconds.size() / 2]
+                    << " ms, max " << milliseconds.back() << " ms";
+            return summary.str();
+        }
+
+        /**
+         * @brief Times lookups of all keys and prints the results.
+         */
+        void benchLookups(const language& lang, const keylist_t& keys, size_t rounds, bool expandVariables) {
+            size_t found = 0;
+
+            const auto startTime = clock_type::now();
+            for (size_t round = 0; round < rounds; round++) {
+                for (const auto& key : keys) {
+                    if (lang.getString(key.first, key.second, expandVariables).has_value()) { found++; }
+                }
+            }
+            const auto nanoseconds = std::chrono::duration<double, std::nano>(clock_type::now() - startTime).count();
+
+            const auto lookups = static_cast<double>(keys.size() * rounds);
+            cout << (expandVariables ? "Expanded lookups: " : "Raw lookups:      ")
+                 << std::fixed << std::setprecision(1) << nanoseconds / lookups << " ns/lookup, "
+                 << std::setprecision(0) << lookups / nanoseconds * 1e9 << " lookups/s"
+                 << " (" << found << " of " << static_cast<size_t>(lookups) << " found)" << endl;
+        }
+
+    }
+
+    /**
+     * @brief Loads a language from disk, choosing the loader by file extension.
+     *
+     * @param path The path to a borrfile, a language pack (.borrpack) or a gettext catalog (.mo).
+     *
+     * @return language The loaded language.
+     */
+    language loadLanguage(const fs::path& path) {
+        const auto entry = fs::directory_entry(path);
+
+        if (path.extension() == borr::lang_pack::FILE_EXTENSION) { return language::fromPackFile(entry); }
+        if (path.extension() == ".mo") { return language::fromMoFile(entry); }
+
+        return language::fromFile(entry);
+    }
+
+    /**
+     * @brief borr lookup: resolves keys read from stdin, one "section:field" per line.
+     *
+     * One line is written to stdout per key; missing keys produce an empty line so output lines always
+     * match input lines. Line breaks within translations are written as "\n".
+     *
+     * @return int32_t 0 if all keys were found, 2 if some were missing, 1 on errors.
+     */
+    int32_t lookupCommand(int32_t argc, char** argv) {
+        const option LONG_OPTS[] = {
+            { "help",       no_argument,    nullptr,    'h' },
+            { "keys",       no_argument,    nullptr,    'k' },
+            { "raw",        no_argument,    nullptr,    'r' },
+            { nullptr,      no_argument,    nullptr,     0  }
+        };
+
+        bool printKeys = false;
+        bool expandVariables = true;
+
+        int32_t currentOpt = 0;
+        while ((currentOpt = getopt_long(argc, argv, "hkr", LONG_OPTS, nullptr)) != -1) {
+            switch (currentOpt) {
+                case 'h':
+                    cout << "Usage: borr lookup [-k] [-r] <file> < keys.txt" << endl << endl
+                         << "Reads section:field keys from stdin, one per line, and prints their translations." << endl
+                         << "Missing keys print an empty line; the exit code is 2 if any key was missing." << endl << endl
+                         << "Arguments:" << endl
+                         << "\t--help, -h\t\tDisplays this menu and exits" << endl
+                         << "\t--keys, -k\t\tPrefix every translation with its key and a tab" << endl
+                         << "\t--raw, -r\t\tDon't expand variables" << endl;
+                    return 0;
+                case 'k': printKeys = true; break;
+                case 'r': expandVariables = false; break;
+                default: return 1;
+            }
+        }
+
+        fs::path file{};
+        language lang{};
+        if (!getFileArgument(argc, argv, file) || !tryLoadLanguage(file, lang)) { return 1; }
+
+        std::ios::sync_with_stdio(false);
+
+        size_t missing = 0;
+        string line{};
+        while (std::getline(std::cin, line)) {
+            line = borr::extensions::trim(line);
+            if (line.empty()) { continue; }
+
+            const auto separator = line.find(':');
+            const auto section = separator == string::npos ? string{} : line.substr(0, separator);
+            const auto field = separator == string::npos ? line : line.substr(separator + 1);
+
+            const auto translation = lang.getString(section, field, expandVariables);
+            if (!translation.has_value()) { missing++; }
+
+            if (printKeys) { cout << line << '\t'; }
+            cout << escapeLineBreaks(translation.value_or("")) << '\n';
+        }
+        cout.flush();
+
+        if (missing != 0) {
+            cerr << missing << " key(s) not found" << endl;
+            return 2;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief borr dump: exports a language as a borrfile or as JSON.
+     *
+     * @remarks Messages of gettext catalogs can't be enumerated by section and aren't exported.
+     *
+     * @return int32_t 0 on success, 1 on errors.
+     */
+    int32_t dumpCommand(int32_t argc, char** argv) {
+        const option LONG_OPTS[] = {
+            { "help",       no_argument,        nullptr,    'h' },
+            { "format",     required_argument,  nullptr,    'f' },
+            { nullptr,      no_argument,        nullptr,     0  }
+        };
+
+        string format = "borr";
+
+        int32_t currentOpt = 0;
+        while ((currentOpt = getopt_long(argc, argv, "hf:", LONG_OPTS, nullptr)) != -1) {
+            switch (currentOpt) {
+                case 'h':
+                    cout << "Usage: borr dump [-f borr|json] <file>" << endl << endl
+                         << "Writes all translations (unexpanded) to stdout." << endl << endl
+                         << "Arguments:" << endl
+                         << "\t--help, -h\t\tDisplays this menu and exits" << endl
+                         << "\t--format, -f<fmt>\tThe output format: borr (default) or json" << endl;
+                    return 0;
+                case 'f': format = optarg; break;
+                default: return 1;
+            }
+        }
+
+        if (format != "borr" && format != "json") {
+            cerr << "Unknown format " << format << endl;
+            return 1;
+        }
+
+        fs::path file{};
+        language lang{};
+        if (!getFileArgument(argc, argv, file) || !tryLoadLanguage(file, lang)) { return 1; }
+
+        using borr::extensions::escapeJson;
+
+        const auto version = formatVersion(lang.getLanguageVersion());
+        const auto sectionNames = lang.getSectionNames();
+
+        if (format == "json") {
+            cout << "{\n  \"lang_id\": \"" << escapeJson(lang.getLangId()) << "\",\n"
+                 << "  \"lang_ver\": \"" << escapeJson(version) << "\",\n"
+                 << "  \"lang_desc\": \"" << escapeJson(lang.getLangDescription()) << "\",\n"
+                 << "  \"sections\": {";
+
+            for (size_t i = 0; i < sectionNames.size(); i++) {
+                cout << (i == 0 ? "\n" : ",\n") << "    \"" << escapeJson(sectionNames[i]) << "\": {";
+
+                bool firstField = true;
+                for (const auto& field : lang.getSection(sectionNames[i]).value_or(borr::sect_t{})) {
+                    cout << (firstField ? "\n" : ",\n") << "      \"" << escapeJson(field.first) << "\": \"" << escapeJson(field.second) << "\"";
+                    firstField = false;
+                }
+
+                cout << "\n    }";
+            }
+
+            cout << "\n  }\n}" << endl;
+            return 0;
+        }
+
+        cout << "lang_id = \"" << lang.getLangId() << "\"" << endl;
+        if (!version.empty()) { cout << "lang_ver = \"" << version << "\"" << endl; }
+        cout << "lang_desc = \"" << lang.getLangDescription() << "\"" << endl;
+
+        for (const auto& sectionName : sectionNames) {
+            cout << endl << "[" << sectionName << "]" << endl;
+
+            for (const auto& field : lang.getSection(sectionName).value_or(borr::sect_t{})) {
+                if (field.second.find('\n') == string::npos) {
+                    cout << field.first << " = \"" << field.second << "\"" << endl;
+                    continue;
+                }
+
+                std::stringstream lines(field.second);
+                string line{};
+                while (std::getline(lines, line)) {
+                    cout << field.first << "[] = \"" << line << "\"" << endl;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief borr stats: prints key counts and memory usage.
+     *
+     * @return int32_t 0 on success, 1 on errors.
+     */
+    int32_t statsCommand(int32_t argc, char** argv) {
+        const option LONG_OPTS[] = {
+            { "help",       no_argument,    nullptr,    'h' },
+            { "json",       no_argument,    nullptr,    'j' },
+            { nullptr,      no_argument,    nullptr,     0  }
+        };
+
+        bool json = false;
+
+        int32_t currentOpt = 0;
+        while ((currentOpt = getopt_long(argc, argv, "hj", LONG_OPTS, nullptr)) != -1) {
+            switch (currentOpt) {
+                case 'h':
+                    cout << "Usage: borr stats [-j] <file>" << endl << endl
+                         << "Arguments:" << endl
+                         << "\t--help, -h\t\tDisplays this menu and exits" << endl
+                         << "\t--json, -j\t\tPrint the statistics as JSON" << endl;
+                    return 0;
+                case 'j': json = true; break;
+                default: return 1;
+            }
+        }
+
+        fs::path file{};
+        if (!getFileArgument(argc, argv, file)) { return 1; }
+
+        language lang{};
+        const auto startTime = clock_type::now();
+        if (!tryLoadLanguage(file, lang)) { return 1; }
+        const auto loadTime = std::chrono::duration<double, std::milli>(clock_type::now() - startTime).count();
+
+        std::error_code error{};
+        const auto fileSize = fs::file_size(file, error);
+        const auto stats = lang.getStats();
+
+        if (json) {
+            using borr::extensions::escapeJson;
+
+            cout << "{\"file\": \"" << escapeJson(file.string()) << "\", \"file_bytes\": " << fileSize
+                 << ", \"lang_id\": \"" << escapeJson(lang.getLangId()) << "\", \"load_ms\": " << std::fixed << std::setprecision(3) << loadTime
+                 << ", \"sections\": " << stats.sections << ", \"keys\": " << stats.keys
+                 << ", \"multiline_keys\": " << stats.multilineKeys << ", \"keys_with_variables\": " << stats.keysWithVariables
+                 << ", \"key_bytes\": " << stats.keyBytes << ", \"value_bytes\": " << stats.valueBytes
+                 << ", \"resident_bytes\": " << stats.residentBytes << ", \"hot_keys\": " << stats.hotKeys
+                 << ", \"mo_messages\": " << stats.moMessages << ", \"mo_mapped_bytes\": " << stats.moMappedBytes << "}" << endl;
+            return 0;
+        }
+
+        cout << "File:                  " << file.string() << " (" << formatBytes(fileSize) << ")" << endl
+             << "Language:              " << lang.getLangId() << " - " << lang.getLangDescription() << endl
+             << "Version:               " << formatVersion(lang.getLanguageVersion()) << endl
+             << "Load time:             " << std::fixed << std::setprecision(3) << loadTime << " ms" << endl
+             << "Sections:              " << stats.sections << endl
+             << "Keys:                  " << stats.keys << endl
+             << "  multiline:           " << stats.multilineKeys << endl
+             << "  with variables:      " << stats.keysWithVariables << endl
+             << "Key bytes:             " << formatBytes(stats.keyBytes) << endl
+             << "Value bytes:           " << formatBytes(stats.valueBytes) << endl
+             << "Resident (estimated):  " << formatBytes(stats.residentBytes) << endl;
+
+        if (stats.moMappedBytes != 0) {
+            cout << "gettext messages:      " << stats.moMessages << endl
+                 << "gettext mapped:        " << formatBytes(stats.moMappedBytes) << endl;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief borr bench: times loading a file and looking up all of its keys.
+     *
+     * @return int32_t 0 on success, 1 on errors.
+     */
+    int32_t benchCommand(int32_t argc, char** argv) {
+        const option LONG_OPTS[] = {
+            { "help",       no_argument,        nullptr,    'h' },
+            { "loads",      required_argument,  nullptr,    'n' },
+            { "rounds",     required_argument,  nullptr,    'r' },
+            { nullptr,      no_argument,        nullptr,     0  }
+        };
+
+        size_t loads = 10;
+        size_t rounds = 10;
+
+        int32_t currentOpt = 0;
+        while ((currentOpt = getopt_long(argc, argv, "hn:r:", LONG_OPTS, nullptr)) != -1) {
+            try {
+                switch (currentOpt) {
+                    case 'h':
+                        cout << "Usage: borr bench [-n loads] [-r rounds] <file>" << endl << endl
+                             << "Arguments:" << endl
+                             << "\t--help, -h\t\tDisplays this menu and exits" << endl
+                             << "\t--loads, -n<n>\t\tLoad the file n times (default: 10)" << endl
+                             << "\t--rounds, -r<n>\t\tLook up every key n times (default: 10)" << endl;
+                        return 0;
+                    case 'n': loads = std::max<size_t>(1, std::stoul(optarg)); break;
+                    case 'r': rounds = std::max<size_t>(1, std::stoul(optarg)); break;
+                    default: return 1;
+                }
+            } catch (const exception&) {
+                cerr << "Invalid number " << optarg << endl;
+                return 1;
+            }
+        }
+
+        fs::path file{};
+        if (!getFileArgument(argc, argv, file)) { return 1; }
+
+        language lang{};
+        vector<double> loadTimes{};
+        for (size_t i = 0; i < loads; i++) {
+            const auto startTime = clock_type::now();
+            if (!tryLoadLanguage(file, lang)) { return 1; }
+            loadTimes.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - startTime).count());
+        }
+
+        const auto keys = getAllKeys(lang);
+        cout << "File:             " << file.string() << " (" << keys.size() << " keys)" << endl
+             << "Load:             " << summarise(loadTimes) << " (" << loads << " loads)" << endl;
+
+        if (keys.empty()) {
+            cout << "No keys to look up." << endl;
+            return 0;
+        }
+
+        benchLookups(lang, keys, rounds, false);
+        benchLookups(lang, keys, rounds, true);
+
+        return 0;
+    }
+
+}
@@ -1,98 +1,68 @@
 /**
  * @file Main.cpp
  * @author Simon Cahill (contact@simonc.eu)
- * @brief Contains the reference implementation (usage) for libborr.
+ * @brief Contains the entry point of the borr CLI; the reference implementation (usage) for libborr.
  * @version 0.1
  * @date 2023-02-05
- * 
+ *
  * @copyright Copyright (c) 2023 Simon Cahill and Contributors
  */
 
-#include <borr/language.hpp>
-
-#include <exception>
+#include <cstdint>
 #include <iostream>
 #include <string>
 
-#include <getopt.h>
+#include "Commands.hpp"
 
 using std::cerr;
 using std::cout;
 using std::endl;
-using std::exception;
 using std::string;
 
-using borr::language;
-
-namespace fs = std::filesystem;
+/**
+ * @brief A subcommand of the CLI.
+ */
+struct command_t {
+    const char* name;
+    int32_t     (*run)(int32_t, char**);
+    const char* description;
+};
 
-const string SHORT_OPTS = R"(hl:)";
-const option LONG_OPTS[] = {
-    { "help",   no_argument,        nullptr,    'h' },
-    { "lang",   required_argument,  nullptr,    'l' },
-    { nullptr,  no_argument,        nullptr,     0  }
+const command_t COMMANDS[] = {
+    { "lookup", borrcli::lookupCommand, "Resolve section:field keys read from stdin, one per line" },
+    { "dump",   borrcli::dumpCommand,   "Export a language as a borrfile or as JSON" },
+    { "stats",  borrcli::statsCommand,  "Print key counts and memory usage" },
+    { "bench",  borrcli::benchCommand,  "Time loading and lookups" },
 };
 
 void printHelp(const string&);
 
 int main(int32_t argc, char** argv) {
-    int32_t currentOpt = 0;
-
-    string langFile{};
-
-    while ((currentOpt = getopt_long(argc, argv, SHORT_OPTS.c_str(), LONG_OPTS, nullptr)) != -1) {
-        switch (currentOpt) {
-            case 'h':
-                printHelp(argv[0]);
-                return 0;
-            case 'l':
-                if (!optarg) {
-                    cerr << "Missing lang file!" << endl;
-                    return 1;
-                }
-                langFile = optarg;
-                break;
-            default:
-                cerr << "Unknown option " << static_cast<char>(currentOpt) << endl;
-                printHelp(argv[0]);
-                return 1;
-        }
-    }
-
-    if (langFile.empty()) {
-        cerr << "No borrfile passed!" << endl;
+    if (argc < 2 || string(argv[1]) == "-h" || string(argv[1]) == "--help") {
         printHelp(argv[0]);
-        return 1;
-    }
-
-    language lang;
-    try {
-        language::fromFile(fs::directory_entry(langFile), lang);
-    } catch (const exception& ex) {
-        cerr << "Failed to parse language file: " << ex.what() << endl;
-        return 1;
+        return argc < 2 ? 1 : 0;
     }
 
-    cout << "Selected language: " << lang.getLangId() << endl
-         << "Language description: " << lang.getLangDescription() << endl
-         << "Language version: " << *lang.getLanguageVersion() << endl << endl;
-
-    auto section = lang.getSection("variables_tests").value();
-    cout << R"(Reading variables from section "variables_tests":)" << endl << endl;
-    for (const auto field : section) {
-        cout << "Found translation (" << field.first << "): " << lang.getString("variables_tests", field.first).value_or("not found") << endl;
+    for (const auto& command : COMMANDS) {
+        if (argv[1] == string(command.name)) {
+            // the subcommand sees itself as argv[0], so getopt starts at its first option
+            return command.run(argc - 1, argv + 1);
+        }
     }
-    cout << endl << endl;
 
-    cout << "Copyright and licensing information:" << endl
-         << lang.getString("normal_tests", "copyright_info").value_or("copyright info not found :c")
-         << endl << endl;
+    cerr << "Unknown command " << argv[1] << endl;
+    printHelp(argv[0]);
+    return 1;
 }
 
 void printHelp(const string& bin) {
     cout << "Usage: " << bin << " -h" << endl
-         << "Usage: " << bin << "-l<borrfile>" << endl << endl
-         << "Arguments:" << endl
-         << "\t--help, -h\t\tDisplays this menu and exits" << endl
-         << "\t--lang, -l<langfile>\tParse the langfile" << endl;
-}
\ No newline at end of file
+         << "Usage: " << bin << " <command> [options] <file>" << endl << endl
+         << "<file> may be a borrfile, a language pack compiled by borrc (.borrpack) or a gettext catalog (.mo)." << endl
+         << "Run " << bin << " <command> -h for the options of a command." << endl << endl
+         << "Commands:" << endl;
+
+    for (const auto& command : COMMANDS) {
+        cout << "\t" << command.name << "\t\t" << command.description << endl;
+    }
+}
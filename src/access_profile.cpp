@@ -0,0 +1,179 @@
+/**
+ * @file access_profile.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the access_profile class.
+ * @version 0.1
+ * @date 2023-02-12
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/access_profile.hpp"
+#include "borr/extensions.hpp"
+
+namespace borr {
+
+    using std::error_code;
+    using std::ifstream;
+    using std::ofstream;
+
+    /**
+     * @brief Loads an access profile from disk.
+     *
+     * Malformed lines are ignored; a profile only ever affects performance, never correctness.
+     *
+     * @param path The path to the profile file.
+     * @param sampleRate The sample rate used for further recording.
+     *
+     * @return access_profile The loaded profile.
+     *
+     * @throws fs::filesystem_error If the file couldn't be opened.
+     */
+    access_profile access_profile::fromFile(const fs::path& path, uint32_t sampleRate /*= DEFAULT_SAMPLE_RATE*/) {
+        ifstream inStream(path);
+        if (!inStream.is_open()) {
+            throw fs::filesystem_error("Failed to open access profile!", path, error_code(ENOENT, std::generic_category()));
+        }
+
+        access_profile profile(sampleRate);
+        string line{};
+        while (std::getline(inStream, line)) {
+            if (line.empty() || line.at(0) == '#') { continue; }
+
+            vector<string> tokens{};
+            if (!extensions::splitString(line, "\t", tokens, 3) || tokens.size() != 3) { continue; }
+
+            try {
+                profile.add(tokens[1], extensions::trimEnd(tokens[2]), std::stoull(tokens[0]));
+            } catch (const std::exception&) { continue; }
+        }
+
+        return profile;
+    }
+
+    /**
+     * @brief Constructs a new, empty access profile.
+     *
+     * @param sampleRate One in sampleRate accesses is recorded. A rate of 0 or 1 records every access.
+     */
+    access_profile::access_profile(uint32_t sampleRate /*= DEFAULT_SAMPLE_RATE*/):
+        m_sampleRate(std::max<uint32_t>(sampleRate, 1)), m_samplerId(extensions::nextSamplerId()) { }
+
+    /**
+     * @brief Copy constructor.
+     *
+     * @param other The profile to copy.
+     */
+    access_profile::access_profile(const access_profile& other): m_sampleRate(other.m_sampleRate), m_samplerId(extensions::nextSamplerId()) {
+        std::lock_guard<std::mutex> lock(other.m_countsMutex);
+        m_counts = other.m_counts;
+    }
+
+    /**
+     * @brief Records an access to a translation.
+     *
+     * Only one in getSampleRate() calls per thread is actually recorded; each profile counts its calls separately.
+     *
+     * @param section The section of the translation.
+     * @param field The field of the translation.
+     */
+    void access_profile::record(const string& section, const string& field) {
+        if (!extensions::shouldSample(m_samplerId, m_sampleRate)) { return; }
+
+        add(section, field, m_sampleRate);
+    }
+
+    /**
+     * @brief Adds a weighted access to a translation.
+     *
+     * @param section The section of the translation.
+     * @param field The field of the translation.
+     * @param count The weight of the access.
+     */
+    void access_profile::add(const string& section, const string& field, uint64_t count) {
+        std::lock_guard<std::mutex> lock(m_countsMutex);
+        m_counts[{ section, field }] += count;
+    }
+
+    /**
+     * @brief Saves this profile to disk, hottest translations first.
+     *
+     * @param path The path to save the profile to.
+     *
+     * @throws fs::filesystem_error If the file couldn't be written.
+     */
+    void access_profile::save(const fs::path& path) const {
+        const auto hottest = getHottest(SIZE_MAX);
+
+        ofstream outStream(path, std::ios::trunc);
+        if (!outStream.is_open()) {
+            throw fs::filesystem_error("Failed to write access profile!", path, error_code(EACCES, std::generic_category()));
+        }
+
+        outStream << FILE_HEADER << '\n';
+        for (const auto& key : hottest) {
+            outStream << getCount(key.first, key.second) << '\t' << key.first << '\t' << key.second << '\n';
+        }
+    }
+
+    /**
+     * @brief Gets the recorded (weighted) count of a translation.
+     *
+     * @param section The section of the translation.
+     * @param field The field of the translation.
+     *
+     * @return uint64_t The count, or 0 if the translation was never recorded.
+     */
+    uint64_t access_profile::getCount(const string& section, const string& field) const {
+        std::lock_guard<std::mutex> lock(m_countsMutex);
+
+        const auto iterPos = m_counts.find({ section, field });
+        return iterPos == m_counts.end() ? 0 : iterPos->second;
+    }
+
+    /**
+     * @brief Gets the amount of distinct translations recorded in this profile.
+     */
+    size_t access_profile::size() const {
+        std::lock_guard<std::mutex> lock(m_countsMutex);
+        return m_counts.size();
+    }
+
+    /**
+     * @brief Gets the most frequently accessed translations.
+     *
+     * @param maxKeys The maximum amount of translations to return.
+     *
+     * @return vector<keypair_t> The section/field pairs, hottest first. Ties are ordered by key.
+     */
+    vector<keypair_t> access_profile::getHottest(size_t maxKeys) const {
+        vector<pair<uint64_t, keypair_t>> sorted{};
+        {
+            std::lock_guard<std::mutex> lock(m_countsMutex);
+            sorted.reserve(m_counts.size());
+            for (const auto& count : m_counts) { sorted.emplace_back(count.second, count.first); }
+        }
+
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        vector<keypair_t> hottest{};
+        hottest.reserve(std::min(maxKeys, sorted.size()));
+        for (size_t i = 0; i < sorted.size() && i < maxKeys; i++) { hottest.push_back(std::move(sorted[i].second)); }
+
+        return hottest;
+    }
+
+}
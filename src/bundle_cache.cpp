@@ -0,0 +1,360 @@
+/**
+ * @file bundle_cache.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the bundle_cache class.
+ * @version 0.1
+ * @date 2023-03-03
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/bundle_cache.hpp"
+#include "borr/extensions.hpp"
+#include "borr/language.hpp"
+
+namespace borr {
+
+    namespace {
+
+        constexpr const char* HEX_DIGITS = "0123456789abcdef";
+
+        /**
+         * @brief Formats a 64-bit value as 16 lowercase hex digits.
+         */
+        string toHex(uint64_t value) {
+            string hex(16, '0');
+            for (size_t i = 0; i < hex.size(); i++) { hex[hex.size() - i - 1] = HEX_DIGITS[(value >> (i * 4)) & 0xf]; }
+
+            return hex;
+        }
+
+        /**
+         * @brief Appends an unsigned LEB128 varint.
+         */
+        void appendVarint(string& output, uint64_t value) {
+            do {
+                auto byte = static_cast<uint8_t>(value & 0x7f);
+                value >>= 7;
+                if (value != 0) { byte |= 0x80; }
+
+                output += static_cast<char>(byte);
+            } while (value != 0);
+        }
+
+        /**
+         * @brief Appends a varint-length-prefixed string.
+         */
+        void appendString(string& output, string_view value) {
+            appendVarint(output, value.size());
+            output.append(value);
+        }
+
+        /**
+         * @brief Reads an unsigned LEB128 varint and advances the input past it.
+         */
+        bool readVarint(string_view& input, uint64_t& outValue) {
+            outValue = 0;
+            for (size_t shift = 0; shift < 64 && !input.empty(); shift += 7) {
+                const auto byte = static_cast<uint8_t>(input.front());
+                input.remove_prefix(1);
+
+                outValue |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) { return true; }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Reads a varint-length-prefixed string and advances the input past it.
+         */
+        bool readString(string_view& input, string_view& outValue) {
+            uint64_t length = 0;
+            if (!readVarint(input, length) || length > input.size()) { return false; }
+
+            outValue = input.substr(0, length);
+            input.remove_prefix(length);
+            return true;
+        }
+
+    }
+
+    /**
+     * @brief Constructs a new, empty bundle cache.
+     *
+     * @param capacity The maximum amount of bundles which are kept. A capacity of 0 disables caching.
+     */
+    bundle_cache::bundle_cache(size_t capacity /*= DEFAULT_CAPACITY*/): m_capacity(capacity) { }
+
+    /**
+     * @brief Gets a bundle of the given sections, rendering it if it isn't cached for the language's current fingerprint.
+     *
+     * @param lang The language to render.
+     * @param sections The sections to include, in any order. An empty list includes all sections of the language.
+     * @param format The format to render the bundle in.
+     *
+     * @return bundleptr_t The bundle; it stays valid after it's evicted from the cache.
+     */
+    bundle_cache::bundleptr_t bundle_cache::get(const language& lang, const vector<string>& sections, bundleformat_t format /*= bundleformat_t::Json*/) {
+        auto normalised = normaliseSections(lang, sections);
+        bundlekey_t key{ lang.getLangId(), std::move(normalised), format };
+
+        {
+            std::shared_lock<std::shared_mutex> lock(m_bundlesMutex);
+            if (const auto cached = m_bundles.find(key); cached != m_bundles.end() && cached->second->fingerprint == lang.getFingerprint()) {
+                m_hits++;
+                return cached->second;
+            }
+        }
+
+        m_misses++;
+        const auto bundle = std::make_shared<const bundle_t>(render(lang, std::get<1>(key), format));
+        if (m_capacity == 0) { return bundle; }
+
+        std::unique_lock<std::shared_mutex> lock(m_bundlesMutex);
+        if (const auto cached = m_bundles.find(key); cached != m_bundles.end()) {
+            // replace the bundle of an older fingerprint; its place in the eviction order is kept
+            cached->second = bundle;
+            return bundle;
+        }
+
+        if (m_order.size() >= m_capacity) {
+            // evict the oldest bundle
+            m_bundles.erase(m_order.front());
+            m_order.pop_front();
+        }
+
+        m_order.push_back(key);
+        m_bundles.emplace(std::move(key), bundle);
+
+        return bundle;
+    }
+
+    /**
+     * @brief Removes all cached bundles and resets the hit and miss counters.
+     */
+    void bundle_cache::clear() {
+        std::unique_lock<std::shared_mutex> lock(m_bundlesMutex);
+
+        m_bundles.clear();
+        m_order.clear();
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    /**
+     * @brief Gets the amount of cached bundles.
+     */
+    size_t bundle_cache::size() const {
+        std::shared_lock<std::shared_mutex> lock(m_bundlesMutex);
+        return m_bundles.size();
+    }
+
+    /**
+     * @brief Renders a bundle of the given sections without caching it.
+     *
+     * Sections are written in sorted order, each with its fields in sorted order; sections which don't exist are left out.
+     *
+     * The binary format consists of the magic bytes BINARY_MAGIC, a version byte, the fingerprint as 8 little endian bytes,
+     * the language ID and the amount of sections, followed by each section's name, the amount of fields and each field and value.
+     * All amounts are unsigned LEB128 varints; all strings are prefixed by their length as a varint.
+     *
+     * @param lang The language to render.
+     * @param sections The sections to include, in any order. An empty list includes all sections of the language.
+     * @param format The format to render the bundle in.
+     *
+     * @return bundle_t The bundle.
+     */
+    bundle_t bundle_cache::render(const language& lang, const vector<string>& sections, bundleformat_t format /*= bundleformat_t::Json*/) {
+        const auto names = normaliseSections(lang, sections);
+
+        bundle_t bundle{};
+        bundle.fingerprint = lang.getFingerprint();
+
+        auto& body = bundle.body;
+        if (format == bundleformat_t::Json) {
+            bundle.contentType = JSON_CONTENT_TYPE;
+
+            body += R"({"lang_id":")" + extensions::escapeJson(lang.getLangId()) + R"(","fingerprint":")" + toHex(bundle.fingerprint) + R"(","sections":{)";
+
+            bool firstSection = true;
+            for (const auto& name : names) {
+                const auto sectionStart = body.size();
+                body += firstSection ? "\"" : ",\"";
+                body += extensions::escapeJson(name) + "\":{";
+
+                bool firstField = true;
+                const auto found = lang.getSectionExpanded(name, [&](const string& field, string_view value) {
+                    body += firstField ? "\"" : ",\"";
+                    body += extensions::escapeJson(field) + "\":\"" + extensions::escapeJson(value) + '"';
+                    firstField = false;
+                });
+
+                if (!found) {
+                    body.resize(sectionStart);
+                    continue;
+                }
+
+                body += '}';
+                firstSection = false;
+            }
+
+            body += "}}";
+            bundle.etag = getETag(body);
+
+            return bundle;
+        }
+
+        bundle.contentType = BINARY_CONTENT_TYPE;
+        body.append(BINARY_MAGIC);
+        body += static_cast<char>(BINARY_VERSION);
+        for (size_t i = 0; i < sizeof(uint64_t); i++) { body += static_cast<char>((bundle.fingerprint >> (i * 8)) & 0xff); }
+        appendString(body, lang.getLangId());
+
+        string sectionBody{};
+        vector<string> encodedSections{};
+        for (const auto& name : names) {
+            sectionBody.clear();
+
+            size_t fields = 0;
+            const auto found = lang.getSectionExpanded(name, [&](const string& field, string_view value) {
+                appendString(sectionBody, field);
+                appendString(sectionBody, value);
+                fields++;
+            });
+            if (!found) { continue; }
+
+            // the amount of fields precedes them, so sections are encoded separately first
+            string encoded{};
+            appendString(encoded, name);
+            appendVarint(encoded, fields);
+            encoded += sectionBody;
+            encodedSections.push_back(std::move(encoded));
+        }
+
+        appendVarint(body, encodedSections.size());
+        for (const auto& encoded : encodedSections) { body += encoded; }
+        bundle.etag = getETag(body);
+
+        return bundle;
+    }
+
+    /**
+     * @brief Gets the strong entity tag of a bundle.
+     *
+     * The tag is a hash of the rendered body, so it changes whenever the expanded values do (e.g. the output of an
+     * expansion callback), even if the fingerprint of the language doesn't. It's identical for every process serving the same body.
+     *
+     * @param body The rendered body of the bundle.
+     *
+     * @return string The quoted entity tag.
+     */
+    string bundle_cache::getETag(string_view body) {
+        return '"' + toHex(extensions::fnv1a(body)) + '"';
+    }
+
+    /**
+     * @brief Determines whether a client's cached copy of a bundle is still valid, i.e. whether a 304 may be sent.
+     *
+     * Implements the weak comparison required for If-None-Match (RFC 9110): the header may contain a list of tags,
+     * any of which may be weak, or "*".
+     *
+     * @param ifNoneMatch The value of the If-None-Match header. An empty value never matches.
+     * @param etag The entity tag of the current bundle.
+     *
+     * @return true If the client's copy matches the current bundle.
+     * @return false Otherwise.
+     */
+    bool bundle_cache::matchesIfNoneMatch(string_view ifNoneMatch, string_view etag) {
+        const auto stripWeak = [](string_view tag) {
+            if (tag.substr(0, 2) == "W/") { tag.remove_prefix(2); }
+            return tag;
+        };
+
+        etag = stripWeak(etag);
+        while (!ifNoneMatch.empty()) {
+            const auto separator = ifNoneMatch.find(',');
+            auto tag = ifNoneMatch.substr(0, separator);
+            ifNoneMatch.remove_prefix(separator == string_view::npos ? ifNoneMatch.size() : separator + 1);
+
+            const auto first = tag.find_first_not_of(" \t");
+            if (first == string_view::npos) { continue; }
+            tag = tag.substr(first, tag.find_last_not_of(" \t") - first + 1);
+
+            if (tag == "*" || stripWeak(tag) == etag) { return true; }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Decodes a binary bundle, e.g. to verify it or to read it in a native client.
+     *
+     * @param body The bundle.
+     * @param outFingerprint Receives the fingerprint of the language the bundle was rendered from.
+     * @param visitor Receives every translation, in the order it was written.
+     *
+     * @return true If the bundle was decoded completely.
+     * @return false If the bundle is truncated, has a different version or isn't a bundle at all.
+     */
+    bool bundle_cache::visitBinary(string_view body, uint64_t& outFingerprint, const bundlevisitor_t& visitor) {
+        constexpr auto HEADER_SIZE = BINARY_MAGIC.size() + 1 + sizeof(uint64_t);
+        if (body.size() < HEADER_SIZE || body.substr(0, BINARY_MAGIC.size()) != BINARY_MAGIC || static_cast<uint8_t>(body[BINARY_MAGIC.size()]) != BINARY_VERSION) { return false; }
+
+        outFingerprint = 0;
+        for (size_t i = 0; i < sizeof(uint64_t); i++) {
+            outFingerprint |= static_cast<uint64_t>(static_cast<uint8_t>(body[BINARY_MAGIC.size() + 1 + i])) << (i * 8);
+        }
+        body.remove_prefix(HEADER_SIZE);
+
+        string_view langId{};
+        uint64_t sectionCount = 0;
+        if (!readString(body, langId) || !readVarint(body, sectionCount)) { return false; }
+
+        for (uint64_t i = 0; i < sectionCount; i++) {
+            string_view section{};
+            uint64_t fieldCount = 0;
+            if (!readString(body, section) || !readVarint(body, fieldCount)) { return false; }
+
+            for (uint64_t j = 0; j < fieldCount; j++) {
+                string_view field{};
+                string_view value{};
+                if (!readString(body, field) || !readString(body, value)) { return false; }
+
+                visitor(section, field, value);
+            }
+        }
+
+        return body.empty();
+    }
+
+    /**
+     * @brief Sorts the requested sections and removes duplicates, so equal sets share a cache entry and an entity tag.
+     *
+     * @param lang The language; all of its sections are used if none are requested.
+     * @param sections The requested sections.
+     *
+     * @return vector<string> The sorted, unique sections.
+     */
+    vector<string> bundle_cache::normaliseSections(const language& lang, const vector<string>& sections) {
+        auto names = sections.empty() ? lang.getSectionNames() : sections;
+
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        return names;
+    }
+
+}
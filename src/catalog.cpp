@@ -0,0 +1,369 @@
+/**
+ * @file catalog.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the catalog class.
+ * @version 0.1
+ * @date 2023-02-23
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <string>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/catalog.hpp"
+#include "borr/extensions.hpp"
+
+namespace borr {
+
+    namespace {
+
+        bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+        string_view trimView(string_view str) {
+            while (!str.empty() && isSpace(str.front())) { str.remove_prefix(1); }
+            while (!str.empty() && isSpace(str.back())) { str.remove_suffix(1); }
+
+            return str;
+        }
+
+        /**
+         * @brief Parses a quality value: "0", "0.5", "1.000" and so on. Anything else is rejected.
+         */
+        bool parseQuality(string_view value, double& outQuality) {
+            if (value.empty() || (value[0] != '0' && value[0] != '1')) { return false; }
+
+            double quality = value[0] - '0';
+            if (value.size() > 1) {
+                if (value[1] != '.' || value.size() > 5) { return false; }
+
+                double scale = 0.1;
+                for (size_t i = 2; i < value.size(); i++) {
+                    if (!std::isdigit(static_cast<unsigned char>(value[i]))) { return false; }
+
+                    quality += (value[i] - '0') * scale;
+                    scale /= 10;
+                }
+            }
+
+            if (quality > 1.0) { return false; }
+
+            outQuality = quality;
+            return true;
+        }
+
+        /**
+         * @brief Gets the primary subtag of a canonical tag ("en" for "en-gb").
+         */
+        string_view primarySubtag(string_view tag) { return tag.substr(0, tag.find('-')); }
+
+    }
+
+    /**
+     * @brief Gets the canonical form of a language tag or lang_id.
+     *
+     * The canonical form is lower case and uses hyphens as separators; a POSIX encoding or modifier
+     * (".UTF-8", "@euro") is removed. "en_GB", "EN-gb" and "en_GB.UTF-8" are all canonicalised to "en-gb".
+     *
+     * @param tag The tag to canonicalise.
+     *
+     * @return string The canonical tag.
+     */
+    string catalog::canonicaliseTag(string_view tag) {
+        tag = trimView(tag);
+        tag = tag.substr(0, tag.find_first_of(".@"));
+
+        string canonical{};
+        canonical.reserve(tag.size());
+        for (const auto c : tag) {
+            canonical += c == '_' ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+
+        return canonical;
+    }
+
+    /**
+     * @brief Parses an Accept-Language header.
+     *
+     * Malformed ranges (e.g. with an invalid quality value) are skipped, as are ranges beyond MAX_LANGUAGE_RANGES.
+     *
+     * @param header The value of the header, e.g. "de-CH, de;q=0.9, en;q=0.5, *;q=0.1".
+     *
+     * @return vector<langrange_t> The ranges with canonical tags, sorted by descending quality; ranges of equal quality keep their order.
+     */
+    vector<langrange_t> catalog::parseAcceptLanguage(string_view header) {
+        vector<langrange_t> ranges{};
+
+        while (!header.empty() && ranges.size() < MAX_LANGUAGE_RANGES) {
+            const auto end = header.find(',');
+            auto item = header.substr(0, end);
+            header = end == string_view::npos ? string_view{} : header.substr(end + 1);
+
+            langrange_t range{};
+            const auto paramsPos = item.find(';');
+            range.tag = canonicaliseTag(item.substr(0, paramsPos));
+            if (range.tag.empty()) { continue; }
+
+            bool valid = true;
+            auto params = paramsPos == string_view::npos ? string_view{} : item.substr(paramsPos + 1);
+            while (valid && !params.empty()) {
+                const auto paramEnd = params.find(';');
+                const auto param = trimView(params.substr(0, paramEnd));
+                params = paramEnd == string_view::npos ? string_view{} : params.substr(paramEnd + 1);
+
+                if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                    valid = parseQuality(trimView(param.substr(2)), range.quality);
+                }
+            }
+
+            if (valid) { ranges.push_back(std::move(range)); }
+        }
+
+        std::stable_sort(ranges.begin(), ranges.end(), [](const langrange_t& a, const langrange_t& b) { return a.quality > b.quality; });
+        return ranges;
+    }
+
+    /**
+     * @brief Constructs an empty catalog.
+     *
+     * @param cacheCapacity The maximum amount of headers whose negotiation result is cached; 0 disables caching.
+     */
+    catalog::catalog(size_t cacheCapacity /*= DEFAULT_CACHE_CAPACITY*/):
+        m_shardCapacity((cacheCapacity + CACHE_SHARDS - 1) / CACHE_SHARDS) { }
+
+    /**
+     * @brief Adds a language to the catalog.
+     *
+     * A language with the same canonical lang_id is replaced (and, if it was the default language, the new language becomes the default).
+     * The negotiation cache is cleared.
+     *
+     * @param lang The language to add.
+     *
+     * @return const language& The language, as stored in the catalog.
+     */
+    const language& catalog::addLanguage(language lang) {
+        auto canonicalId = canonicaliseTag(lang.getLangId());
+        auto& slot = m_languages[canonicalId];
+
+        const auto wasDefault = slot && m_defaultLanguage == slot.get();
+        slot = std::make_unique<language>(std::move(lang));
+        if (wasDefault) { m_defaultLanguage = slot.get(); }
+
+        clearCache();
+        clearSearchIndex();
+        return *slot;
+    }
+
+    /**
+     * @brief Removes a language from the catalog.
+     *
+     * @param langId The lang_id of the language, in any form.
+     *
+     * @return true If the language was part of the catalog.
+     */
+    bool catalog::removeLanguage(string_view langId) {
+        const auto langPos = m_languages.find(canonicaliseTag(langId));
+        if (langPos == m_languages.end()) { return false; }
+
+        if (m_defaultLanguage == langPos->second.get()) { m_defaultLanguage = nullptr; }
+        m_languages.erase(langPos);
+
+        clearCache();
+        clearSearchIndex();
+        return true;
+    }
+
+    /**
+     * @brief Sets the language which is returned when negotiation finds no match; it must be part of the catalog.
+     *
+     * @param langId The lang_id of the language, in any form. An unknown lang_id removes the default language.
+     */
+    void catalog::setDefaultLanguage(string_view langId) {
+        m_defaultLanguage = getLanguage(langId);
+        clearCache();
+    }
+
+    /**
+     * @brief Gets a language by its lang_id.
+     *
+     * @param langId The lang_id, in any form.
+     *
+     * @return const language* The language, or nullptr if it isn't part of the catalog.
+     */
+    const language* catalog::getLanguage(string_view langId) const {
+        const auto langPos = m_languages.find(canonicaliseTag(langId));
+        return langPos == m_languages.end() ? nullptr : langPos->second.get();
+    }
+
+    /**
+     * @brief Gets all languages of the catalog.
+     *
+     * @return vector<const language*> The languages, sorted by canonical lang_id.
+     */
+    vector<const language*> catalog::getLanguages() const {
+        vector<const language*> languages{};
+        languages.reserve(m_languages.size());
+
+        for (const auto& lang : m_languages) { languages.push_back(lang.second.get()); }
+
+        return languages;
+    }
+
+    /**
+     * @brief Chooses the best language of the catalog for an Accept-Language header.
+     *
+     * See the class documentation for the matching rules. The result is cached per raw header,
+     * so byte-identical headers are only parsed once (until the cache evicts them).
+     *
+     * @param acceptLanguage The value of the Accept-Language header.
+     *
+     * @return const language* The chosen language; the default language if nothing matches, or nullptr if there is none.
+     */
+    const language* catalog::negotiate(string_view acceptLanguage) const {
+        if (m_shardCapacity == 0 || acceptLanguage.size() > MAX_CACHED_HEADER_LENGTH) { return negotiateUncached(acceptLanguage); }
+
+        const auto hash = extensions::fnv1a(acceptLanguage);
+        auto& shard = m_cache[hash % CACHE_SHARDS];
+
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            const auto range = shard.entries.equal_range(hash);
+            for (auto entry = range.first; entry != range.second; entry++) {
+                if (entry->second.first == acceptLanguage) { return entry->second.second; }
+            }
+        }
+
+        const auto result = negotiateUncached(acceptLanguage);
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        const auto range = shard.entries.equal_range(hash);
+        const auto cached = std::any_of(range.first, range.second, [&](const auto& entry) { return entry.second.first == acceptLanguage; });
+        if (!cached) {
+            if (shard.order.size() >= m_shardCapacity) {
+                // evict the oldest header of this shard
+                const auto oldest = shard.entries.find(shard.order.front());
+                if (oldest != shard.entries.end()) { shard.entries.erase(oldest); }
+                shard.order.pop_front();
+            }
+
+            shard.entries.emplace(hash, std::make_pair(string(acceptLanguage), result));
+            shard.order.push_back(hash);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Gets the amount of headers in the negotiation cache.
+     */
+    size_t catalog::getCachedHeaderCount() const {
+        size_t count = 0;
+        for (const auto& shard : m_cache) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Negotiates a language without consulting the cache.
+     */
+    const language* catalog::negotiateUncached(string_view acceptLanguage) const {
+        const auto ranges = parseAcceptLanguage(acceptLanguage);
+        // "en;q=0" excludes "en" as well as "en-gb"
+        const auto isExcluded = [&](string_view tag) {
+            return std::any_of(ranges.begin(), ranges.end(), [&](const langrange_t& range) {
+                return range.quality == 0 && tag.substr(0, range.tag.size()) == range.tag && (tag.size() == range.tag.size() || tag[range.tag.size()] == '-');
+            });
+        };
+
+        // exact matches, then more general languages
+        for (const auto& range : ranges) {
+            if (range.quality == 0 || range.tag == "*") { continue; }
+
+            for (string_view tag = range.tag; !tag.empty(); ) {
+                if (const auto langPos = m_languages.find(tag); langPos != m_languages.end() && !isExcluded(tag)) { return langPos->second.get(); }
+
+                const auto separator = tag.rfind('-');
+                tag = separator == string_view::npos ? string_view{} : tag.substr(0, separator);
+                // a single-character subtag (such as an extension singleton) is removed with the subtag it introduces
+                if (const auto last = tag.rfind('-'); last != string_view::npos && tag.size() - last == 2) { tag = tag.substr(0, last); }
+            }
+        }
+
+        // languages sharing the primary subtag; the default language is preferred
+        for (const auto& range : ranges) {
+            if (range.quality == 0 || range.tag == "*") { continue; }
+
+            const auto primary = primarySubtag(range.tag);
+            if (m_defaultLanguage != nullptr) {
+                const auto defaultTag = canonicaliseTag(m_defaultLanguage->getLangId());
+                if (primarySubtag(defaultTag) == primary && !isExcluded(defaultTag)) { return m_defaultLanguage; }
+            }
+
+            for (const auto& lang : m_languages) {
+                if (primarySubtag(lang.first) == primary && !isExcluded(lang.first)) { return lang.second.get(); }
+            }
+        }
+
+        if (m_defaultLanguage != nullptr && !isExcluded(canonicaliseTag(m_defaultLanguage->getLangId()))) { return m_defaultLanguage; }
+
+        // a wildcard accepts any language which wasn't excluded
+        if (std::any_of(ranges.begin(), ranges.end(), [](const langrange_t& range) { return range.tag == "*" && range.quality > 0; })) {
+            for (const auto& lang : m_languages) {
+                if (!isExcluded(lang.first)) { return lang.second.get(); }
+            }
+        }
+
+        return m_defaultLanguage;
+    }
+
+    /**
+     * @brief Gets the full-text index of the translations of all languages, building it on first use.
+     *
+     * Build the index right after loading all languages to avoid building it while serving the first query.
+     * Concurrent callers wait for the index to be built once.
+     * The index is built again once a language is added or removed; indexes returned earlier stay valid
+     * for as long as they are held, but aren't updated.
+     *
+     * @param options Controls how the index is built, if it has to be.
+     *
+     * @return std::shared_ptr<const search_index> The index.
+     */
+    std::shared_ptr<const search_index> catalog::getSearchIndex(const indexopts_t& options /*= {}*/) const {
+        std::lock_guard<std::mutex> lock(m_searchIndexMutex);
+        if (!m_searchIndex) { m_searchIndex = std::make_shared<const search_index>(search_index::fromLanguages(getLanguages(), options)); }
+
+        return m_searchIndex;
+    }
+
+    /**
+     * @brief Drops the search index, so its memory is released once no caller holds it; called whenever a language is added or removed.
+     */
+    void catalog::clearSearchIndex() {
+        std::lock_guard<std::mutex> lock(m_searchIndexMutex);
+        m_searchIndex.reset();
+    }
+
+    /**
+     * @brief Clears the negotiation cache; called whenever the languages change.
+     */
+    void catalog::clearCache() {
+        for (auto& shard : m_cache) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.order.clear();
+        }
+    }
+
+}
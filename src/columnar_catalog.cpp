@@ -0,0 +1,240 @@
+/**
+ * @file columnar_catalog.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the columnar_catalog class.
+ * @version 0.1
+ * @date 2023-02-24
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <stdexcept>
+#include <string>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/catalog.hpp"
+#include "borr/columnar_catalog.hpp"
+#include "borr/extensions.hpp"
+#include "borr/language.hpp"
+
+namespace borr {
+
+    /**
+     * @brief Constructs a columnar catalog containing all languages of a catalog, in order of their canonical lang_id.
+     *
+     * @param languages The catalog to copy.
+     */
+    columnar_catalog::columnar_catalog(const catalog& languages) {
+        for (const auto lang : languages.getLanguages()) { addLanguage(*lang); }
+    }
+
+    /**
+     * @brief Adds the raw translations of a language as a new column.
+     *
+     * Keys the catalog doesn't know yet are added to the key dictionary; other columns are missing them.
+     * If a language with the same canonical lang_id was added before, its column is replaced.
+     *
+     * @param lang The language to add.
+     *
+     * @return size_t The column (locale index) of the language.
+     *
+     * @throws runtime_error If the values of the language exceed 4 GiB.
+     */
+    size_t columnar_catalog::addLanguage(const language& lang) {
+        column_t column{};
+        column.langId = lang.getLangId();
+        column.canonicalId = catalog::canonicaliseTag(column.langId);
+        column.cells.resize(m_keys.size());
+
+        // the key count is computed once per load, so this doesn't walk the language
+        if (const auto keyCount = lang.getStats().keys; keyCount > m_keys.size()) {
+            m_keys.reserve(keyCount);
+            m_keyIds.reserve(keyCount);
+            column.cells.reserve(keyCount);
+        }
+
+        lang.visitTranslations([&](const string& section, const string& field, const entry_t& entry) {
+            const auto& value = entry.value;
+            if (column.pool.size() + value.size() >= MISSING) {
+                throw std::runtime_error("Translations of a single language exceed the size of a column!");
+            }
+
+            const auto keyId = internKey(section, field);
+            if (keyId >= column.cells.size()) { column.cells.resize(keyId + 1); }
+
+            column.cells[keyId] = { static_cast<uint32_t>(column.pool.size()), static_cast<uint32_t>(value.size()) };
+            column.pool += value;
+        });
+
+        // every column has a cell for every key
+        for (auto& other : m_columns) { other.cells.resize(m_keys.size()); }
+        column.cells.resize(m_keys.size());
+        column.pool.shrink_to_fit();
+
+        const auto existing = getLocaleIndex(column.canonicalId);
+        if (existing != INVALID_LOCALE) {
+            m_columns[existing] = std::move(column);
+            return existing;
+        }
+
+        m_columns.push_back(std::move(column));
+        return m_columns.size() - 1;
+    }
+
+    /**
+     * @brief Gets the ID of a key.
+     *
+     * @param section The section of the key.
+     * @param field The field of the key.
+     *
+     * @return keyid_t The key ID, or INVALID_KEY if no language has the key.
+     */
+    keyid_t columnar_catalog::getKeyId(string_view section, string_view field) const {
+        const auto range = m_keyIds.equal_range(hashKey(section, field));
+        for (auto candidate = range.first; candidate != range.second; candidate++) {
+            const auto& name = m_keys[candidate->second];
+            if (name.first == section && name.second == field) { return candidate->second; }
+        }
+
+        return INVALID_KEY;
+    }
+
+    /**
+     * @brief Gets the column of a language.
+     *
+     * @param langId The lang_id of the language, in any form.
+     *
+     * @return size_t The column, or INVALID_LOCALE if the language wasn't added.
+     */
+    size_t columnar_catalog::getLocaleIndex(string_view langId) const {
+        const auto canonicalId = catalog::canonicaliseTag(langId);
+        for (size_t i = 0; i < m_columns.size(); i++) {
+            if (m_columns[i].canonicalId == canonicalId) { return i; }
+        }
+
+        return INVALID_LOCALE;
+    }
+
+    /**
+     * @brief Gets the raw (unexpanded) value of a key in a single locale.
+     *
+     * @param keyId The ID of the key.
+     * @param locale The column of the locale.
+     *
+     * @return optional<string_view> The value, or nullopt if the locale lacks the key. The value is valid as long as the column.
+     */
+    optional<string_view> columnar_catalog::getValue(keyid_t keyId, size_t locale) const {
+        const auto cell = getCell(keyId, locale);
+        if (cell == nullptr) { return std::nullopt; }
+
+        return string_view(m_columns[locale].pool).substr(cell->offset, cell->length);
+    }
+
+    /**
+     * @brief Gets the raw value of a key from the first locale of a fallback chain which has it.
+     *
+     * @param keyId The ID of the key.
+     * @param fallbackChain The columns to try, in order, e.g. { de_CH, de_DE, en_GB }.
+     *
+     * @return optional<string_view> The value, or nullopt if no locale of the chain has the key.
+     */
+    optional<string_view> columnar_catalog::getValue(keyid_t keyId, const vector<size_t>& fallbackChain) const {
+        for (const auto locale : fallbackChain) {
+            if (const auto value = getValue(keyId, locale)) { return value; }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Gets the raw value of a key in every locale.
+     *
+     * @param keyId The ID of the key.
+     *
+     * @return vector<optional<string_view>> One value per column; empty for unknown keys.
+     */
+    vector<optional<string_view>> columnar_catalog::getAllValues(keyid_t keyId) const {
+        if (keyId >= m_keys.size()) { return {}; }
+
+        vector<optional<string_view>> values{};
+        values.reserve(m_columns.size());
+        for (size_t i = 0; i < m_columns.size(); i++) { values.push_back(getValue(keyId, i)); }
+
+        return values;
+    }
+
+    /**
+     * @brief Gets the locales which lack a key.
+     *
+     * @param keyId The ID of the key.
+     *
+     * @return vector<size_t> The columns which lack the key; all columns for unknown keys.
+     */
+    vector<size_t> columnar_catalog::getMissingLocales(keyid_t keyId) const {
+        vector<size_t> missing{};
+        for (size_t i = 0; i < m_columns.size(); i++) {
+            if (getCell(keyId, i) == nullptr) { missing.push_back(i); }
+        }
+
+        return missing;
+    }
+
+    /**
+     * @brief Gets the keys of the key dictionary which a locale lacks.
+     *
+     * @param locale The column of the locale.
+     *
+     * @return vector<keyid_t> The missing keys, in ascending order; empty for unknown locales.
+     */
+    vector<keyid_t> columnar_catalog::getMissingKeys(size_t locale) const {
+        if (locale >= m_columns.size()) { return {}; }
+
+        vector<keyid_t> missing{};
+        const auto& cells = m_columns[locale].cells;
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (cells[i].length == MISSING) { missing.push_back(static_cast<keyid_t>(i)); }
+        }
+
+        return missing;
+    }
+
+    /**
+     * @brief Hashes a key the same way as the hot index.
+     */
+    uint64_t columnar_catalog::hashKey(string_view section, string_view field) {
+        return extensions::fnv1a(field, extensions::fnv1a(section));
+    }
+
+    /**
+     * @brief Gets the ID of a key, adding it to the key dictionary if necessary.
+     */
+    keyid_t columnar_catalog::internKey(string_view section, string_view field) {
+        const auto keyId = getKeyId(section, field);
+        if (keyId != INVALID_KEY) { return keyId; }
+
+        if (m_keys.size() >= INVALID_KEY) { throw std::runtime_error("Too many keys for a columnar catalog!"); }
+
+        const auto newKeyId = static_cast<keyid_t>(m_keys.size());
+        m_keys.emplace_back(string(section), string(field));
+        m_keyIds.emplace(hashKey(section, field), newKeyId);
+
+        return newKeyId;
+    }
+
+    /**
+     * @brief Gets a cell; nullptr if the key or locale is unknown, or the locale lacks the key.
+     */
+    const columnar_catalog::cell_t* columnar_catalog::getCell(keyid_t keyId, size_t locale) const {
+        if (locale >= m_columns.size() || keyId >= m_columns[locale].cells.size()) { return nullptr; }
+
+        const auto& cell = m_columns[locale].cells[keyId];
+        return cell.length == MISSING ? nullptr : &cell;
+    }
+
+}
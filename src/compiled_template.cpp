@@ -0,0 +1,156 @@
+/**
+ * @file compiled_template.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the compiled_template class.
+ * @version 0.1
+ * @date 2023-02-10
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/compiled_template.hpp"
+
+namespace borr {
+
+    namespace {
+
+        constexpr bool isAlphaChar(char c) { return c >= 'A' && c <= 'z'; } //!< Mirrors [A-z_] from the variable regex
+        constexpr bool isAlnumChar(char c) { return isAlphaChar(c) || (c >= '0' && c <= '9'); } //!< Mirrors [A-z0-9_]
+        constexpr bool isNameChar(char c) { return isAlnumChar(c) || c == ':'; }
+
+    }
+
+    /**
+     * @brief Compiles a translation into a template.
+     *
+     * Translations without variables result in a template without segments; the source can be used as-is.
+     * All variables are initially dynamic, until the template is bound.
+     *
+     * @param source The translation to compile.
+     *
+     * @return compiled_template The compiled (but unbound) template.
+     */
+    compiled_template compiled_template::compile(const string& source) {
+        compiled_template tmpl{};
+        tmpl.m_compiled = true;
+
+        size_t nameLength = 0;
+        size_t lastPos = 0;
+        for (auto varPos = findVariable(source, 0, nameLength); varPos != string::npos; varPos = findVariable(source, lastPos, nameLength)) {
+            if (varPos > lastPos) {
+                tmpl.m_segments.push_back({ segkind_t::Literal, lastPos, varPos - lastPos });
+            }
+
+            segment_t variable{ segkind_t::Dynamic, varPos + 2, nameLength };
+            // only the name is searched, so many variables without a ':' don't make compilation quadratic
+            variable.separator = string_view(source).substr(variable.offset, nameLength).find(':');
+
+            tmpl.m_segments.push_back(variable);
+            lastPos = varPos + nameLength + 3; // ${ + name + }
+        }
+
+        tmpl.m_hasVariables = !tmpl.m_segments.empty();
+        if (tmpl.m_hasVariables && lastPos < source.size()) {
+            tmpl.m_segments.push_back({ segkind_t::Literal, lastPos, source.size() - lastPos });
+        }
+
+        return tmpl;
+    }
+
+    /**
+     * @brief Determines whether or not a given string is a valid variable name.
+     *
+     * This matches the same names as @c language::VARIABLE_REGEX , but without backtracking.
+     * A name is either a plain name (${my_var}) or a reference to a different translation (${section:field}).
+     *
+     * @param name The name to check, without the surrounding ${}.
+     *
+     * @return true If the name is a valid variable name.
+     * @return false Otherwise.
+     */
+    bool compiled_template::isVariableName(string_view name) {
+        const auto isAlnumTail = [](string_view str) { return std::all_of(str.begin(), str.end(), isAlnumChar); };
+
+        const auto separator = name.find(':');
+        if (separator == string_view::npos) {
+            return name.size() >= 4 && isAlphaChar(name[0]) && isAlphaChar(name[1]) && isAlphaChar(name[2]) && isAlnumTail(name.substr(3));
+        }
+
+        const auto section = name.substr(0, separator);
+        const auto field = name.substr(separator + 1);
+
+        return section.size() >= 2 && std::all_of(section.begin(), section.end(), isAlphaChar) &&
+               field.size() >= 2 && isAlphaChar(field[0]) && isAlnumTail(field.substr(1));
+    }
+
+    /**
+     * @brief Finds the next variable in a given string.
+     *
+     * The search is linear in the length of the string.
+     *
+     * @param source The string to search.
+     * @param startPos The position from which to start searching.
+     * @param outNameLength Out parameter containing the length of the variable's name.
+     *
+     * @return size_t The position of the variable's '$', or string::npos if no further variable exists.
+     */
+    size_t compiled_template::findVariable(string_view source, size_t startPos, size_t& outNameLength) {
+        auto varPos = source.find("${", startPos);
+
+        while (varPos != string_view::npos) {
+            const auto nameStart = varPos + 2;
+            auto nameEnd = nameStart;
+            while (nameEnd < source.size() && isNameChar(source[nameEnd])) { nameEnd++; }
+
+            if (nameEnd < source.size() && source[nameEnd] == '}' && isVariableName(source.substr(nameStart, nameEnd - nameStart))) {
+                outNameLength = nameEnd - nameStart;
+                return varPos;
+            }
+
+            // name characters can never start a new variable, so skip them entirely
+            varPos = source.find("${", std::max(nameEnd, varPos + 1));
+        }
+
+        return string::npos;
+    }
+
+    /**
+     * @brief Binds all variables in this template.
+     *
+     * Variables registered with the registry are bound to their slot.
+     * Other variables containing a ':' are references to other translations.
+     * All remaining variables are either dynamic (the registry may still change) or empty (the registry is frozen).
+     *
+     * @param source The translation this template was compiled from.
+     * @param registry The registry to bind against.
+     */
+    void compiled_template::bind(const string& source, const expander_registry& registry) {
+        for (auto& segment : m_segments) {
+            if (segment.kind == segkind_t::Literal) { continue; }
+
+            segment.target = nullptr;
+            segment.slot = registry.find(string_view(source).substr(segment.offset, segment.length));
+            if (segment.slot != expander_registry::NPOS) {
+                segment.kind = segkind_t::Expander;
+            } else if (segment.separator != string::npos) {
+                segment.kind = segkind_t::Reference;
+            } else {
+                segment.kind = registry.isFrozen() ? segkind_t::Empty : segkind_t::Dynamic;
+            }
+        }
+
+        m_bound = true;
+    }
+
+}
@@ -0,0 +1,257 @@
+/**
+ * @file consistency.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the consistency checks.
+ * @version 0.1
+ * @date 2023-02-25
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/consistency.hpp"
+#include "borr/extensions.hpp"
+#include "borr/language.hpp"
+
+namespace borr::consistency {
+
+    namespace {
+
+        /**
+         * @brief What is compared of a single translation.
+         */
+        struct keyinfo_t {
+            keyname_t       key{}; //!< The translation
+            vector<string>  variables{}; //!< The sorted, unique variable names
+            size_t          lines{1}; //!< The amount of lines
+        };
+
+        /**
+         * @brief Gets the sorted, unique variable names (including references) of a translation.
+         */
+        vector<string> getVariables(const entry_t& entry) {
+            using segkind_t = compiled_template::segkind_t;
+
+            // templates are compiled on load; this only happens for entries which were never compiled
+            const auto compiled = entry.compiled.isCompiled() ? compiled_template{} : compiled_template::compile(entry.value);
+            const auto& segments = entry.compiled.isCompiled() ? entry.compiled.getSegments() : compiled.getSegments();
+
+            vector<string> variables{};
+            for (const auto& segment : segments) {
+                if (segment.kind != segkind_t::Literal) { variables.push_back(entry.value.substr(segment.offset, segment.length)); }
+            }
+
+            std::sort(variables.begin(), variables.end());
+            variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
+            return variables;
+        }
+
+        size_t countLines(const string& value) { return static_cast<size_t>(std::count(value.begin(), value.end(), '\n')) + 1; }
+
+        int32_t compareKeys(const keyname_t& key, const string& section, const string& field) {
+            if (const auto result = key.first.compare(section); result != 0) { return result; }
+            return key.second.compare(field);
+        }
+
+        /**
+         * @brief Takes a snapshot of the reference, so it is only walked once for any amount of languages.
+         */
+        vector<keyinfo_t> snapshotReference(const language& reference) {
+            vector<keyinfo_t> keys{};
+            keys.reserve(reference.getStats().keys);
+            reference.visitTranslations([&](const string& section, const string& field, const entry_t& entry) {
+                keys.push_back({ { section, field }, getVariables(entry), countLines(entry.value) });
+            });
+
+            return keys;
+        }
+
+        /**
+         * @brief Compares a language with the snapshot of the reference; both are ordered by section and field.
+         */
+        langreport_t checkAgainst(const vector<keyinfo_t>& reference, const language& lang) {
+            langreport_t report{};
+            report.langId = lang.getLangId();
+
+            auto refPos = reference.begin();
+            lang.visitTranslations([&](const string& section, const string& field, const entry_t& entry) {
+                for (; refPos != reference.end() && compareKeys(refPos->key, section, field) < 0; refPos++) {
+                    report.missingKeys.push_back(refPos->key);
+                }
+
+                if (refPos == reference.end() || compareKeys(refPos->key, section, field) > 0) {
+                    report.extraKeys.emplace_back(section, field);
+                    return;
+                }
+
+                const auto variables = getVariables(entry);
+                if (variables != refPos->variables) {
+                    varmismatch_t mismatch{ refPos->key };
+                    std::set_difference(refPos->variables.begin(), refPos->variables.end(), variables.begin(), variables.end(), std::back_inserter(mismatch.missingVariables));
+                    std::set_difference(variables.begin(), variables.end(), refPos->variables.begin(), refPos->variables.end(), std::back_inserter(mismatch.extraVariables));
+                    report.variableMismatches.push_back(std::move(mismatch));
+                }
+
+                if (const auto lines = countLines(entry.value); lines != refPos->lines) {
+                    report.lineCountMismatches.push_back({ refPos->key, refPos->lines, lines });
+                }
+
+                refPos++;
+            });
+
+            for (; refPos != reference.end(); refPos++) { report.missingKeys.push_back(refPos->key); }
+
+            return report;
+        }
+
+        void writeString(std::ostream& outStream, string_view str) { outStream << '"' + extensions::escapeJson(str) + '"'; }
+
+        void writeKey(std::ostream& outStream, const keyname_t& key) { writeString(outStream, key.first + ":" + key.second); }
+
+        template<typename T, typename Writer>
+        void writeArray(std::ostream& outStream, const vector<T>& values, const Writer& writeValue) {
+            outStream << '[';
+            for (size_t i = 0; i < values.size(); i++) {
+                if (i != 0) { outStream << ", "; }
+                writeValue(values[i]);
+            }
+            outStream << ']';
+        }
+
+    }
+
+    /**
+     * @brief Checks a single language against the reference.
+     *
+     * @param reference The reference language.
+     * @param lang The language to check.
+     *
+     * @return langreport_t The differences between the languages; keys are ordered by section and field.
+     */
+    langreport_t checkLanguage(const language& reference, const language& lang) {
+        return checkAgainst(snapshotReference(reference), lang);
+    }
+
+    /**
+     * @brief Checks languages against the reference in parallel.
+     *
+     * The reference is walked once; each language is then checked by the next free worker.
+     *
+     * @remarks None of the languages may be modified while they are checked.
+     *
+     * @param reference The reference language.
+     * @param languages The languages to check.
+     * @param jobs The maximum amount of threads to use; 0 uses one per CPU.
+     *
+     * @return vector<langreport_t> One report per language, in the order the languages were passed.
+     */
+    vector<langreport_t> check(const language& reference, const vector<const language*>& languages, size_t jobs /*= 0*/) {
+        const auto referenceKeys = snapshotReference(reference);
+        vector<langreport_t> reports(languages.size());
+
+        std::atomic<size_t> nextLanguage{0};
+        const auto worker = [&] {
+            for (auto index = nextLanguage++; index < languages.size(); index = nextLanguage++) {
+                if (languages[index] != nullptr) { reports[index] = checkAgainst(referenceKeys, *languages[index]); }
+            }
+        };
+
+        if (jobs == 0) { jobs = std::max(1u, std::thread::hardware_concurrency()); }
+        jobs = std::min(jobs, std::max<size_t>(1, languages.size()));
+
+        vector<std::thread> workers{};
+        for (size_t i = 1; i < jobs; i++) { workers.emplace_back(worker); }
+        worker();
+        for (auto& thread : workers) { thread.join(); }
+
+        return reports;
+    }
+
+    /**
+     * @brief Serialises reports as JSON.
+     *
+     * @param referenceId The lang_id of the reference language.
+     * @param reports The reports to serialise.
+     *
+     * @return string The JSON document; see writeJson().
+     */
+    string toJson(string_view referenceId, const vector<langreport_t>& reports) {
+        std::ostringstream outStream{};
+        writeJson(outStream, referenceId, reports);
+
+        return outStream.str();
+    }
+
+    /**
+     * @brief Writes reports as JSON.
+     *
+     * The document has the form
+     * @code
+     * { "reference": "en_GB", "languages": [ { "lang_id": "de_DE", "consistent": false,
+     *     "missing_keys": [ "section:field" ], "extra_keys": [],
+     *     "variable_mismatches": [ { "key": "section:field", "missing": [ "count" ], "extra": [] } ],
+     *     "line_count_mismatches": [ { "key": "section:field", "reference_lines": 3, "lines": 2 } ] } ] }
+     * @endcode
+     *
+     * @param outStream The stream to write to.
+     * @param referenceId The lang_id of the reference language.
+     * @param reports The reports to write.
+     */
+    void writeJson(std::ostream& outStream, string_view referenceId, const vector<langreport_t>& reports) {
+        const auto writeStr = [&](const string& str) { writeString(outStream, str); };
+
+        outStream << "{\n  \"reference\": ";
+        writeString(outStream, referenceId);
+        outStream << ",\n  \"languages\": [";
+
+        for (size_t i = 0; i < reports.size(); i++) {
+            const auto& report = reports[i];
+
+            outStream << (i == 0 ? "\n" : ",\n") << "    {\n      \"lang_id\": ";
+            writeString(outStream, report.langId);
+            outStream << ",\n      \"consistent\": " << (report.isConsistent() ? "true" : "false");
+
+            outStream << ",\n      \"missing_keys\": ";
+            writeArray(outStream, report.missingKeys, [&](const keyname_t& key) { writeKey(outStream, key); });
+            outStream << ",\n      \"extra_keys\": ";
+            writeArray(outStream, report.extraKeys, [&](const keyname_t& key) { writeKey(outStream, key); });
+
+            outStream << ",\n      \"variable_mismatches\": ";
+            writeArray(outStream, report.variableMismatches, [&](const varmismatch_t& mismatch) {
+                outStream << "{ \"key\": ";
+                writeKey(outStream, mismatch.key);
+                outStream << ", \"missing\": ";
+                writeArray(outStream, mismatch.missingVariables, writeStr);
+                outStream << ", \"extra\": ";
+                writeArray(outStream, mismatch.extraVariables, writeStr);
+                outStream << " }";
+            });
+
+            outStream << ",\n      \"line_count_mismatches\": ";
+            writeArray(outStream, report.lineCountMismatches, [&](const linemismatch_t& mismatch) {
+                outStream << "{ \"key\": ";
+                writeKey(outStream, mismatch.key);
+                outStream << ", \"reference_lines\": " << mismatch.referenceLines << ", \"lines\": " << mismatch.lines << " }";
+            });
+
+            outStream << "\n    }";
+        }
+
+        outStream << (reports.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    }
+
+}
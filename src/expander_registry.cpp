@@ -0,0 +1,254 @@
+/**
+ * @file expander_registry.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the expander registry.
+ * @version 0.1
+ * @date 2023-02-10
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/expander_registry.hpp"
+#include "borr/extensions.hpp"
+
+namespace borr {
+
+    namespace {
+
+        constexpr uint64_t MAX_HASH_SEEDS = 64; //!< The amount of seeds to try before giving up on the perfect hash
+
+        /**
+         * @brief Finalises a 64-bit hash so that its bits are well distributed (splitmix64).
+         */
+        constexpr uint64_t mixHash(uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        /**
+         * @brief Gets the position of a hash in the table for a given bucket displacement.
+         */
+        constexpr size_t positionOf(uint64_t hash, uint32_t displacement, size_t tableSize) {
+            const uint64_t h1 = mixHash(hash);
+            const uint64_t h2 = mixHash(hash ^ 0x9e3779b97f4a7c15ULL) | 1;
+
+            return static_cast<size_t>((h1 + displacement * h2) % tableSize);
+        }
+
+    }
+
+    /**
+     * @brief Registers a default expander for a given variable name.
+     *
+     * @param varName The name of the variable.
+     * @param expander The expander function.
+     *
+     * @return true If the expander was registered.
+     * @return false If a default expander already exists, or the registry is frozen and the name is unknown.
+     */
+    bool expander_registry::addDefault(const string& varName, expanderfn_t expander) {
+        const auto slot = getOrCreateSlot(varName);
+        if (slot == NPOS || m_entries[slot].defaultExpander != nullptr) { return false; }
+
+        m_entries[slot].defaultExpander = expander;
+        return true;
+    }
+
+    /**
+     * @brief Registers a custom expander for a given variable name.
+     *
+     * @remarks Custom expanders overwrite default expanders!
+     *
+     * @param varName The name of the variable.
+     * @param cb The callback which expands the variable.
+     *
+     * @return true If the callback was registered.
+     * @return false If a custom expander already exists, or the registry is frozen and the name is unknown.
+     */
+    bool expander_registry::addCallback(const string& varName, const varexpansioncallback_t& cb) {
+        const auto slot = getOrCreateSlot(varName);
+        if (slot == NPOS || m_entries[slot].customExpander) { return false; }
+
+        m_entries[slot].customExpander = cb;
+        return true;
+    }
+
+    /**
+     * @brief Removes the custom expander for a given variable name.
+     *
+     * The slot itself remains, so templates bound to it fall back to the default expander (if any).
+     *
+     * @param varName The name of the variable.
+     */
+    void expander_registry::removeCallback(const string& varName) {
+        const auto slot = find(varName);
+        if (slot == NPOS) { return; } // fail silently
+
+        m_entries[slot].customExpander = nullptr;
+    }
+
+    /**
+     * @brief Freezes the registry.
+     *
+     * After freezing, no new variable names may be registered and lookups by name use a minimal perfect hash.
+     * Calling this member function more than once has no effect.
+     */
+    void expander_registry::freeze() {
+        if (m_frozen) { return; }
+
+        for (uint64_t seed = 0; seed < MAX_HASH_SEEDS; seed++) {
+            if (buildPerfectHash(seed)) { break; }
+        }
+
+        m_frozen = true;
+    }
+
+    /**
+     * @brief Finds the slot of a given variable name.
+     *
+     * @param varName The name of the variable.
+     *
+     * @return size_t The slot of the variable, or NPOS if the variable isn't registered.
+     */
+    size_t expander_registry::find(string_view varName) const {
+        if (!m_hashTable.empty()) {
+            const auto hash = hashName(varName, m_hashSeed);
+            const auto displacement = m_displacements[hash % m_displacements.size()];
+            const auto slot = m_hashTable[positionOf(hash, displacement, m_hashTable.size())];
+
+            return m_entries[slot].name == varName ? slot : NPOS;
+        }
+
+        const auto iterPos = m_nameIndex.find(varName);
+        return iterPos == m_nameIndex.end() ? NPOS : iterPos->second;
+    }
+
+    /**
+     * @brief Invokes the expander in a given slot.
+     *
+     * @param slot The slot as returned by @c find().
+     * @param varName The name of the variable being expanded; passed to the expander.
+     * @param outValue Out parameter containing the expanded value.
+     *
+     * @return true If an expander was found in the slot and invoked.
+     * @return false If the slot is invalid or empty.
+     */
+    bool expander_registry::invoke(size_t slot, const string& varName, string& outValue) const {
+        if (slot >= m_entries.size()) { return false; }
+
+        const auto& entry = m_entries[slot];
+        if (entry.customExpander) {
+            outValue = entry.customExpander(varName);
+            return true;
+        } else if (entry.defaultExpander != nullptr) {
+            outValue = entry.defaultExpander(varName);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Hashes a variable name for use in the perfect hash.
+     */
+    uint64_t expander_registry::hashName(string_view varName, uint64_t seed) {
+        return extensions::fnv1a(varName, mixHash(seed));
+    }
+
+    /**
+     * @brief Attempts to build a minimal perfect hash over all registered names using hash-and-displace.
+     *
+     * Names are distributed into buckets, which are then placed largest first.
+     * For each bucket a displacement is searched for which maps all of its names to free positions.
+     *
+     * @param seed The seed to use for hashing.
+     *
+     * @return true If the perfect hash was built.
+     * @return false If no displacement could be found for a bucket; the caller should try a different seed.
+     */
+    bool expander_registry::buildPerfectHash(uint64_t seed) {
+        const auto entryCount = m_entries.size();
+        if (entryCount == 0) { return true; }
+
+        const auto maxDisplacement = static_cast<uint32_t>(entryCount * 32 + 64);
+
+        vector<uint64_t> hashes(entryCount);
+        vector<vector<size_t>> buckets(entryCount);
+        for (size_t i = 0; i < entryCount; i++) {
+            hashes[i] = hashName(m_entries[i].name, seed);
+            buckets[hashes[i] % entryCount].push_back(i);
+        }
+
+        vector<size_t> bucketOrder(entryCount);
+        std::iota(bucketOrder.begin(), bucketOrder.end(), 0);
+        std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        vector<uint32_t> displacements(entryCount, 0);
+        vector<size_t> table(entryCount, NPOS);
+        vector<size_t> positions;
+
+        for (const auto bucket : bucketOrder) {
+            const auto& members = buckets[bucket];
+            if (members.empty()) { break; } // all remaining buckets are empty
+
+            bool placed = false;
+            for (uint32_t displacement = 0; displacement < maxDisplacement && !placed; displacement++) {
+                positions.clear();
+
+                placed = std::all_of(members.begin(), members.end(), [&](size_t member) {
+                    const auto pos = positionOf(hashes[member], displacement, entryCount);
+                    if (table[pos] != NPOS || std::find(positions.begin(), positions.end(), pos) != positions.end()) { return false; }
+
+                    positions.push_back(pos);
+                    return true;
+                });
+
+                if (placed) {
+                    displacements[bucket] = displacement;
+                    for (size_t i = 0; i < members.size(); i++) { table[positions[i]] = members[i]; }
+                }
+            }
+
+            if (!placed) { return false; }
+        }
+
+        m_hashSeed = seed;
+        m_displacements = std::move(displacements);
+        m_hashTable = std::move(table);
+        return true;
+    }
+
+    /**
+     * @brief Gets the slot for a given name, creating it if the registry isn't frozen yet.
+     *
+     * @param varName The name of the variable.
+     *
+     * @return size_t The slot for the name, or NPOS if the registry is frozen and the name is unknown.
+     */
+    size_t expander_registry::getOrCreateSlot(const string& varName) {
+        if (const auto slot = find(varName); slot != NPOS) { return slot; }
+        if (m_frozen) { return NPOS; }
+
+        m_entries.push_back({ varName, nullptr, {} });
+        m_nameIndex.emplace(varName, m_entries.size() - 1);
+
+        return m_entries.size() - 1;
+    }
+
+}
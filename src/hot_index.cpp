@@ -0,0 +1,159 @@
+/**
+ * @file hot_index.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the hot_index class.
+ * @version 0.1
+ * @date 2023-02-12
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/extensions.hpp"
+#include "borr/hot_index.hpp"
+#include "borr/language.hpp"
+
+namespace borr {
+
+    /**
+     * @brief Builds the index from a list of hot keys.
+     *
+     * Keys which can't be resolved are skipped. Building stops once the pool would exceed maxPoolBytes.
+     *
+     * @param hotKeys The section/field pairs to index, hottest first.
+     * @param resolver A function resolving a section/field pair to its entry.
+     * @param maxPoolBytes The maximum size of the pool.
+     *
+     * @return size_t The amount of keys which were indexed.
+     */
+    size_t hot_index::build(const vector<std::pair<string, string>>& hotKeys, const resolver_t& resolver, size_t maxPoolBytes /*= DEFAULT_MAX_POOL_BYTES*/) {
+        clear();
+        maxPoolBytes = std::min<size_t>(maxPoolBytes, std::numeric_limits<uint32_t>::max());
+
+        for (const auto& key : hotKeys) {
+            const auto entry = resolver(key.first, key.second);
+            if (entry == nullptr) { continue; }
+
+            const auto recordSize = key.first.size() + key.second.size() + entry->value.size();
+            if (m_pool.size() + recordSize > maxPoolBytes) { break; }
+
+            m_records.push_back({
+                hashKey(key.first, key.second),
+                static_cast<uint32_t>(m_pool.size()),
+                static_cast<uint32_t>(key.first.size()),
+                static_cast<uint32_t>(key.second.size()),
+                static_cast<uint32_t>(entry->value.size()),
+                entry
+            });
+
+            m_pool += key.first;
+            m_pool += key.second;
+            m_pool += entry->value;
+        }
+        m_pool.shrink_to_fit();
+
+        // keep the table at most half full so probes stay short
+        size_t slotCount = 1;
+        while (slotCount < m_records.size() * 2) { slotCount <<= 1; }
+        m_slots.assign(m_records.empty() ? 0 : slotCount, 0);
+
+        for (size_t i = 0; i < m_records.size(); i++) {
+            auto slot = m_records[i].hash & (m_slots.size() - 1);
+            while (m_slots[slot] != 0) { slot = (slot + 1) & (m_slots.size() - 1); }
+
+            m_slots[slot] = static_cast<uint32_t>(i + 1);
+        }
+
+        return m_records.size();
+    }
+
+    /**
+     * @brief Resolves the entries of all records again.
+     *
+     * The pooled keys and values are unaffected.
+     *
+     * @param resolver A function resolving a section/field pair to its entry.
+     */
+    void hot_index::rebind(const resolver_t& resolver) {
+        for (auto& record : m_records) {
+            record.entry = resolver(
+                m_pool.substr(record.keyOffset, record.sectionLength),
+                m_pool.substr(record.keyOffset + record.sectionLength, record.fieldLength)
+            );
+        }
+    }
+
+    /**
+     * @brief Clears the index.
+     */
+    void hot_index::clear() {
+        m_pool.clear();
+        m_records.clear();
+        m_slots.clear();
+    }
+
+    /**
+     * @brief Looks up a translation in the index.
+     *
+     * @param section The section of the translation.
+     * @param field The field of the translation.
+     * @param outHit Out parameter containing the pooled value and entry.
+     *
+     * @return true If the translation is part of the index.
+     * @return false Otherwise.
+     */
+    bool hot_index::find(const string& section, const string& field, hit_t& outHit) const {
+        if (m_slots.empty()) { return false; }
+
+        const auto hash = hashKey(section, field);
+        const string_view pool(m_pool);
+
+        for (auto slot = hash & (m_slots.size() - 1); m_slots[slot] != 0; slot = (slot + 1) & (m_slots.size() - 1)) {
+            const auto& record = m_records[m_slots[slot] - 1];
+            if (record.hash != hash || record.entry == nullptr) { continue; }
+            if (record.sectionLength != section.size() || record.fieldLength != field.size()) { continue; }
+            if (pool.substr(record.keyOffset, record.sectionLength) != section) { continue; }
+            if (pool.substr(record.keyOffset + record.sectionLength, record.fieldLength) != field) { continue; }
+
+            outHit.value = pool.substr(record.keyOffset + record.sectionLength + record.fieldLength, record.valueLength);
+            outHit.entry = record.entry;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Determines whether any translation of a section is part of the index.
+     *
+     * @remarks This walks all records; it is meant for infrequent checks such as eviction decisions.
+     *
+     * @param section The name of the section.
+     *
+     * @return true If at least one translation of the section is part of the index.
+     */
+    bool hot_index::containsSection(string_view section) const {
+        return std::any_of(m_records.begin(), m_records.end(), [&](const record_t& record) {
+            return string_view(m_pool).substr(record.keyOffset, record.sectionLength) == section;
+        });
+    }
+
+    /**
+     * @brief Hashes a section/field pair.
+     */
+    uint64_t hot_index::hashKey(string_view section, string_view field) {
+        return extensions::fnv1a(field, extensions::fnv1a(section));
+    }
+
+}
@@ -0,0 +1,116 @@
+/**
+ * @file key_index.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the key_index class.
+ * @version 0.1
+ * @date 2023-02-28
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/key_index.hpp"
+
+namespace borr {
+
+    /**
+     * @brief Computes the stable key of a translation: the 64-bit FNV-1a hash of "section:field".
+     *
+     * @remarks The (astronomically unlikely) hash value 0 is mapped to 1, so INVALID_KEY is never produced.
+     *
+     * @param section The section of the translation.
+     * @param field The field of the translation.
+     *
+     * @return stablekey_t The stable key.
+     */
+    stablekey_t key_index::getStableKey(string_view section, string_view field) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        const auto mix = [&hash](char c) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ULL;
+        };
+
+        for (const auto c : section) { mix(c); }
+        mix(':');
+        for (const auto c : field) { mix(c); }
+
+        return hash == INVALID_KEY ? 1 : hash;
+    }
+
+    /**
+     * @brief Adds a translation to the index. The names are copied.
+     *
+     * @param section The section of the translation.
+     * @param field The field of the translation.
+     * @param entry The entry of the translation, or nullptr if only the names should be indexed.
+     */
+    void key_index::add(string_view section, string_view field, const entry_t* entry) {
+        m_records.push_back(record_t{
+            getStableKey(section, field),
+            static_cast<uint32_t>(m_pool.size()),
+            static_cast<uint32_t>(section.size()),
+            static_cast<uint32_t>(field.size()),
+            entry
+        });
+
+        m_pool += section;
+        m_pool += field;
+    }
+
+    /**
+     * @brief Sorts the index by key and marks colliding keys as ambiguous.
+     */
+    void key_index::finalise() {
+        std::sort(m_records.begin(), m_records.end(), [](const record_t& lhs, const record_t& rhs) { return lhs.key < rhs.key; });
+
+        // only the first record of a key is ever found; it stands for all colliding translations
+        m_collisions = 0;
+        for (size_t i = 1; i < m_records.size(); i++) {
+            if (m_records[i].key != m_records[i - 1].key) { continue; }
+
+            auto& first = *std::lower_bound(m_records.begin(), m_records.begin() + static_cast<std::ptrdiff_t>(i), m_records[i].key,
+                                            [](const record_t& record, stablekey_t key) { return record.key < key; });
+            if (first.sectionLength != UINT32_MAX) { m_collisions++; }
+
+            first.sectionLength = UINT32_MAX;
+            first.entry = nullptr;
+            m_collisions++;
+        }
+
+        m_pool.shrink_to_fit();
+        m_records.shrink_to_fit();
+    }
+
+    /**
+     * @brief Looks up a translation by its stable key.
+     *
+     * @param key The stable key of the translation.
+     * @param outRef Receives the names and entry of the translation.
+     *
+     * @return true If exactly one indexed translation has this key.
+     * @return false Otherwise.
+     */
+    bool key_index::find(stablekey_t key, keyref_t& outRef) const {
+        const auto record = std::lower_bound(m_records.begin(), m_records.end(), key, [](const record_t& record, stablekey_t key) { return record.key < key; });
+        if (record == m_records.end() || record->key != key || record->sectionLength == UINT32_MAX) { return false; }
+
+        const string_view pool(m_pool);
+        outRef.section = pool.substr(record->keyOffset, record->sectionLength);
+        outRef.field = pool.substr(record->keyOffset + record->sectionLength, record->fieldLength);
+        outRef.entry = record->entry;
+
+        return true;
+    }
+
+}
@@ -0,0 +1,440 @@
+/**
+ * @file lang_pack.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the lang_pack format.
+ * @version 0.1
+ * @date 2023-02-17
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/extensions.hpp"
+#include "borr/lang_pack.hpp"
+
+namespace borr {
+
+    using std::error_code;
+
+    namespace {
+
+        /**
+         * @brief A reference to a string in the string pool.
+         */
+        struct strref_t {
+            uint32_t    offset; //!< The offset relative to the start of the string pool
+            uint32_t    length; //!< The length of the string
+        };
+
+        /**
+         * @brief The fixed-size header at the start of every pack.
+         */
+        struct packheader_t {
+            char        magic[8]; //!< PACK_MAGIC
+            uint32_t    version; //!< PACK_VERSION
+            uint32_t    entryCount; //!< The amount of entries in the entry table
+            uint64_t    sourceHash; //!< The content hash of the source borrfile
+            uint32_t    poolOffset; //!< The offset of the string pool
+            uint32_t    poolSize; //!< The size of the string pool
+            strref_t    langId; //!< The lang_id field
+            strref_t    langDescription; //!< The lang_desc field
+            strref_t    langVersion; //!< The lang_ver field
+        };
+
+        /**
+         * @brief A single translation in the entry table.
+         */
+        struct packrecord_t {
+            strref_t    section;
+            strref_t    field;
+            strref_t    value;
+        };
+
+        /**
+         * @brief Reads and validates the header of a pack.
+         *
+         * @return true If the header is complete and was written by this version of libborr on a machine with the same byte order.
+         */
+        bool readHeader(string_view contents, packheader_t& outHeader) {
+            if (contents.size() < sizeof(packheader_t)) { return false; }
+
+            std::memcpy(&outHeader, contents.data(), sizeof(packheader_t));
+            return string_view(outHeader.magic, sizeof(outHeader.magic)) == lang_pack::PACK_MAGIC && outHeader.version == lang_pack::PACK_VERSION;
+        }
+
+        /**
+         * @brief Resolves a reference into the string pool.
+         *
+         * @throws runtime_error If the reference exceeds the string pool.
+         */
+        string_view resolveString(string_view pool, const strref_t& ref) {
+            if (static_cast<uint64_t>(ref.offset) + ref.length > pool.size()) {
+                throw std::runtime_error("Invalid language pack: string exceeds string pool!");
+            }
+
+            return pool.substr(ref.offset, ref.length);
+        }
+
+    }
+
+    /**
+     * @brief Writes a language pack.
+     *
+     * Entries are sorted by section and field; if the same section and field are passed more than once, the first entry is used.
+     * The pack is written to a temporary file in the same directory, which is then renamed to path. A pack which is already
+     * mapped (e.g. as the backing pack of a language under a memory budget) therefore keeps its old contents until it's unmapped,
+     * and an interrupted write never leaves a truncated pack behind.
+     *
+     * @param path The path to write the pack to.
+     * @param meta The metadata of the language.
+     * @param entries All translations of the language.
+     *
+     * @throws fs::filesystem_error If the file couldn't be written.
+     * @throws runtime_error If the pack would exceed 4 GiB.
+     */
+    void lang_pack::writeFile(const fs::path& path, const packmeta_t& meta, vector<packentry_t> entries) {
+        const auto contents = writeString(meta, std::move(entries));
+
+        // unique per call, so concurrent writers (threads or processes) never share a temporary file
+        std::random_device randomDevice{};
+        auto tempPath = path;
+        tempPath += "." + std::to_string((static_cast<uint64_t>(randomDevice()) << 32) | randomDevice()) + ".tmp";
+
+        {
+            std::ofstream outStream(tempPath, std::ios::binary | std::ios::trunc);
+            if (!outStream.is_open()) {
+                throw fs::filesystem_error("Failed to write language pack!", path, error_code(EACCES, std::generic_category()));
+            }
+
+            outStream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            outStream.close();
+
+            if (!outStream.good()) {
+                error_code ignored{};
+                fs::remove(tempPath, ignored);
+                throw fs::filesystem_error("Failed to write language pack!", path, error_code(EIO, std::generic_category()));
+            }
+        }
+
+        error_code renameError{};
+        fs::rename(tempPath, path, renameError);
+        if (renameError) {
+            error_code ignored{};
+            fs::remove(tempPath, ignored);
+            throw fs::filesystem_error("Failed to write language pack!", path, renameError);
+        }
+    }
+
+    /**
+     * @brief Serialises a language pack into memory.
+     *
+     * @param meta The metadata of the language.
+     * @param entries All translations of the language; sorted and deduplicated as by writeFile().
+     *
+     * @return string The contents of the pack.
+     *
+     * @throws runtime_error If the pack would exceed 4 GiB.
+     */
+    string lang_pack::writeString(const packmeta_t& meta, vector<packentry_t> entries) {
+        const auto keyLess = [](const packentry_t& a, const packentry_t& b) { return std::tie(a.section, a.field) < std::tie(b.section, b.field); };
+        const auto keyEqual = [](const packentry_t& a, const packentry_t& b) { return a.section == b.section && a.field == b.field; };
+
+        std::stable_sort(entries.begin(), entries.end(), keyLess);
+        entries.erase(std::unique(entries.begin(), entries.end(), keyEqual), entries.end());
+
+        // presize the pool; entries are sorted, so every section name is counted once, just as it is stored
+        size_t poolBytes = meta.langId.size() + meta.langDescription.size() + meta.langVersion.size();
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (i == 0 || entries[i].section != entries[i - 1].section) { poolBytes += entries[i].section.size(); }
+            poolBytes += entries[i].field.size() + entries[i].value.size();
+        }
+
+        string pool{};
+        pool.reserve(std::min<size_t>(poolBytes, UINT32_MAX));
+        const auto addString = [&](const string& str) {
+            if (pool.size() + str.size() > UINT32_MAX) {
+                throw std::runtime_error("Language pack exceeds maximum size!");
+            }
+
+            const strref_t ref{ static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(str.size()) };
+            pool += str;
+            return ref;
+        };
+
+        packheader_t header{};
+        std::memcpy(header.magic, PACK_MAGIC.data(), PACK_MAGIC.size());
+        header.version = PACK_VERSION;
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.sourceHash = meta.sourceHash;
+        header.poolOffset = static_cast<uint32_t>(sizeof(packheader_t) + entries.size() * sizeof(packrecord_t));
+        header.langId = addString(meta.langId);
+        header.langDescription = addString(meta.langDescription);
+        header.langVersion = addString(meta.langVersion);
+
+        vector<packrecord_t> records{};
+        records.reserve(entries.size());
+
+        const string* lastSection = nullptr;
+        strref_t sectionRef{};
+        for (const auto& entry : entries) {
+            if (lastSection == nullptr || *lastSection != entry.section) {
+                sectionRef = addString(entry.section);
+                lastSection = &entry.section;
+            }
+
+            const auto fieldRef = addString(entry.field);
+            records.push_back({ sectionRef, fieldRef, addString(entry.value) });
+        }
+        header.poolSize = static_cast<uint32_t>(pool.size());
+
+        string contents{};
+        contents.reserve(header.poolOffset + pool.size());
+        contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        contents.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(packrecord_t));
+        contents += pool;
+
+        return contents;
+    }
+
+    /**
+     * @brief Reads a language pack from disk.
+     *
+     * @param path The path to the pack.
+     * @param outMeta Out parameter containing the metadata of the language.
+     * @param visitor Called once for every translation, sorted by section and field.
+     *
+     * @throws fs::filesystem_error If the file couldn't be opened.
+     * @throws runtime_error If the file isn't a valid language pack.
+     */
+    void lang_pack::readFile(const fs::path& path, packmeta_t& outMeta, const packvisitor_t& visitor) {
+        const auto pack = fromFile(path);
+
+        outMeta = pack->getMeta();
+        pack->visitAll(visitor);
+    }
+
+    /**
+     * @brief Reads a language pack from memory.
+     *
+     * The header and table bounds are validated before the first translation is visited;
+     * string references are validated as they are visited.
+     *
+     * @param contents The contents of the pack.
+     * @param outMeta Out parameter containing the metadata of the language.
+     * @param visitor Called once for every translation, sorted by section and field. The views are only valid during the call.
+     *
+     * @throws runtime_error If the contents aren't a valid language pack.
+     */
+    void lang_pack::readString(string_view contents, packmeta_t& outMeta, const packvisitor_t& visitor) {
+        const lang_pack pack(contents);
+
+        outMeta = pack.getMeta();
+        pack.visitAll(visitor);
+    }
+
+    /**
+     * @brief Reads the source hash from the header of a pack, without reading the rest of the file.
+     *
+     * @param path The path to the pack.
+     *
+     * @return std::optional<uint64_t> The hash, or nullopt if the file doesn't exist or isn't a pack of the current version.
+     */
+    std::optional<uint64_t> lang_pack::readSourceHash(const fs::path& path) {
+        std::ifstream inStream(path, std::ios::binary);
+        if (!inStream.is_open()) { return {}; }
+
+        char buffer[sizeof(packheader_t)]{};
+        inStream.read(buffer, sizeof(buffer));
+
+        packheader_t header{};
+        if (!readHeader(string_view(buffer, static_cast<size_t>(inStream.gcount())), header)) { return {}; }
+
+        return header.sourceHash;
+    }
+
+    /**
+     * @brief Hashes the contents of a borrfile.
+     *
+     * The pack format version is mixed into the hash, so packs are rebuilt whenever the format changes.
+     *
+     * @param contents The contents of the borrfile.
+     *
+     * @return uint64_t The hash of the contents.
+     */
+    uint64_t lang_pack::hashContents(string_view contents) {
+        return extensions::fnv1a(contents, PACK_VERSION);
+    }
+
+    /**
+     * @brief Maps a language pack into memory and validates its header and tables.
+     *
+     * The returned pack keeps the mapping alive; translations are only read when they are visited.
+     *
+     * @param path The path to the pack.
+     *
+     * @return std::shared_ptr<const lang_pack> The opened pack.
+     *
+     * @throws fs::filesystem_error If the file couldn't be opened.
+     * @throws runtime_error If the file isn't a valid language pack.
+     */
+    std::shared_ptr<const lang_pack> lang_pack::fromFile(const fs::path& path) {
+        auto file = mapped_file::fromFile(path);
+        auto pack = std::shared_ptr<lang_pack>(new lang_pack(file->view()));
+        pack->m_file = std::move(file);
+
+        return pack;
+    }
+
+    /**
+     * @brief Validates a language pack held in memory and takes ownership of it.
+     *
+     * @param contents The contents of the pack, e.g. as returned by writeString().
+     *
+     * @return std::shared_ptr<const lang_pack> The opened pack.
+     *
+     * @throws runtime_error If the contents aren't a valid language pack.
+     */
+    std::shared_ptr<const lang_pack> lang_pack::fromString(string contents) {
+        auto file = mapped_file::fromString(std::move(contents));
+        auto pack = std::shared_ptr<lang_pack>(new lang_pack(file->view()));
+        pack->m_file = std::move(file);
+
+        return pack;
+    }
+
+    /**
+     * @brief Validates the header and table bounds of a pack, without taking ownership of its contents.
+     *
+     * @throws runtime_error If the contents aren't a valid language pack.
+     */
+    lang_pack::lang_pack(string_view contents): m_contents(contents) {
+        packheader_t header{};
+        if (!readHeader(contents, header)) {
+            throw std::runtime_error("Invalid language pack: magic number or version mismatch!");
+        }
+
+        if (static_cast<uint64_t>(header.poolOffset) + header.poolSize > contents.size() ||
+            sizeof(packheader_t) + static_cast<uint64_t>(header.entryCount) * sizeof(packrecord_t) > header.poolOffset) {
+            throw std::runtime_error("Invalid language pack: tables exceed file size!");
+        }
+
+        m_pool = contents.substr(header.poolOffset, header.poolSize);
+        m_entryCount = header.entryCount;
+
+        const auto getString = [&](const strref_t& ref) { return string(resolveString(m_pool, ref)); };
+        m_meta.langId = getString(header.langId);
+        m_meta.langDescription = getString(header.langDescription);
+        m_meta.langVersion = getString(header.langVersion);
+        m_meta.sourceHash = header.sourceHash;
+    }
+
+    /**
+     * @brief Reads a single record of the entry table.
+     *
+     * @throws runtime_error If one of the record's strings exceeds the string pool.
+     */
+    void lang_pack::getRecord(size_t index, string_view& outSection, string_view& outField, string_view& outValue) const {
+        packrecord_t record{};
+        std::memcpy(&record, m_contents.data() + sizeof(packheader_t) + index * sizeof(packrecord_t), sizeof(record));
+
+        outSection = resolveString(m_pool, record.section);
+        outField = resolveString(m_pool, record.field);
+        outValue = resolveString(m_pool, record.value);
+    }
+
+    /**
+     * @brief Reads only the section name of a record.
+     */
+    string_view lang_pack::getSection(size_t index) const {
+        strref_t section{};
+        std::memcpy(&section, m_contents.data() + sizeof(packheader_t) + index * sizeof(packrecord_t), sizeof(section));
+
+        return resolveString(m_pool, section);
+    }
+
+    /**
+     * @brief Gets the names of all sections in the pack.
+     *
+     * @return vector<string> The section names, sorted.
+     */
+    vector<string> lang_pack::getSectionNames() const {
+        vector<string> sections{};
+
+        for (size_t i = 0; i < m_entryCount; i++) {
+            const auto section = getSection(i);
+            if (sections.empty() || sections.back() != section) { sections.emplace_back(section); }
+        }
+
+        return sections;
+    }
+
+    /**
+     * @brief Visits every translation in the pack.
+     *
+     * @param visitor Called once for every translation, sorted by section and field. The views are valid as long as the pack.
+     *
+     * @throws runtime_error If a string reference exceeds the string pool.
+     */
+    void lang_pack::visitAll(const packvisitor_t& visitor) const {
+        string_view section{}, field{}, value{};
+
+        for (size_t i = 0; i < m_entryCount; i++) {
+            getRecord(i, section, field, value);
+            visitor(section, field, value);
+        }
+    }
+
+    /**
+     * @brief Visits the translations of a single section.
+     *
+     * The records are sorted by section, so the section is found by binary search and only its own records are read.
+     *
+     * @param section The section to visit.
+     * @param visitor Called once for every translation of the section, sorted by field.
+     *
+     * @return true If the section exists in the pack.
+     *
+     * @throws runtime_error If a string reference exceeds the string pool.
+     */
+    bool lang_pack::visitSection(string_view section, const packvisitor_t& visitor) const {
+        size_t first = 0;
+        size_t count = m_entryCount;
+        while (count > 0) {
+            const auto step = count / 2;
+            if (getSection(first + step) < section) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+
+        string_view recordSection{}, field{}, value{};
+        bool found = false;
+        for (auto i = first; i < m_entryCount; i++) {
+            getRecord(i, recordSection, field, value);
+            if (recordSection != section) { break; }
+
+            visitor(recordSection, field, value);
+            found = true;
+        }
+
+        return found;
+    }
+
+}
@@ -12,7 +12,10 @@
 // SYSTEM INCLUDES //
 /////////////////////
 // stl
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #if __cpp_lib_format >= 201907L
 #   include <format>
 #else
@@ -20,11 +23,21 @@
 #endif
 #include <filesystem>
 #include <fstream>
+#include <istream>
 #include <map>
+#include <mutex>
 #include <optional>
-#include <regex>
 #include <sstream>
 #include <string>
+#include <thread>
+
+// USDT probes compile to a single nop, so they are included whenever the platform provides them
+#if __has_include(<sys/sdt.h>) && !defined(BORR_NO_USDT)
+#   define BORR_HAS_USDT 1
+#   include <sys/sdt.h>
+#else
+#   define BORR_HAS_USDT 0
+#endif
 
 /////////////////////
 // LOCAL  INCLUDES //
@@ -40,67 +53,754 @@ namespace borr {
     namespace fs = std::filesystem;
 
     using std::error_code;
-    using std::regex;
-    using std::regex_replace;
-    using std::smatch;
     using std::stringstream;
     using std::vector;
 
-    varcbacklist_t language::_callbackList = {}; //!< Initialise private static member
+    namespace {
+
+        /**
+         * @brief Gets a new generation for a language; generations are never reused, not even by other languages.
+         */
+        uint64_t nextGeneration() {
+            static std::atomic<uint64_t> generation{0};
+            return ++generation;
+        }
+
+        /**
+         * @brief Mixes a string into a content fingerprint.
+         * 
+         * The length is mixed in first, as little endian bytes, so adjacent strings can't shift into each other
+         * and the fingerprint doesn't depend on the platform.
+         */
+        uint64_t mixFingerprint(uint64_t fingerprint, string_view value) {
+            char length[sizeof(uint64_t)]{};
+            for (size_t i = 0; i < sizeof(length); i++) { length[i] = static_cast<char>((static_cast<uint64_t>(value.size()) >> (i * 8)) & 0xff); }
+
+            return extensions::fnv1a(value, extensions::fnv1a(string_view(length, sizeof(length)), fingerprint));
+        }
+
+        std::shared_ptr<const loadtracer_t> g_loadTracer{}; //!< The tracer receiving the phases of all loads; accessed atomically
+
+        /**
+         * @brief The render currently sampled on this thread.
+         */
+        struct render_sample {
+            render_profiler&    profiler; //!< The profiler the sample is recorded into
+            const string&       section; //!< The section of the rendered translation
+            const string&       field; //!< The field of the rendered translation
+
+            void addSpan(render_profiler::spankind_t kind, string_view variable, size_t depth, std::chrono::nanoseconds duration) const {
+                profiler.add({ section, field, string(variable), kind, duration, {}, depth });
+            }
+        };
+
+        thread_local const render_sample* t_renderSample = nullptr; //!< The sampled render of this thread, if any
+
+        /**
+         * @brief Gets the kind of span a variable of a compiled template is reported as.
+         */
+        render_profiler::spankind_t getSpanKind(const compiled_template::segment_t& segment, string_view name) {
+            using segkind_t = compiled_template::segkind_t;
+            using spankind_t = render_profiler::spankind_t;
+
+            switch (segment.kind) {
+                case segkind_t::Expander:   return spankind_t::Expander;
+                case segkind_t::Reference:  return spankind_t::Reference;
+                default:                    return name.find(':') == string_view::npos ? spankind_t::Dynamic : spankind_t::Reference;
+            }
+        }
+
+        /**
+         * @brief Samples a single getString() call, if the profiler selects it.
+         *
+         * Renders nested within a sampled render (e.g. dynamic references through getString()) are part of the outer sample.
+         */
+        class sample_scope {
+            public:
+                sample_scope(render_profiler* profiler, const string& section, const string& field, bool expandVariables) {
+                    if (profiler == nullptr || !expandVariables || t_renderSample != nullptr || !profiler->shouldSample()) { return; }
+
+                    m_sample.emplace(render_sample{ *profiler, section, field });
+                    t_renderSample = &*m_sample;
+                    m_start = std::chrono::steady_clock::now();
+                }
+
+                ~sample_scope() {
+                    if (!m_sample) { return; }
+
+                    t_renderSample = nullptr;
+                    m_sample->profiler.add({ m_sample->section, m_sample->field, {}, render_profiler::spankind_t::Render, std::chrono::steady_clock::now() - m_start, m_lookup, 0 });
+                    m_sample->profiler.addRender();
+                }
+
+                sample_scope(const sample_scope&) = delete;
+                sample_scope& operator=(const sample_scope&) = delete;
+
+                void lookupDone() {
+                    if (m_sample) { m_lookup = std::chrono::steady_clock::now() - m_start; }
+                }
+
+            private:
+                optional<render_sample>                 m_sample{}; //!< The sample; empty if this call isn't sampled
+                std::chrono::steady_clock::time_point   m_start{}; //!< When the call started
+                std::chrono::nanoseconds                m_lookup{0}; //!< How long finding the translation took
+        };
+
+        /**
+         * @brief Estimates the heap memory held by a single section of the translation dictionary.
+         *
+         * Accounts for map nodes, heap-allocated strings (strings short enough for the small string optimisation
+         * don't allocate) and compiled template segments, but not for allocator overhead.
+         */
+        size_t getResidentBytes(const entrydict_t::value_type& section) {
+            // libstdc++ and libc++ red-black tree nodes hold three pointers and a colour in front of the value
+            constexpr size_t MAP_NODE_OVERHEAD = 4 * sizeof(void*);
+            const auto heapBytes = [](const string& str) { return str.capacity() > string().capacity() ? str.capacity() + 1 : 0; };
+
+            auto bytes = MAP_NODE_OVERHEAD + sizeof(entrydict_t::value_type) + heapBytes(section.first);
+            for (const auto& field : section.second) {
+                const auto& entry = field.second;
+
+                bytes += MAP_NODE_OVERHEAD + sizeof(entrysect_t::value_type) + heapBytes(field.first) + heapBytes(entry.value) +
+                         entry.compiled.getSegments().capacity() * sizeof(compiled_template::segment_t);
+            }
+
+            return bytes;
+        }
+
+        /**
+         * @brief Parses a size hint; anything but a plain decimal number up to MAX_SIZE_HINT is ignored.
+         *
+         * @return size_t The hint, or 0 if it is invalid.
+         */
+        size_t parseSizeHint(string_view value) {
+            if (value.empty() || value.size() > 8) { return 0; }
+
+            size_t hint = 0;
+            for (const auto c : value) {
+                if (c < '0' || c > '9') { return 0; }
+                hint = hint * 10 + static_cast<size_t>(c - '0');
+            }
+
+            return hint <= language::MAX_SIZE_HINT ? hint : 0;
+        }
+
+        // The grammar of a borrfile is described by language::SECTION_REGEX, TRANSLATION_REGEX and VARIABLE_REGEX.
+        // std::regex backtracks recursively, so a single long or pathological line could stall (or overflow the stack of)
+        // a loader; the matchers below accept exactly the same lines in a single pass.
+
+        constexpr bool isNameStartChar(char c) { return c >= 'A' && c <= 'z'; } //!< Mirrors [A-z_]; '_' lies within A-z
+        constexpr bool isNameChar(char c) { return isNameStartChar(c) || (c >= '0' && c <= '9'); } //!< Mirrors [A-z0-9_]
+        constexpr bool isRegexSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r'; } //!< Mirrors \s
+
+        /**
+         * @brief Matches SECTION_REGEX: ^\[[A-z_]([A-z_]+)?\]$
+         */
+        bool matchesSection(string_view line) {
+            return line.size() >= 3 && line.front() == '[' && line.back() == ']' && std::all_of(line.begin() + 1, line.end() - 1, isNameStartChar);
+        }
+
+        /**
+         * @brief Matches TRANSLATION_REGEX: ^[A-z_][A-z0-9_]+(\[\])?[\s]+?=[\s]+?"([^"]+)?"$
+         *
+         * '[' and ']' lie within A-z, so the optional "[]" is already covered by the name.
+         */
+        bool matchesTranslation(string_view line) {
+            if (line.size() < 2 || !isNameStartChar(line[0])) { return false; }
+
+            size_t pos = 1;
+            while (pos < line.size() && isNameChar(line[pos])) { pos++; }
+            if (pos < 2) { return false; }
+
+            const auto skipSpaces = [&] {
+                const auto start = pos;
+                while (pos < line.size() && isRegexSpace(line[pos])) { pos++; }
+                return pos > start;
+            };
+
+            if (!skipSpaces() || pos >= line.size() || line[pos++] != '=') { return false; }
+            if (!skipSpaces() || pos >= line.size() || line[pos++] != '"') { return false; }
+
+            // the value may contain anything but a quote and must be followed by the closing quote
+            return line.find('"', pos) == line.size() - 1;
+        }
+
+        /**
+         * @brief Finds an inline comment as matched by #[^\n]+[^"]$; a comment extends to the end of the line.
+         *
+         * @return size_t The position of the comment's '#', or string_view::npos.
+         */
+        size_t findInlineComment(string_view line) {
+            if (line.size() < 3 || line.back() == '"') { return string_view::npos; }
+
+            // the comment can't span a line break, except as its final character
+            const auto lineBreak = line.substr(0, line.size() - 1).rfind('\n');
+            const auto commentPos = line.find('#', lineBreak == string_view::npos ? 0 : lineBreak + 1);
+
+            return commentPos != string_view::npos && commentPos + 3 <= line.size() ? commentPos : string_view::npos;
+        }
+
+        /**
+         * @brief Removes an inline comment from a line and trims it; see language::removeInlineComments().
+         */
+        string stripInlineComment(const string& line) {
+            const auto commentPos = findInlineComment(line);
+            return extensions::trim(commentPos == string_view::npos ? line : line.substr(0, commentPos));
+        }
+
+    }
+
+    /**
+     * @brief Holds the memory budget's lock for the duration of a lookup.
+     *
+     * Lookups nest (references and expanders call getString() again), so the lock is recursive;
+     * the budget is only enforced once the outermost lookup completes, so no section is evicted while
+     * a lookup further up the stack still points into it. Without a budget, this does nothing.
+     */
+    class language::budget_scope {
+        public:
+            explicit budget_scope(const language& lang): m_lang(lang) {
+                if (!m_lang.m_budget) { return; }
+
+                m_lock = std::unique_lock<std::recursive_mutex>(m_lang.m_budget->mutex);
+                m_lang.m_budget->depth++;
+            }
+
+            ~budget_scope() {
+                if (m_lock.owns_lock() && --m_lang.m_budget->depth == 0) { m_lang.enforceMemoryBudget(); }
+            }
+
+            budget_scope(const budget_scope&) = delete;
+            budget_scope& operator=(const budget_scope&) = delete;
+
+        private:
+            const language&                         m_lang;
+            std::unique_lock<std::recursive_mutex>  m_lock{};
+    };
+
+    /**
+     * @brief Reports the phases of a single load to the load tracer and the USDT probes.
+     *
+     * The probes (provider "libborr") are always fired; they cost a nop unless a tracer such as bpftrace is attached:
+     *  - load__start(source), load__done(source, translations), load__failed(source)
+     *  - phase__start(phase, name), phase__done(phase, name, items)
+     * Timestamps are only taken if a load tracer is set.
+     *
+     * Loads which are part of another load (fromFile() reads through fromStream()) are reported by the outermost trace.
+     */
+    class language::load_trace {
+        public:
+            using clock_t = std::chrono::steady_clock;
+
+            load_trace(language& lang, string source): m_lang(lang) {
+                if (m_lang.m_loadTrace != nullptr) { return; }
+
+                m_lang.m_loadTrace = this;
+                m_source = std::move(source);
+                m_tracer = std::atomic_load(&g_loadTracer);
+#if BORR_HAS_USDT
+                DTRACE_PROBE1(libborr, load__start, m_source.c_str());
+#endif
+                m_start = now();
+            }
+
+            ~load_trace() {
+                if (m_lang.m_loadTrace != this) { return; }
+
+                m_lang.m_loadTrace = nullptr;
+#if BORR_HAS_USDT
+                if (!m_finished) { DTRACE_PROBE1(libborr, load__failed, m_source.c_str()); }
+#endif
+            }
+
+            load_trace(const load_trace&) = delete;
+            load_trace& operator=(const load_trace&) = delete;
+
+            clock_t::time_point begin(loadphase_t phase, const char* name = "") const {
+#if BORR_HAS_USDT
+                DTRACE_PROBE2(libborr, phase__start, static_cast<int>(phase), name);
+#else
+                (void)phase;
+                (void)name;
+#endif
+                return now();
+            }
+
+            void end(loadphase_t phase, clock_t::time_point start, size_t items, const char* name = "") const {
+#if BORR_HAS_USDT
+                DTRACE_PROBE3(libborr, phase__done, static_cast<int>(phase), name, items);
+#endif
+                if (m_tracer) { (*m_tracer)(loadevent_t{ phase, name, start, clock_t::now() - start, items }); }
+            }
+
+            void beginSection(const string& section) {
+                endSection();
+
+                m_section = section;
+                m_sectionStart = begin(loadphase_t::Section, m_section.c_str());
+                m_inSection = true;
+            }
+
+            void endSection() {
+                if (!m_inSection) { return; }
 
-    varcbacklist_t language::_defaultExpandersList = {
-        { "date", dateExpander },
-        { "time", timeExpander },
-        { "lib", libExpander },
-        { "os", osExpander },
-        { "liburl", liburlExpander },
+                const auto sectPos = m_lang.m_translationDict.find(m_section);
+                end(loadphase_t::Section, m_sectionStart, sectPos == m_lang.m_translationDict.end() ? 0 : sectPos->second.size(), m_section.c_str());
+                m_inSection = false;
+            }
+
+            void finish(size_t translations) {
+#if BORR_HAS_USDT
+                DTRACE_PROBE2(libborr, load__done, m_source.c_str(), translations);
+#endif
+                if (m_tracer) { (*m_tracer)(loadevent_t{ loadphase_t::Load, m_source, m_start, clock_t::now() - m_start, translations }); }
+                m_finished = true;
+            }
+
+            clock_t::time_point now() const { return m_tracer ? clock_t::now() : clock_t::time_point{}; }
+
+        private:
+            language&                               m_lang;
+            string                                  m_source{}; //!< Where the language is loaded from
+            std::shared_ptr<const loadtracer_t>     m_tracer{}; //!< The tracer, taken once per load
+            clock_t::time_point                     m_start{}; //!< When the load started
+            string                                  m_section{}; //!< The section block currently being parsed
+            clock_t::time_point                     m_sectionStart{}; //!< When the current section block started
+            bool                                    m_inSection{false}; //!< Whether a section block is open
+            bool                                    m_finished{false}; //!< Whether the load completed
     };
 
+    expander_registry language::_expanderRegistry = [] {
+        expander_registry registry{};
+        registry.addDefault("date", dateExpander);
+        registry.addDefault("time", timeExpander);
+        registry.addDefault("lib", libExpander);
+        registry.addDefault("os", osExpander);
+        registry.addDefault("liburl", liburlExpander);
+
+        return registry;
+    }();
+
     /**
      * @brief Parses a borrfile and ensures its contents are parsed into the given object reference.
      * 
      * @param file The file to parse.
      */
     language language::fromFile(const fs::directory_entry& file) {
+        language outLang{};
+        fromFile(file, outLang);
+
+        return outLang;
+    }
+
+    /**
+     * @brief Parses a string object into a language instance.
+     * 
+     * @param fContents The string (file contents) to parse.
+     * 
+     * @throws runtime_error If an error occurred. TODO: Custom exceptions.
+     */
+    language language::fromString(const string& fContents) {
+        language outLang{};
+        fromString(fContents, outLang);
+
+        return outLang;
+    }
+
+    /**
+     * @brief Parses a borrfile into an existing language object.
+     * 
+     * @param file The file to parse.
+     * @param outLang The language to parse the file into. Any previous contents are cleared.
+     */
+    void language::fromFile(const fs::directory_entry& file, language& outLang) {
         if (!file.exists() || !file.is_regular_file()) {
             throw fs::filesystem_error("Invalid file path given!", file.path(), error_code(EINVAL, std::generic_category()));
         }
 
-        ifstream inStream(file.path());
-        stringstream fContents{};
+        load_trace trace(outLang, file.path().string());
 
-        fContents << inStream.rdbuf();
+        ifstream inStream(file.path(), std::ios::binary);
+        if (!inStream.is_open()) {
+            throw fs::filesystem_error("Failed to open file!", file.path(), error_code(EACCES, std::generic_category()));
+        }
 
-        return fromString(fContents.str());
+        fromStream(inStream, outLang);
     }
 
     /**
-     * @brief Parses a string object into a language instance.
+     * @brief Parses a string object into an existing language object.
+     * 
+     * Once all lines have been parsed, the templates of all translations are compiled and bound,
+     * so variables are only resolved once per load.
      * 
      * @param fContents The string (file contents) to parse.
+     * @param outLang The language to parse the string into. Any previous contents are cleared.
      * 
      * @throws runtime_error If an error occurred. TODO: Custom exceptions.
      */
-    language language::fromString(const string& fContents) {
-        language outLang{};
-        vector<string> tokens;
-        if (!extensions::splitString(fContents, "\n", tokens)) {
+    void language::fromString(const string& fContents, language& outLang) {
+        const auto startTime = std::chrono::steady_clock::now();
+        load_trace ownTrace(outLang, "string");
+        auto& trace = *outLang.m_loadTrace;
+        outLang.clear();
+
+        const auto parseStart = trace.begin(loadphase_t::Parse);
+        string pendingLine{};
+        auto lineCount = outLang.parseChunk(fContents, pendingLine, 0);
+        if (!pendingLine.empty()) {
+            outLang.parseLine(pendingLine);
+            lineCount++;
+        }
+        trace.endSection();
+        trace.end(loadphase_t::Parse, parseStart, lineCount);
+
+        if (lineCount == 0) {
             throw std::runtime_error("Failed to split input string! Are newlines missing?");
         }
 
+        outLang.finishLoad(trace);
+        outLang.m_metrics.recordLoad(std::chrono::steady_clock::now() - startTime);
+    }
+
+    /**
+     * @brief Parses a language file from a stream into a language instance.
+     * 
+     * @param inStream The stream to read from.
+     * @param options Controls the buffer size and maximum line length.
+     */
+    language language::fromStream(std::istream& inStream, const streamopts_t& options /*= {}*/) {
+        language outLang{};
+        fromStream(inStream, outLang, options);
+
+        return outLang;
+    }
+
+    /**
+     * @brief Parses a language file from a stream into an existing language object.
+     * 
+     * The stream is read through a single buffer of options.bufferSize bytes, which is reused for the entire stream,
+     * and every line is parsed as soon as it is complete. The input is never held in memory in its entirety,
+     * so peak memory is the translation table plus the buffer and the longest line.
+     * This makes it suitable for decompressing or decrypting stream wrappers.
+     * 
+     * @param inStream The stream to read from. It is read until EOF.
+     * @param outLang The language to parse the stream into. Any previous contents are cleared.
+     * @param options Controls the buffer size and maximum line length.
+     * 
+     * @throws runtime_error If the stream couldn't be read, contains no lines or a line exceeds options.maxLineLength.
+     */
+    void language::fromStream(std::istream& inStream, language& outLang, const streamopts_t& options /*= {}*/) {
+        const auto startTime = std::chrono::steady_clock::now();
+        load_trace ownTrace(outLang, "stream");
+        auto& trace = *outLang.m_loadTrace;
         outLang.clear();
 
-        for (const auto& line : tokens) {
-            outLang.parseLine(line);
+        vector<char> buffer(std::max<size_t>(options.bufferSize, 1));
+        string pendingLine{};
+        size_t lineCount = 0;
+
+        // reading and parsing are interleaved, so the parse phase includes all reads
+        const auto parseStart = trace.begin(loadphase_t::Parse);
+        for (;;) {
+            // every started read is completed, including the final one which only hits EOF, so probes stay balanced
+            const auto readStart = trace.begin(loadphase_t::Read);
+            const auto hasData = inStream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || inStream.gcount() > 0;
+            trace.end(loadphase_t::Read, readStart, static_cast<size_t>(std::max<std::streamsize>(inStream.gcount(), 0)));
+            if (!hasData) { break; }
+
+            lineCount += outLang.parseChunk(string_view(buffer.data(), static_cast<size_t>(inStream.gcount())), pendingLine, options.maxLineLength);
+        }
+
+        if (inStream.bad()) {
+            throw std::runtime_error("Failed to read from stream!");
+        }
+
+        if (!pendingLine.empty()) {
+            outLang.parseLine(pendingLine);
+            lineCount++;
+        }
+        trace.endSection();
+        trace.end(loadphase_t::Parse, parseStart, lineCount);
+
+        if (lineCount == 0) {
+            throw std::runtime_error("Failed to read any lines from stream!");
+        }
+
+        outLang.finishLoad(trace);
+        outLang.m_metrics.recordLoad(std::chrono::steady_clock::now() - startTime);
+    }
+
+    /**
+     * @brief Maps a GNU gettext .mo catalog into a language instance.
+     * 
+     * @param file The .mo file to map.
+     */
+    language language::fromMoFile(const fs::directory_entry& file) {
+        language outLang{};
+        fromMoFile(file, outLang);
+
+        return outLang;
+    }
+
+    /**
+     * @brief Maps a GNU gettext .mo catalog into an existing language object.
+     * 
+     * The catalog isn't parsed; lookups which aren't found in the (empty) translation dictionary
+     * are answered from the catalog's own hash table. Message contexts (msgctxt) map to sections;
+     * messages without a context are found in the section "".
+     * 
+     * The language ID and description are taken from the "Language" and "Project-Id-Version" header fields.
+     * 
+     * @param file The .mo file to map.
+     * @param outLang The language to map the catalog into. Any previous contents are cleared.
+     * 
+     * @throws fs::filesystem_error If the file doesn't exist or can't be opened.
+     * @throws runtime_error If the file isn't a valid .mo file.
+     */
+    void language::fromMoFile(const fs::directory_entry& file, language& outLang) {
+        if (!file.exists() || !file.is_regular_file()) {
+            throw fs::filesystem_error("Invalid file path given!", file.path(), error_code(EINVAL, std::generic_category()));
         }
 
+        const auto startTime = std::chrono::steady_clock::now();
+        load_trace trace(outLang, file.path().string());
+
+        const auto readStart = trace.begin(loadphase_t::Read);
+        auto catalog = mo_catalog::fromFile(file.path());
+        trace.end(loadphase_t::Read, readStart, catalog->getMappedSize());
+
+        outLang.clear();
+        outLang.m_langId = catalog->getHeaderField("Language");
+        outLang.m_langDescription = catalog->getHeaderField("Project-Id-Version");
+        outLang.m_moCatalog = std::move(catalog);
+
+        trace.finish(outLang.m_moCatalog->size());
+        outLang.m_metrics.recordLoad(std::chrono::steady_clock::now() - startTime);
+    }
+
+    /**
+     * @brief Loads a language pack compiled by borrc.
+     * 
+     * @param file The pack to load.
+     */
+    language language::fromPackFile(const fs::directory_entry& file) {
+        language outLang{};
+        fromPackFile(file, outLang);
+
         return outLang;
     }
 
+    /**
+     * @brief Loads a language pack compiled by borrc into an existing language object.
+     * 
+     * Packs contain already parsed translations in sorted order, so no lines are matched against regular expressions
+     * and every translation is appended to the end of its section.
+     * Templates are compiled once all translations have been loaded, exactly as with fromString().
+     * The pack stays mapped, so sections evicted under a memory budget are re-materialised from it.
+     * 
+     * @param file The pack to load.
+     * @param outLang The language to load the pack into. Any previous contents are cleared.
+     * 
+     * @throws fs::filesystem_error If the file doesn't exist or can't be opened.
+     * @throws runtime_error If the file isn't a valid language pack.
+     */
+    void language::fromPackFile(const fs::directory_entry& file, language& outLang) {
+        if (!file.exists() || !file.is_regular_file()) {
+            throw fs::filesystem_error("Invalid file path given!", file.path(), error_code(EINVAL, std::generic_category()));
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        load_trace trace(outLang, file.path().string());
+        outLang.clear();
+
+        auto& dict = outLang.m_translationDict;
+        auto sectPos = dict.end();
+
+        std::shared_ptr<const lang_pack> pack{};
+        try {
+            const auto readStart = trace.begin(loadphase_t::Read);
+            pack = lang_pack::fromFile(file.path());
+            trace.end(loadphase_t::Read, readStart, pack->getSize());
+
+            const auto parseStart = trace.begin(loadphase_t::Parse);
+            pack->visitAll([&](string_view section, string_view field, string_view value) {
+                if (sectPos == dict.end() || sectPos->first != section) {
+                    sectPos = dict.emplace_hint(dict.end(), string(section), entrysect_t{});
+                    trace.beginSection(sectPos->first);
+                }
+
+                sectPos->second.emplace_hint(sectPos->second.end(), string(field), entry_t{ string(value) });
+            });
+            trace.endSection();
+            trace.end(loadphase_t::Parse, parseStart, pack->getEntryCount());
+        } catch (...) {
+            outLang.clear(); // don't leave a partially loaded pack behind
+            throw;
+        }
+
+        // the mapping stays open so sections evicted under a memory budget can be re-materialised from it
+        const auto& meta = pack->getMeta();
+        outLang.m_backingPack = std::move(pack);
+
+        outLang.m_langId = meta.langId;
+        outLang.m_langDescription = meta.langDescription;
+        if (!meta.langVersion.empty()) { langversion::fromString(meta.langVersion, outLang.m_langVer); }
+
+        outLang.finishLoad(trace);
+        outLang.m_metrics.recordLoad(std::chrono::steady_clock::now() - startTime);
+    }
+
+    /**
+     * @brief Sets the tracer which receives the phases of all subsequent loads, of all languages.
+     * 
+     * The tracer is called synchronously on the loading thread, once per completed phase; see loadphase_t.
+     * Loads which are already running keep the tracer they started with.
+     * Independently of the tracer, every load fires USDT probes where the platform supports them.
+     * 
+     * @param tracer The tracer; an empty function disables tracing.
+     */
+    void language::setLoadTracer(loadtracer_t tracer) {
+        std::atomic_store(&g_loadTracer, tracer ? std::make_shared<const loadtracer_t>(std::move(tracer)) : std::shared_ptr<const loadtracer_t>{});
+    }
+
+    /**
+     * @brief Reads the header of a language file without loading its translations.
+     * 
+     * For borrfiles, only the lines in front of the first section are read; fields other than
+     * lang_id, lang_ver and lang_desc are returned in langmeta_t::fields.
+     * For language packs, only the pack header is read.
+     * This is much cheaper than a full load when scanning many languages, e.g. to list them or to check their versions.
+     * 
+     * @param path The borrfile or language pack to read.
+     * 
+     * @return langmeta_t The header of the language.
+     * 
+     * @throws fs::filesystem_error If the file doesn't exist or can't be opened.
+     * @throws runtime_error If the file is a corrupt language pack.
+     */
+    langmeta_t language::peekMetadata(const fs::path& path) {
+        if (!fs::is_regular_file(path)) {
+            throw fs::filesystem_error("Invalid file path given!", path, error_code(EINVAL, std::generic_category()));
+        }
+
+        ifstream inStream(path, std::ios::binary);
+        if (!inStream.is_open()) {
+            throw fs::filesystem_error("Failed to open file!", path, error_code(EACCES, std::generic_category()));
+        }
+
+        langmeta_t meta{};
+
+        char magic[lang_pack::PACK_MAGIC.size()]{};
+        if (inStream.read(magic, sizeof(magic)) && string_view(magic, sizeof(magic)) == lang_pack::PACK_MAGIC) {
+            const auto pack = lang_pack::fromFile(path);
+            const auto& packMeta = pack->getMeta();
+
+            meta.langId = packMeta.langId;
+            meta.langDescription = packMeta.langDescription;
+            if (!packMeta.langVersion.empty()) { langversion::fromString(packMeta.langVersion, meta.langVer); }
+
+            return meta;
+        }
+
+        inStream.clear();
+        inStream.seekg(0);
+
+        string line{};
+        while (std::getline(inStream, line)) {
+            const auto trimmedLine = stripInlineComment(line);
+            if (trimmedLine.empty() || trimmedLine.front() == '#') { continue; }
+            if (trimmedLine.front() == '[') { break; } // the translations start here
+
+            if (!matchesTranslation(trimmedLine)) { continue; }
+
+            const auto posOfDelim = trimmedLine.find('=');
+            auto field = extensions::trim(trimmedLine.substr(0, posOfDelim - 1));
+            auto value = extensions::trim(trimmedLine.substr(posOfDelim + 1), "\" \t\r");
+
+            if (field == LANG_ID_FIELD) {
+                meta.langId = std::move(value);
+            } else if (field == LANG_VER_FIELD) {
+                langversion::fromString(value, meta.langVer);
+            } else if (field == LANG_DESC_FIELD) {
+                meta.langDescription = std::move(value);
+            } else if (field == LANG_SECTIONS_FIELD) {
+                meta.sizeHints.sections = parseSizeHint(value);
+            } else if (field == LANG_KEYS_FIELD) {
+                meta.sizeHints.keys = parseSizeHint(value);
+            } else {
+                meta.fields[std::move(field)] = std::move(value);
+            }
+        }
+
+        return meta;
+    }
+
     /**
      * @brief Default constructor.
      */
-    language::language() { }
+    language::language(): m_generation(nextGeneration()) { }
+
+    /**
+     * @brief Copy constructor.
+     * 
+     * Resolved references point into the translation dictionary they were resolved in,
+     * so they are resolved again against the copied dictionary.
+     * If the other language has a memory budget, it is locked while it is copied and the copy gets the same budget.
+     * 
+     * @param other The language to copy.
+     */
+    language::language(const language& other): language(other, other.lockBudget()) { }
+
+    /**
+     * @brief Copies a language while its memory budget (if any) is locked by otherLock.
+     */
+    language::language(const language& other, std::unique_lock<std::recursive_mutex> /*otherLock*/):
+        m_translationDict(other.m_translationDict),
+        m_langVer(other.m_langVer),
+        m_currentSection(other.m_currentSection),
+        m_langId(other.m_langId),
+        m_langDescription(other.m_langDescription),
+        m_referencesResolved(other.m_referencesResolved),
+        m_accessProfile(other.m_accessProfile),
+        m_renderProfiler(other.m_renderProfiler),
+        m_hotIndex(other.m_hotIndex),
+        m_moCatalog(other.m_moCatalog),
+        m_metrics(other.m_metrics),
+        m_backingPack(other.m_backingPack),
+        m_pinnedSections(other.m_pinnedSections),
+        m_generation(nextGeneration()),
+        m_fingerprint(std::atomic_load(&other.m_fingerprint)),
+        m_loadStats(other.m_loadStats) {
+        if (other.m_budget) {
+            m_budget = std::make_unique<membudget_t>();
+            m_budget->budgetBytes = other.m_budget->budgetBytes;
+            m_budget->residentBytes = other.m_budget->residentBytes.load();
+            m_budget->residentSections = other.m_budget->residentSections.load();
+            m_budget->clock = other.m_budget->clock;
+            m_budget->sections = other.m_budget->sections;
+        }
+
+        if (m_referencesResolved) { resolveReferences(); }
+        if (!m_hotIndex.empty()) {
+            m_hotIndex.rebind([this](const string& section, const string& field) { return findEntry(section, field); });
+        }
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     * 
+     * @param other The language to copy.
+     * 
+     * @return language& A reference to this instance.
+     */
+    language& language::operator=(const language& other) {
+        if (this != &other) {
+            *this = language(other);
+        }
+
+        return *this;
+    }
 
     /**
      * @brief Allows a user to add custom variable expansion callbacks.
@@ -112,7 +812,18 @@ namespace borr {
      * @return false Otherwise.
      */
     bool language::addVarExpansionCallback(const string& varName, const varexpansioncallback_t& cb) {
-        return _callbackList.try_emplace(varName, static_cast<varexpansioncallback_t>(cb)).second;
+        return _expanderRegistry.addCallback(varName, cb);
+    }
+
+    /**
+     * @brief Freezes the list of variable expanders.
+     * 
+     * Once frozen, callbacks can only be added for variable names which are already known (such as the default expanders),
+     * but lookups use a minimal perfect hash and templates loaded afterwards never resolve variables by name.
+     * Call this once all callbacks have been registered at startup.
+     */
+    void language::freezeVarExpansionCallbacks() {
+        _expanderRegistry.freeze();
     }
 
     /**
@@ -127,16 +838,12 @@ namespace borr {
      * @return false Otherwise.
      */
     bool language::containsVariable(const string& translation, string& outVarName) const {
-        namespace rc = std::regex_constants;
-        const static regex VAR_REGEX(VARIABLE_REGEX.data(), rc::optimize);
-
-        smatch matches;
-        if (std::regex_search(translation, matches, VAR_REGEX)) {
-            outVarName = extensions::trim(extensions::trim(*matches.begin(), "$"), "{}");
-            return true;
-        }
+        size_t nameLength = 0;
+        const auto varPos = compiled_template::findVariable(translation, 0, nameLength);
+        if (varPos == string::npos) { return false; }
 
-        return false;
+        outVarName = translation.substr(varPos + 2, nameLength);
+        return true;
     }
 
     /**
@@ -181,8 +888,7 @@ namespace borr {
      * @return false Otherwise.
      */
     bool language::isSection(const string& line, string& outSection) const {
-        namespace rc = std::regex_constants;
-        if (!std::regex_match(extensions::trim(line), regex(SECTION_REGEX.data(), rc::optimize))) { return false; }
+        if (!matchesSection(extensions::trim(line))) { return false; }
 
         outSection = extensions::trim(line, "[]");
         return true;
@@ -199,8 +905,7 @@ namespace borr {
      * @return false Otherwise.
      */
     bool language::isTranslation(const string& line, string& outFieldName, string& outTranslation) const {
-        namespace rc = std::regex_constants;
-        if (!std::regex_match(line, regex(TRANSLATION_REGEX.data(), rc::optimize))) { return false; }
+        if (!matchesTranslation(line)) { return false; }
 
         // Now just split the string at the first '=' and return the two halfs
         const auto posOfDelim = line.find('=');
@@ -220,60 +925,786 @@ namespace borr {
      * @return optsect_t An optional<map<string, string>> which either contains the section or is nullopt if section was not found.
      */
     optsect_t language::getSection(const string& sectionName) const {
+        const budget_scope scope(*this);
+        if (m_budget) { ensureResident(sectionName); }
+
         const auto iterPos = m_translationDict.find(sectionName);
 
-        if (iterPos == m_translationDict.end()) { return {}; }
+        if (iterPos == m_translationDict.end()) { return getMoSection(sectionName); }
+
+        sect_t section{};
+        for (const auto& field : iterPos->second) {
+            section.emplace_hint(section.end(), field.first, field.second.value);
+        }
 
-        return iterPos->second;
+        return section;
     }
 
     /**
-     * @brief Gets a single string from the translation table.
-     * 
-     * @remarks Variables @b ARE expanded here if expandVariables is true!
+     * @brief Gets the names of all sections of this language.
      * 
-     * @param section The name of the section in which to search for the translation.
-     * @param field The name of the translation you're looking for.
-     * @param expandVariables Whether or not to expand variables (default: true)
+     * @remarks Sections of a mapped .mo catalog aren't included. Evicted sections are.
      * 
-     * @returns An optional<string> which contains the translation or nullopt, depending on whether the translation was found or not.
+     * @return vector<string> The section names, in sorted order.
      */
-    optstr_t language::getString(const string& section, const string& field, bool expandVariables /*= true*/) const {
-        const auto sect = getSection(section);
-        if (!sect.has_value()) { return {}; }
+    vector<string> language::getSectionNames() const {
+        const auto lock = lockBudget();
+        vector<string> names{};
 
-        if (const auto iterPos = sect.value().find(field); iterPos != sect.value().end()) {
-            auto translation = iterPos->second;
-            string varName{};
-            while (containsVariable(translation, varName)) {
-                extensions::stringReplace(translation, "${" + varName + "}", expandVariable(varName));
-            }
+        if (m_budget) {
+            names.reserve(m_budget->sections.size());
+            for (const auto& section : m_budget->sections) { names.push_back(section.first); }
 
-            return translation;
+            return names;
         }
 
-        return {};
+        names.reserve(m_translationDict.size());
+        for (const auto& section : m_translationDict) { names.push_back(section.first); }
+
+        return names;
     }
 
     /**
-     * @brief Expands a given variable if a possible expander was found.
+     * @brief Visits every translation of this language, ordered by section and field, without copying it.
+     * 
+     * The entry holds the raw value and its compiled template, so variables can be inspected without searching for them again.
+     * Under a memory budget, evicted sections are re-materialised one at a time and the budget is enforced after each section,
+     * so the entries must not be used after the visitor returns.
+     * 
+     * @remarks Sections of a mapped .mo catalog aren't visited.
+     * 
+     * @param visitor The visitor to call for each translation.
+     */
+    void language::visitTranslations(const entryvisitor_t& visitor) const {
+        const auto visitSection = [&](const entrydict_t::value_type& section) {
+            for (const auto& field : section.second) { visitor(section.first, field.first, field.second); }
+        };
+
+        if (!m_budget) {
+            for (const auto& section : m_translationDict) { visitSection(section); }
+            return;
+        }
+
+        for (const auto& sectionName : getSectionNames()) {
+            const budget_scope scope(*this);
+            ensureResident(sectionName);
+
+            if (const auto sectPos = m_translationDict.find(sectionName); sectPos != m_translationDict.end()) { visitSection(*sectPos); }
+        }
+    }
+
+    /**
+     * @brief Gets a hash of the header and all translations of this language.
+     * 
+     * The ID, version and description are hashed first, followed by every section, field and raw value in sorted order
+     * (and every message of a mapped .mo catalog, in catalog order).
+     * Languages with equal contents therefore have equal fingerprints, regardless of the source they were loaded from,
+     * the process or the platform, so the fingerprint can be used to validate cached renders across servers.
+     * 
+     * The fingerprint is computed on first use, so loads (especially of mapped catalogs) don't pay for it.
+     * 
+     * @return uint64_t The fingerprint; never 0.
+     */
+    uint64_t language::getFingerprint() const {
+        if (const auto fingerprint = std::atomic_load(&m_fingerprint)) { return *fingerprint; }
+
+        // concurrent readers compute the same value, so it doesn't matter which one is kept
+        const auto fingerprint = std::make_shared<const uint64_t>(computeFingerprint());
+        std::atomic_store(&m_fingerprint, fingerprint);
+
+        return *fingerprint;
+    }
+
+    /**
+     * @brief Hashes the header and all translations of this language; see getFingerprint().
+     */
+    uint64_t language::computeFingerprint() const {
+        auto fingerprint = mixFingerprint(0, m_langId);
+        fingerprint = mixFingerprint(fingerprint, getPackMeta(0).langVersion);
+        fingerprint = mixFingerprint(fingerprint, m_langDescription);
+
+        visitTranslations([&fingerprint](const string& section, const string& field, const entry_t& entry) {
+            fingerprint = mixFingerprint(mixFingerprint(mixFingerprint(fingerprint, section), field), entry.value);
+        });
+
+        if (m_moCatalog) {
+            for (size_t i = 0; i < m_moCatalog->size(); i++) {
+                string_view context{};
+                string_view msgid{};
+                string_view translation{};
+                if (!m_moCatalog->getEntry(i, context, msgid, translation)) { continue; }
+
+                fingerprint = mixFingerprint(mixFingerprint(mixFingerprint(fingerprint, context), msgid), translation);
+            }
+        }
+
+        return fingerprint == 0 ? 1 : fingerprint;
+    }
+
+    /**
+     * @brief Gets key counts and an estimate of the memory used by this language.
+     * 
+     * The resident size accounts for map nodes, heap-allocated strings (strings short enough for the
+     * small string optimisation don't allocate), compiled template segments and the hot index.
+     * Allocator overhead isn't included, so the actual usage is slightly higher.
+     * A mapped .mo catalog is reported separately, as its pages are shared with the page cache.
+     * Key counts and sizes are computed once per load and residency is tracked by counters, so this neither walks the
+     * translation tables nor takes the budget's lock; it never stalls concurrent lookups.
+     * They describe all loaded translations, including evicted ones; under a memory budget, the section count and
+     * the resident size only describe resident sections, as of their last materialisation.
+     * 
+     * @return langstats_t The statistics.
+     */
+    langstats_t language::getStats() const {
+        auto stats = m_loadStats;
+        stats.hotKeys = m_hotIndex.size();
+
+        // sections are only added to or removed from the residency map by loads, so its size is stable while reading
+        if (m_budget) {
+            stats.sections = m_budget->residentSections;
+            stats.residentBytes = m_budget->residentBytes;
+            stats.evictedSections = m_budget->sections.size() - stats.sections;
+        }
+
+        stats.residentBytes += m_hotIndex.getResidentBytes();
+        if (const auto keyIndex = std::atomic_load(&m_keyIndex)) { stats.residentBytes += keyIndex->getResidentBytes(); }
+
+        if (m_moCatalog) {
+            stats.moMessages = m_moCatalog->size();
+            stats.moMappedBytes = m_moCatalog->getMappedSize();
+        }
+
+        return stats;
+    }
+
+    /**
+     * @brief Writes this language as a language pack, which can be loaded with fromPackFile().
+     * 
+     * @remarks Translations of a mapped .mo catalog aren't included.
+     * 
+     * @param path The path to write the pack to.
+     * @param sourceHash The content hash of the borrfile this language was parsed from (see lang_pack::hashContents()).
+     * 
+     * @throws fs::filesystem_error If the file couldn't be written.
+     */
+    void language::toPackFile(const fs::path& path, uint64_t sourceHash /*= 0*/) const {
+        lang_pack::writeFile(path, getPackMeta(sourceHash), getPackEntries());
+    }
+
+    /**
+     * @brief Gets the metadata of this language as it is written to language packs.
+     * 
+     * @param sourceHash The content hash of the borrfile this language was parsed from.
+     * 
+     * @return packmeta_t The metadata.
+     */
+    packmeta_t language::getPackMeta(uint64_t sourceHash) const {
+        packmeta_t meta{};
+        meta.langId = m_langId;
+        meta.langDescription = m_langDescription;
+        meta.sourceHash = sourceHash;
+        if (m_langVer.getMajorVersion() != string::npos) {
+            meta.langVersion = std::to_string(m_langVer.getMajorVersion()) + "." +
+                               std::to_string(m_langVer.getMinorVersion()) + "." +
+                               std::to_string(m_langVer.getRevision());
+        }
+
+        return meta;
+    }
+
+    /**
+     * @brief Gets all translations of this language as pack entries.
+     * 
+     * Sections which are evicted under a memory budget are read from the backing pack without re-materialising them.
+     * 
+     * @return vector<packentry_t> The raw translations, in no particular order.
+     */
+    vector<packentry_t> language::getPackEntries() const {
+        const auto lock = lockBudget();
+        vector<packentry_t> entries{};
+
+        if (m_budget && m_backingPack) {
+            entries.reserve(m_backingPack->getEntryCount());
+        } else {
+            size_t entryCount = 0;
+            for (const auto& section : m_translationDict) { entryCount += section.second.size(); }
+            entries.reserve(entryCount);
+        }
+
+        for (const auto& section : m_translationDict) {
+            for (const auto& field : section.second) {
+                entries.push_back({ section.first, field.first, field.second.value });
+            }
+        }
+
+        if (m_budget && m_backingPack) {
+            for (const auto& section : m_budget->sections) {
+                if (section.second.resident) { continue; }
+
+                m_backingPack->visitSection(section.first, [&entries](string_view sectionName, string_view field, string_view value) {
+                    entries.push_back({ string(sectionName), string(field), string(value) });
+                });
+            }
+        }
+
+        return entries;
+    }
+
+    /**
+     * @brief Limits the estimated resident size of the translation tables.
+     * 
+     * Once the budget is exceeded, the least recently used sections are evicted from the translation dictionary
+     * until the tables fit again. Evicted sections are re-materialised transparently on their next access:
+     * from the mapped pack for languages loaded with fromPackFile(), otherwise from a compact in-memory pack
+     * which is serialised from the translations when the budget is set (and after every reload).
+     * 
+     * Pinned sections (see pinSection()) and sections with translations in the hot index are never evicted.
+     * The budget is a target, not a hard limit: a single lookup may temporarily exceed it, and it can't be met
+     * if the pinned sections alone exceed it. The hot index and a mapped .mo catalog aren't counted.
+     * 
+     * With a budget, lookups are serialised by a mutex and references are never bound directly to their
+     * target translations (see warm()); languages without a budget are unaffected.
+     * 
+     * @remarks This member function modifies the language and must not be called while other threads read from it!
+     * 
+     * @param bytes The maximum estimated resident size in bytes. 0 removes the budget and re-materialises all evicted sections.
+     */
+    void language::setMemoryBudget(size_t bytes) {
+        // handles may only cache entries while no sections can be evicted
+        if ((bytes == 0) == (m_budget != nullptr)) {
+            m_keyIndex.reset();
+            m_generation = nextGeneration();
+        }
+
+        if (bytes == 0) {
+            if (!m_budget) { return; }
+
+            for (const auto& section : m_budget->sections) { ensureResident(section.first); }
+            m_budget.reset();
+
+            return;
+        }
+
+        if (m_budget) {
+            m_budget->budgetBytes = bytes;
+            enforceMemoryBudget();
+
+            return;
+        }
+
+        // bound references may point into sections which are about to be evicted
+        if (m_referencesResolved) { compileTemplates(); }
+
+        m_budget = std::make_unique<membudget_t>();
+        m_budget->budgetBytes = bytes;
+        rebuildResidency();
+    }
+
+    /**
+     * @brief Pins a section, so it is never evicted under a memory budget.
+     * 
+     * The section doesn't need to exist yet; pins are kept across reloads.
+     * If the section is currently evicted, it is re-materialised on its next access and then stays resident.
+     * 
+     * @param section The name of the section to pin.
+     */
+    void language::pinSection(const string& section) {
+        const auto lock = lockBudget();
+        m_pinnedSections.insert(section);
+    }
+
+    /**
+     * @brief Unpins a section, so it may be evicted under a memory budget again.
+     * 
+     * @param section The name of the section to unpin.
+     */
+    void language::unpinSection(const string& section) {
+        const auto lock = lockBudget();
+        m_pinnedSections.erase(section);
+        enforceMemoryBudget();
+    }
+
+    /**
+     * @brief Determines whether a section is pinned.
+     * 
+     * @param section The name of the section.
+     * 
+     * @return true If the section is pinned.
+     */
+    bool language::isSectionPinned(const string& section) const {
+        const auto lock = lockBudget();
+        return m_pinnedSections.count(section) != 0;
+    }
+
+    /**
+     * @brief Initialises the residency of all sections after a load and enforces the memory budget.
+     * 
+     * Languages which weren't loaded from a pack get an in-memory pack of their translations,
+     * from which evicted sections are re-materialised.
+     */
+    void language::rebuildResidency() {
+        if (!m_budget) { return; }
+
+        m_budget->sections.clear();
+        m_budget->residentBytes = 0;
+        m_budget->residentSections = 0;
+        if (m_translationDict.empty()) { return; }
+
+        if (!m_backingPack) { m_backingPack = lang_pack::fromString(lang_pack::writeString(getPackMeta(0), getPackEntries())); }
+
+        for (const auto& section : m_translationDict) {
+            const auto bytes = getResidentBytes(section);
+
+            m_budget->sections.emplace_hint(m_budget->sections.end(), section.first, sectionresidency_t{ bytes, 0, true });
+            m_budget->residentBytes += bytes;
+            m_budget->residentSections++;
+        }
+
+        enforceMemoryBudget();
+    }
+
+    /**
+     * @brief Re-materialises a section from the backing pack if it was evicted, and marks it as recently used.
+     * 
+     * Templates of re-materialised translations are compiled and bound, exactly as after a load.
+     * 
+     * @param section The name of the section.
+     */
+    void language::ensureResident(const string& section) const {
+        using counter_t = lang_metrics::counter_t;
+
+        const std::lock_guard<std::recursive_mutex> lock(m_budget->mutex);
+        const auto state = m_budget->sections.find(section);
+        if (state == m_budget->sections.end()) { return; }
+
+        state->second.lastUse = ++m_budget->clock;
+        if (state->second.resident) { return; }
+
+        // every access to the dictionary of a budgeted language holds the budget's lock
+        auto& dict = const_cast<entrydict_t&>(m_translationDict);
+        const auto sectPos = dict.emplace(section, entrysect_t{}).first;
+        auto& entries = sectPos->second;
+
+        m_backingPack->visitSection(section, [&entries](string_view, string_view field, string_view value) {
+            auto& entry = entries.emplace_hint(entries.end(), string(field), entry_t{ string(value) })->second;
+
+            entry.compiled = compiled_template::compile(entry.value);
+            entry.compiled.bind(entry.value, _expanderRegistry);
+        });
+
+        state->second.resident = true;
+        state->second.bytes = getResidentBytes(*sectPos);
+        m_budget->residentBytes += state->second.bytes;
+        m_budget->residentSections++;
+        m_metrics.add(counter_t::Rematerialisations);
+    }
+
+    /**
+     * @brief Evicts the least recently used sections until the translation tables fit into the memory budget.
+     * 
+     * Pinned sections and sections with translations in the hot index are skipped.
+     * The caller must hold the budget's lock, and no pointers into the dictionary may be in use.
+     */
+    void language::enforceMemoryBudget() const {
+        using counter_t = lang_metrics::counter_t;
+
+        if (!m_budget || m_budget->residentBytes <= m_budget->budgetBytes) { return; }
+
+        vector<std::pair<uint64_t, map<string, sectionresidency_t>::iterator>> candidates{};
+        for (auto state = m_budget->sections.begin(); state != m_budget->sections.end(); state++) {
+            if (!state->second.resident || m_pinnedSections.count(state->first) != 0 || m_hotIndex.containsSection(state->first)) { continue; }
+
+            candidates.emplace_back(state->second.lastUse, state);
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        auto& dict = const_cast<entrydict_t&>(m_translationDict);
+        for (const auto& candidate : candidates) {
+            if (m_budget->residentBytes <= m_budget->budgetBytes) { break; }
+
+            auto& state = candidate.second->second;
+            dict.erase(candidate.second->first);
+
+            state.resident = false;
+            m_budget->residentBytes -= std::min(state.bytes, m_budget->residentBytes.load());
+            m_budget->residentSections--;
+            m_metrics.add(counter_t::Evictions);
+        }
+    }
+
+    /**
+     * @brief Locks the memory budget, if this language has one.
+     * 
+     * @return std::unique_lock<std::recursive_mutex> The lock; doesn't own a mutex if there is no budget.
+     */
+    std::unique_lock<std::recursive_mutex> language::lockBudget() const {
+        if (!m_budget) { return {}; }
+
+        return std::unique_lock<std::recursive_mutex>(m_budget->mutex);
+    }
+
+    /**
+     * @brief Gets a complete section from the mapped .mo catalog, if any.
+     * 
+     * @remarks This walks the entire catalog.
+     * 
+     * @param sectionName The name of the section (the message context).
+     * 
+     * @return optsect_t The section, or nullopt if the catalog has no messages with the given context.
+     */
+    optsect_t language::getMoSection(const string& sectionName) const {
+        if (!m_moCatalog) { return {}; }
+
+        sect_t section{};
+        for (size_t i = 0; i < m_moCatalog->size(); i++) {
+            string_view context{};
+            string_view msgid{};
+            string_view translation{};
+            if (!m_moCatalog->getEntry(i, context, msgid, translation) || context != sectionName) { continue; }
+            if (context.empty() && msgid.empty()) { continue; } // the catalog header
+
+            section.emplace(msgid, translation);
+        }
+
+        if (section.empty()) { return {}; }
+        return section;
+    }
+
+    /**
+     * @brief Performs all lazy initialisation of this language up front.
+     * 
+     * Call this after loading a language and before serving the first requests, so the first lookups
+     * don't pay for page faults, template compilation or cold caches.
+     * 
+     * @remarks This member function modifies the language and must not be called while other threads read from it!
+     * 
+     * @param options The work to perform.
+     * 
+     * @return warmstats_t Statistics about the work which was performed.
+     */
+    warmstats_t language::warm(const warmopts_t& options /*= {}*/) {
+        warmstats_t stats{};
+
+        if (options.compileTemplates) {
+            compileTemplates();
+            for (const auto& section : m_translationDict) { stats.templatesCompiled += section.second.size(); }
+        }
+
+        if (options.resolveReferences) {
+            stats.referencesResolved = resolveReferences();
+        }
+
+        if (options.prefaultPages) {
+            // touching one byte per cache line is enough to fault in every page holding a translation
+            constexpr size_t CACHE_LINE_SIZE = 64;
+            volatile char sink = 0;
+
+            for (const auto& section : m_translationDict) {
+                for (const auto& field : section.second) {
+                    const auto& value = field.second.value;
+                    for (size_t i = 0; i < value.size(); i += CACHE_LINE_SIZE) { sink = sink ^ value[i]; }
+
+                    stats.bytesTouched += value.size();
+                }
+            }
+
+            if (m_moCatalog) { stats.bytesTouched += m_moCatalog->prefault(); }
+        }
+
+        for (const auto& hotKey : options.hotKeys) {
+            if (getString(hotKey.first, hotKey.second).has_value()) {
+                stats.hotKeysRendered++;
+            } else {
+                stats.hotKeysMissing++;
+            }
+        }
+
+        return stats;
+    }
+
+    /**
+     * @brief Lays out the hottest translations of an access profile contiguously in memory.
+     * 
+     * The keys and values of the hottest translations are copied into a single pool in hotness order,
+     * with a small open-addressing index in front of it, which is consulted before the translation dictionary.
+     * 
+     * @remarks This member function modifies the language and must not be called while other threads read from it!
+     * 
+     * @param profile The profile, typically recorded during a previous run and loaded with access_profile::fromFile().
+     * @param maxHotKeys The maximum amount of translations to lay out.
+     * 
+     * @return size_t The amount of translations which were laid out.
+     */
+    size_t language::applyAccessProfile(const access_profile& profile, size_t maxHotKeys /*= DEFAULT_HOT_KEYS*/) {
+        return m_hotIndex.build(
+            profile.getHottest(maxHotKeys),
+            [this](const string& section, const string& field) { return findEntry(section, field); }
+        );
+    }
+
+    /**
+     * @brief Gets a single string from the translation table.
+     * 
+     * @remarks Variables @b ARE expanded here if expandVariables is true!
+     * 
+     * @param section The name of the section in which to search for the translation.
+     * @param field The name of the translation you're looking for.
+     * @param expandVariables Whether or not to expand variables (default: true)
+     * 
+     * @returns An optional<string> which contains the translation or nullopt, depending on whether the translation was found or not.
+     */
+    optstr_t language::getString(const string& section, const string& field, bool expandVariables /*= true*/) const {
+        using counter_t = lang_metrics::counter_t;
+        const budget_scope scope(*this);
+        sample_scope sample(m_renderProfiler.get(), section, field, expandVariables);
+
+        m_metrics.add(counter_t::Lookups);
+        if (m_accessProfile) { m_accessProfile->record(section, field); }
+
+        if (!m_hotIndex.empty()) { m_metrics.add(counter_t::HotLookups); }
+        if (hot_index::hit_t hit{}; m_hotIndex.find(section, field, hit)) {
+            m_metrics.add(counter_t::HotHits);
+            sample.lookupDone();
+
+            const auto& compiled = hit.entry->compiled;
+            if (!expandVariables || (compiled.isCompiled() && !compiled.hasVariables())) { return string(hit.value); }
+
+            return renderEntry(*hit.entry, 0);
+        }
+
+        const auto entry = findEntry(section, field);
+        sample.lookupDone();
+        if (entry == nullptr) {
+            // the empty msgid is the catalog header, not a translation
+            if (string_view translation{}; m_moCatalog && !field.empty() && m_moCatalog->find(section, field, translation)) {
+                if (!expandVariables) { return string(translation); }
+
+                render_memo memo{};
+                return renderNested(string(translation), 0, memo);
+            }
+
+            m_metrics.add(counter_t::Misses);
+            return {};
+        }
+
+        if (!expandVariables) { return entry->value; }
+
+        return renderEntry(*entry, 0);
+    }
+
+    /**
+     * @brief Gets a single translation by its stable key.
+     * 
+     * The stable key of a translation never changes between versions of a language; see key_index.
+     * To look up the same translation repeatedly, use a key_handle, which skips the index entirely until the language is reloaded.
+     * 
+     * @remarks Translations of a mapped .mo catalog have no stable keys.
+     * 
+     * @param key The stable key of the translation.
+     * @param expandVariables Whether or not to expand variables (default: true)
+     * 
+     * @returns An optional<string> which contains the translation or nullopt, depending on whether the translation was found or not.
+     */
+    optstr_t language::getString(stablekey_t key, bool expandVariables /*= true*/) const {
+        key_handle handle(key);
+        return getString(handle, expandVariables);
+    }
+
+    /**
+     * @brief Gets a single translation through a handle.
+     * 
+     * If the handle was resolved in the current generation of this language, the cached translation (or the fact that
+     * it doesn't exist) is used directly. Otherwise, the handle is resolved by its stable key and updated.
+     * Under a memory budget, sections may be evicted at any time, so only the names are resolved through the index
+     * and the translation is then found by name.
+     * 
+     * @param handle The handle of the translation; updated if it was resolved in an older generation.
+     * @param expandVariables Whether or not to expand variables (default: true)
+     * 
+     * @returns An optional<string> which contains the translation or nullopt, depending on whether the translation was found or not.
+     */
+    optstr_t language::getString(key_handle& handle, bool expandVariables /*= true*/) const {
+        using counter_t = lang_metrics::counter_t;
+        const budget_scope scope(*this);
+
+        m_metrics.add(counter_t::Lookups);
+
+        if (handle.m_generation != m_generation) {
+            key_index::keyref_t ref{};
+            handle.m_missing = !getKeyIndex().find(handle.m_key, ref);
+            handle.m_entry = ref.entry;
+            handle.m_generation = m_generation;
+        }
+
+        if (handle.m_missing) {
+            m_metrics.add(counter_t::Misses);
+            return {};
+        }
+
+        auto entry = handle.m_entry;
+        if (entry == nullptr || m_accessProfile) {
+            key_index::keyref_t ref{};
+            getKeyIndex().find(handle.m_key, ref);
+
+            const auto section = string(ref.section);
+            const auto field = string(ref.field);
+            if (m_accessProfile) { m_accessProfile->record(section, field); }
+            if (entry == nullptr) { entry = findEntry(section, field); }
+        }
+
+        if (entry == nullptr) {
+            m_metrics.add(counter_t::Misses);
+            return {};
+        }
+
+        if (!expandVariables) { return entry->value; }
+
+        return renderEntry(*entry, 0);
+    }
+
+    /**
+     * @brief Renders every translation of a section in one pass, handing each one to a sink.
+     * 
+     * The section is searched (and, under a memory budget, re-materialised) once. All translations share a single
+     * expansion memo, so a variable or cross-reference used by many translations is expanded only once per call,
+     * and every rendered translation is written into the same output buffer.
+     * Translations without variables are handed to the sink straight from the translation table.
+     * 
+     * Sections with at least options.parallelThreshold translations are rendered by up to options.threads threads,
+     * each with its own memo and buffer; the sink is still called on the calling thread, in field order.
+     * Sections are always rendered on the calling thread under a memory budget.
+     * 
+     * @remarks The value passed to the sink is only valid until the sink returns.
+     * @remarks Expanders must be thread-safe to use the parallel mode.
+     * 
+     * @param section The name of the section to render.
+     * @param sink The sink receiving each field and its rendered translation, in sorted order.
+     * @param options Controls whether and how the section is rendered in parallel.
+     * 
+     * @return true If the section was found.
+     * @return false Otherwise.
+     * 
+     * @throws Any exception thrown by an expander. In parallel mode, it is rethrown on the calling thread once all workers have stopped.
+     */
+    bool language::getSectionExpanded(const string& section, const fieldsink_t& sink, const expandopts_t& options /*= {}*/) const {
+        using counter_t = lang_metrics::counter_t;
+        const budget_scope scope(*this);
+
+        m_metrics.add(counter_t::Lookups);
+        if (m_budget) { ensureResident(section); }
+
+        const auto sectPos = m_translationDict.find(section);
+        if (sectPos == m_translationDict.end()) {
+            const auto moSection = getMoSection(section);
+            if (!moSection) {
+                m_metrics.add(counter_t::Misses);
+                return false;
+            }
+
+            render_memo memo{};
+            for (const auto& field : *moSection) { sink(field.first, renderNested(field.second, 0, memo)); }
+
+            return true;
+        }
+
+        // renders a single entry into output; returns the entry's value if nothing had to be expanded
+        const auto renderInto = [this](const entry_t& entry, string& output, render_memo& memo) -> const string* {
+            if (entry.compiled.isCompiled()) {
+                if (!entry.compiled.hasVariables()) { return &entry.value; }
+
+                output.clear();
+                appendTemplate(output, entry.value, entry.compiled, 0, memo);
+                return nullptr;
+            }
+
+            // parseLine() was called without a subsequent compileTemplates()
+            auto tmpl = compiled_template::compile(entry.value);
+            if (!tmpl.hasVariables()) { return &entry.value; }
+
+            tmpl.bind(entry.value, _expanderRegistry);
+            output.clear();
+            appendTemplate(output, entry.value, tmpl, 0, memo);
+            return nullptr;
+        };
+
+        const auto& fields = sectPos->second;
+        auto threads = options.threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : options.threads;
+        if (m_budget || fields.size() < std::max<size_t>(1, options.parallelThreshold)) { threads = 1; }
+
+        if (threads == 1) {
+            render_memo memo{};
+            string output{};
+
+            for (const auto& field : fields) {
+                const auto value = renderInto(field.second, output, memo);
+                sink(field.first, value != nullptr ? *value : output);
+            }
+
+            return true;
+        }
+
+        vector<const entrysect_t::value_type*> entries{};
+        entries.reserve(fields.size());
+        for (const auto& field : fields) { entries.push_back(&field); }
+
+        // only translations which had to be expanded are stored; the others are read from the table when sinking
+        vector<string> rendered(entries.size());
+        vector<char> expanded(entries.size(), 0);
+
+        const auto chunkSize = std::max<size_t>(1, options.chunkSize);
+        const auto chunks = (entries.size() + chunkSize - 1) / chunkSize;
+        std::atomic<size_t> nextChunk{0};
+
+        threads = std::min(threads, chunks);
+
+        // expanders may throw; exceptions are passed to the calling thread once all workers have stopped
+        vector<std::exception_ptr> errors(threads);
+        const auto worker = [&](size_t slot) {
+            try {
+                render_memo memo{};
+                for (auto chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+                    const auto end = std::min(entries.size(), (chunk + 1) * chunkSize);
+                    for (auto index = chunk * chunkSize; index < end; index++) {
+                        if (renderInto(entries[index]->second, rendered[index], memo) == nullptr) { expanded[index] = 1; }
+                    }
+                }
+            } catch (...) {
+                errors[slot] = std::current_exception();
+                nextChunk = chunks; // the other workers stop after their current chunk
+            }
+        };
+
+        vector<std::thread> workers{};
+        for (size_t i = 1; i < threads; i++) { workers.emplace_back(worker, i); }
+        worker(0);
+        for (auto& thread : workers) { thread.join(); }
+
+        for (const auto& error : errors) {
+            if (error) { std::rethrow_exception(error); }
+        }
+
+        for (size_t i = 0; i < entries.size(); i++) {
+            sink(entries[i]->first, expanded[i] != 0 ? string_view(rendered[i]) : string_view(entries[i]->second.value));
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Expands a given variable if a possible expander was found.
      * 
      * @remarks
      * Custom expanders overwrite default expanders!
      * If no expansion was found, the result will be an empty string.
+     * This is the slow path; compiled templates only call it for variables which couldn't be bound at load time.
      * 
      * @param varName The name of the variable to expand.
      * 
      * @return string The expanded variable - or an empty string if no expander was found.
      */
     string language::expandVariable(const string& varName) const {
-        // first check if custom var expanders were set up
-        if (const auto iterPos = _callbackList.find(varName); iterPos != _callbackList.end()) {
-            return iterPos->second(varName);
-        }
-
-        if (const auto iterPos = _defaultExpandersList.find(varName); iterPos != _defaultExpandersList.end()) {
-            const auto value = iterPos->second(varName);
+        string value{};
+        if (_expanderRegistry.invoke(_expanderRegistry.find(varName), varName, value)) {
             return value;
         }
 
@@ -289,25 +1720,224 @@ namespace borr {
     }
 
     /**
-     * @brief Removes any inline comemnts found in a string.
+     * @brief Gets the index of all stable keys of this language, building it on first use.
      * 
-     * @param line The line to check.
+     * Without a memory budget, the index points directly at the entries. Under a memory budget, it is built from the
+     * backing pack, so it also contains evicted sections, and only holds the names of the translations.
+     * Concurrent readers may build the index at the same time; only the first index is kept.
      * 
-     * @return string The stripped string.
+     * @return const key_index& The index; valid until the language is reloaded.
      */
-    string language::removeInlineComments(const string& line) const {
-        namespace rc = std::regex_constants;
-        static const regex COMMENT_REGEX = regex(R"(#[^\n]+[^"]$)", rc::optimize);
+    const key_index& language::getKeyIndex() const {
+        if (const auto keyIndex = std::atomic_load(&m_keyIndex)) { return *keyIndex; }
+
+        auto keyIndex = std::make_shared<key_index>();
+        if (m_budget) {
+            const auto lock = lockBudget();
+            if (m_backingPack) {
+                m_backingPack->visitAll([&keyIndex](string_view section, string_view field, string_view) { keyIndex->add(section, field, nullptr); });
+            }
+        } else {
+            for (const auto& section : m_translationDict) {
+                for (const auto& field : section.second) { keyIndex->add(section.first, field.first, &field.second); }
+            }
+        }
+        keyIndex->finalise();
+
+        std::shared_ptr<const key_index> expected{};
+        std::atomic_compare_exchange_strong(&m_keyIndex, &expected, std::shared_ptr<const key_index>(std::move(keyIndex)));
+
+        return *std::atomic_load(&m_keyIndex);
+    }
+
+    /**
+     * @brief Finds a single translation entry without copying its section.
+     * 
+     * Under a memory budget, an evicted section is re-materialised first; the returned pointer is only
+     * valid while the caller holds the budget's lock.
+     * 
+     * @param section The name of the section.
+     * @param field The name of the field.
+     * 
+     * @return const entry_t* A pointer to the entry, or nullptr if it doesn't exist.
+     */
+    const entry_t* language::findEntry(const string& section, const string& field) const {
+        if (m_budget) { ensureResident(section); }
+
+        const auto sectPos = m_translationDict.find(section);
+        if (sectPos == m_translationDict.end()) { return nullptr; }
+
+        const auto fieldPos = sectPos->second.find(field);
+        return fieldPos == sectPos->second.end() ? nullptr : &fieldPos->second;
+    }
+
+    /**
+     * @brief Renders a translation entry, expanding all variables.
+     * 
+     * This starts a new top-level render: every distinct variable is expanded at most once.
+     * 
+     * @param entry The entry to render.
+     * @param depth The current nesting depth of references and expansions.
+     * 
+     * @return string The rendered translation.
+     */
+    string language::renderEntry(const entry_t& entry, size_t depth) const {
+        render_memo memo{};
+        return renderEntry(entry, depth, memo);
+    }
+
+    /**
+     * @brief Renders a translation entry as part of a larger render, sharing its memo.
+     * 
+     * @param entry The entry to render.
+     * @param depth The current nesting depth of references and expansions.
+     * @param memo The expansions of the current top-level render.
+     * 
+     * @return string The rendered translation.
+     */
+    string language::renderEntry(const entry_t& entry, size_t depth, render_memo& memo) const {
+        if (!entry.compiled.isCompiled()) {
+            // parseLine() was called without a subsequent compileTemplates()
+            auto tmpl = compiled_template::compile(entry.value);
+            tmpl.bind(entry.value, _expanderRegistry);
+
+            return tmpl.hasVariables() ? renderTemplate(entry.value, tmpl, depth, memo) : entry.value;
+        }
+
+        if (!entry.compiled.hasVariables()) { return entry.value; }
+
+        return renderTemplate(entry.value, entry.compiled, depth, memo);
+    }
+
+    /**
+     * @brief Renders a compiled template.
+     * 
+     * Bound expanders are invoked directly through their registry slot; references are rendered recursively
+     * until MAX_EXPANSION_DEPTH is reached, after which they expand to an empty string.
+     * 
+     * Every expansion is remembered in the memo, keyed by the variable's name, so repeated variables - within
+     * this template or anywhere else in the same top-level render - reuse it instead of invoking the expander
+     * or rendering the reference again.
+     * 
+     * @param source The translation the template was compiled from.
+     * @param tmpl The compiled template.
+     * @param depth The current nesting depth of references and expansions.
+     * @param memo The expansions of the current top-level render.
+     * 
+     * @return string The rendered translation.
+     */
+    string language::renderTemplate(const string& source, const compiled_template& tmpl, size_t depth, render_memo& memo) const {
+        string rendered{};
+        rendered.reserve(source.size());
+
+        appendTemplate(rendered, source, tmpl, depth, memo);
+        return rendered;
+    }
+
+    /**
+     * @brief Renders a compiled template, appending the result to an existing buffer.
+     * 
+     * This allows callers rendering many translations to reuse a single buffer; see renderTemplate() for the expansion rules.
+     * 
+     * @param output The buffer to append the rendered translation to.
+     * @param source The translation the template was compiled from.
+     * @param tmpl The compiled template.
+     * @param depth The current nesting depth of references and expansions.
+     * @param memo The expansions of the current top-level render.
+     */
+    void language::appendTemplate(string& output, const string& source, const compiled_template& tmpl, size_t depth, render_memo& memo) const {
+        using segkind_t = compiled_template::segkind_t;
+
+        const auto renderReference = [&](const compiled_template::segment_t& segment) -> string {
+            if (depth >= MAX_EXPANSION_DEPTH) { return {}; }
+
+            if (segment.target != nullptr) { return renderEntry(*segment.target, depth + 1, memo); }
+
+            const auto entry = findEntry(
+                source.substr(segment.offset, segment.separator),
+                source.substr(segment.offset + segment.separator + 1, segment.length - segment.separator - 1)
+            );
+
+            return entry == nullptr ? string{} : renderEntry(*entry, depth + 1, memo);
+        };
+
+        const auto expandSegment = [&](const compiled_template::segment_t& segment) -> string {
+            switch (segment.kind) {
+                case segkind_t::Expander: {
+                    string value{};
+                    if (_expanderRegistry.invoke(segment.slot, source.substr(segment.offset, segment.length), value)) {
+                        return renderNested(value, depth, memo);
+                    }
+
+                    return segment.separator != string::npos ? renderReference(segment) : string{};
+                }
+                case segkind_t::Reference:
+                    return renderReference(segment);
+                case segkind_t::Dynamic:
+                    return renderNested(expandVariable(source.substr(segment.offset, segment.length)), depth, memo);
+                default:
+                    return {};
+            }
+        };
+
+        size_t expansions = 0;
+        for (const auto& segment : tmpl.getSegments()) {
+            if (segment.kind == segkind_t::Literal) {
+                output.append(source, segment.offset, segment.length);
+                continue;
+            }
+            if (segment.kind == segkind_t::Empty) { continue; }
 
-        string copy = line;
-        smatch matches;
-        if (std::regex_search(copy, matches, COMMENT_REGEX)) {
-            for (const auto& match : matches) {
-                copy = copy.replace(copy.find(match.str()), match.str().length(), "");
+            const auto name = string_view(source).substr(segment.offset, segment.length);
+            if (const auto memoised = memo.find(name); memoised != nullptr) {
+                output += *memoised;
+                continue;
             }
+
+            expansions++;
+            if (t_renderSample == nullptr) {
+                output += memo.insert(name, expandSegment(segment));
+                continue;
+            }
+
+            const auto expandStart = std::chrono::steady_clock::now();
+            auto value = expandSegment(segment);
+            t_renderSample->addSpan(getSpanKind(segment, name), name, depth, std::chrono::steady_clock::now() - expandStart);
+
+            output += memo.insert(name, std::move(value));
         }
 
-        return extensions::trim(copy);
+        m_metrics.add(lang_metrics::counter_t::Expansions, expansions);
+    }
+
+    /**
+     * @brief Expands any variables contained within the result of an expander.
+     * 
+     * @param value The value returned by an expander.
+     * @param depth The current nesting depth of references and expansions.
+     * @param memo The expansions of the current top-level render.
+     * 
+     * @return string The value with all variables expanded.
+     */
+    string language::renderNested(const string& value, size_t depth, render_memo& memo) const {
+        if (depth >= MAX_EXPANSION_DEPTH || value.find("${") == string::npos) { return value; }
+
+        auto tmpl = compiled_template::compile(value);
+        if (!tmpl.hasVariables()) { return value; }
+
+        tmpl.bind(value, _expanderRegistry);
+        return renderTemplate(value, tmpl, depth + 1, memo);
+    }
+
+    /**
+     * @brief Removes any inline comemnts found in a string.
+     * 
+     * @param line The line to check.
+     * 
+     * @return string The stripped string.
+     */
+    string language::removeInlineComments(const string& line) const {
+        return stripInlineComment(line);
     }
 
     /**
@@ -319,6 +1949,96 @@ namespace borr {
         m_langVer = {};
         m_currentSection = {};
         m_translationDict.clear();
+        m_hotIndex.clear();
+        m_moCatalog.reset();
+        m_backingPack.reset();
+        m_keyIndex.reset();
+        m_generation = nextGeneration();
+        m_fingerprint.reset();
+        m_loadStats = {};
+
+        if (m_budget) {
+            m_budget->sections.clear();
+            m_budget->residentBytes = 0;
+            m_budget->residentSections = 0;
+        }
+    }
+
+    /**
+     * @brief Performs the work shared by all loads once the translation tables are filled: linking, key counts and residency.
+     * 
+     * @param trace The trace of the current load; completed once all work is done.
+     */
+    void language::finishLoad(load_trace& trace) {
+        const auto linkStart = trace.begin(loadphase_t::Link);
+        compileTemplates();
+
+        m_loadStats = {};
+        m_loadStats.sections = m_translationDict.size();
+        for (const auto& section : m_translationDict) {
+            m_loadStats.keyBytes += section.first.size();
+            m_loadStats.residentBytes += getResidentBytes(section);
+
+            for (const auto& field : section.second) {
+                const auto& entry = field.second;
+
+                m_loadStats.keys++;
+                m_loadStats.keyBytes += field.first.size();
+                m_loadStats.valueBytes += entry.value.size();
+                if (entry.value.find('\n') != string::npos) { m_loadStats.multilineKeys++; }
+                if (entry.compiled.hasVariables()) { m_loadStats.keysWithVariables++; }
+            }
+        }
+        trace.end(loadphase_t::Link, linkStart, m_loadStats.keys);
+
+        const auto residencyStart = trace.begin(loadphase_t::Residency);
+        rebuildResidency();
+        trace.end(loadphase_t::Residency, residencyStart, m_budget ? m_budget->sections.size() : 0);
+
+        trace.finish(m_loadStats.keys);
+    }
+
+    /**
+     * @brief Compiles the templates of all translations and binds their variables.
+     * 
+     * This is called once all lines of a borrfile have been parsed.
+     */
+    void language::compileTemplates() {
+        for (auto& section : m_translationDict) {
+            for (auto& field : section.second) {
+                auto& entry = field.second;
+
+                entry.compiled = compiled_template::compile(entry.value);
+                entry.compiled.bind(entry.value, _expanderRegistry);
+            }
+        }
+
+        m_referencesResolved = false;
+    }
+
+    /**
+     * @brief Binds all cross-references to the translation they reference.
+     * 
+     * References to translations which don't exist are turned into empty expansions.
+     * Under a memory budget, references are never bound, as their targets may be evicted;
+     * they are looked up (and re-materialised) on every render instead.
+     * 
+     * @return size_t The amount of references which were resolved.
+     */
+    size_t language::resolveReferences() {
+        if (m_budget) { return 0; }
+
+        const auto resolver = [this](const string& section, const string& field) { return findEntry(section, field); };
+
+        size_t resolved = 0;
+        for (auto& section : m_translationDict) {
+            for (auto& field : section.second) {
+                resolved += field.second.compiled.resolveReferences(field.second.value, resolver);
+            }
+        }
+
+        m_referencesResolved = true;
+        return resolved;
     }
 
     /**
@@ -332,7 +2052,10 @@ namespace borr {
         // now search for inline comments
         const auto commentlessLine = removeInlineComments(line);
 
-        if (isSection(commentlessLine, m_currentSection)) { return; } // nothing more to do here
+        if (isSection(commentlessLine, m_currentSection)) {
+            if (m_loadTrace != nullptr) { m_loadTrace->beginSection(m_currentSection); }
+            return; // nothing more to do here
+        }
 
         string field;
         string translation;
@@ -352,19 +2075,58 @@ namespace borr {
             return;
         }
 
-        if (!getSection(m_currentSection).has_value()) {
-            m_translationDict.emplace(m_currentSection, sect_t{});
-        }
-
         auto& section = m_translationDict[m_currentSection];
 
         const auto trimmedField = extensions::trim(field, "[]");
 
-        if (section.find(trimmedField) != section.end() && isMultilineField(field)) {
-            section[trimmedField] = section[trimmedField] + "\n" + translation;
+        if (const auto iterPos = section.find(trimmedField); iterPos != section.end() && isMultilineField(field)) {
+            iterPos->second.value += "\n" + translation;
         } else {
-            section.emplace(trimmedField, translation);
+            section.emplace(trimmedField, entry_t{ translation });
+        }
+    }
+
+    /**
+     * @brief Parses all complete lines in a chunk of input.
+     * 
+     * Characters after the last line break are kept in pendingLine, to be completed by the next chunk.
+     * Empty lines are skipped.
+     * 
+     * @param chunk The chunk to parse.
+     * @param pendingLine The incomplete line carried over between chunks.
+     * @param maxLineLength The maximum length of a single line; 0 means unlimited.
+     * 
+     * @return size_t The amount of non-empty lines which were parsed.
+     * 
+     * @throws runtime_error If a line exceeds maxLineLength.
+     */
+    size_t language::parseChunk(string_view chunk, string& pendingLine, size_t maxLineLength) {
+        size_t lineCount = 0;
+
+        while (!chunk.empty()) {
+            const auto lineEnd = chunk.find('\n');
+            const auto part = chunk.substr(0, lineEnd);
+
+            if (maxLineLength != 0 && pendingLine.size() + part.size() > maxLineLength) {
+                throw std::runtime_error("Line exceeds maximum line length!");
+            }
+
+            if (lineEnd == string_view::npos) {
+                pendingLine.append(part);
+                break;
+            }
+
+            pendingLine.append(part);
+            if (!pendingLine.empty()) {
+                parseLine(pendingLine);
+                pendingLine.clear();
+                lineCount++;
+            }
+
+            chunk.remove_prefix(lineEnd + 1);
         }
+
+        return lineCount;
     }
 
     /**
@@ -373,10 +2135,7 @@ namespace borr {
      * @param varName The variable name for which to remove the expander.
      */
     void language::removeVarExpansionCallback(const string& varName) {
-        const auto iterPos = _callbackList.find(varName);
-
-        if (iterPos == _callbackList.end()) { return; } // fail silently
-        _callbackList.erase(iterPos);
+        _expanderRegistry.removeCallback(varName);
     }
 
     #pragma region "Default Expanders"
@@ -0,0 +1,131 @@
+/**
+ * @file mapped_file.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the mapped_file class.
+ * @version 0.1
+ * @date 2023-02-20
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#if __has_include(<sys/mman.h>)
+#   define BORR_HAS_MMAP 1
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   define BORR_HAS_MMAP 0
+#endif
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/mapped_file.hpp"
+
+namespace borr {
+
+    using std::error_code;
+
+    /**
+     * @brief Maps a file into memory.
+     *
+     * If the file can't be mapped (or is empty), it is read into memory instead.
+     *
+     * @param path The path to the file.
+     *
+     * @return std::shared_ptr<const mapped_file> The mapped file.
+     *
+     * @throws fs::filesystem_error If the file couldn't be opened.
+     */
+    std::shared_ptr<const mapped_file> mapped_file::fromFile(const fs::path& path) {
+        auto file = std::shared_ptr<mapped_file>(new mapped_file());
+
+#if BORR_HAS_MMAP
+        const auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw fs::filesystem_error("Failed to open file!", path, error_code(errno, std::generic_category()));
+        }
+
+        struct stat fileStat{};
+        if (::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+            const auto mapping = ::mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                file->m_data = static_cast<const uint8_t*>(mapping);
+                file->m_size = static_cast<size_t>(fileStat.st_size);
+                file->m_mapped = true;
+            }
+        }
+        ::close(fd);
+#endif
+
+        if (!file->m_mapped) {
+            std::ifstream inStream(path, std::ios::binary);
+            if (!inStream.is_open()) {
+                throw fs::filesystem_error("Failed to open file!", path, error_code(ENOENT, std::generic_category()));
+            }
+
+            file->m_buffer.assign(std::istreambuf_iterator<char>(inStream), std::istreambuf_iterator<char>());
+            file->m_data = reinterpret_cast<const uint8_t*>(file->m_buffer.data());
+            file->m_size = file->m_buffer.size();
+        }
+
+        return file;
+    }
+
+    /**
+     * @brief Wraps contents which are already in memory, so they can be used wherever a mapped file is expected.
+     *
+     * @param contents The contents of the "file".
+     *
+     * @return std::shared_ptr<const mapped_file> The wrapped contents.
+     */
+    std::shared_ptr<const mapped_file> mapped_file::fromString(string contents) {
+        auto file = std::shared_ptr<mapped_file>(new mapped_file());
+
+        file->m_buffer = std::move(contents);
+        file->m_data = reinterpret_cast<const uint8_t*>(file->m_buffer.data());
+        file->m_size = file->m_buffer.size();
+
+        return file;
+    }
+
+    /**
+     * @brief Unmaps the file.
+     */
+    mapped_file::~mapped_file() {
+#if BORR_HAS_MMAP
+        if (m_mapped) { ::munmap(const_cast<uint8_t*>(m_data), m_size); }
+#endif
+    }
+
+    /**
+     * @brief Touches every page of the file, so later accesses don't cause page faults.
+     *
+     * @return size_t The amount of bytes which were touched.
+     */
+    size_t mapped_file::prefault() const {
+        if (m_data == nullptr) { return 0; }
+
+#if BORR_HAS_MMAP
+        if (m_mapped) { ::madvise(const_cast<uint8_t*>(m_data), m_size, MADV_WILLNEED); }
+        const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#else
+        const size_t pageSize = 4096;
+#endif
+
+        volatile uint8_t sink = 0;
+        for (size_t offset = 0; offset < m_size; offset += pageSize) { sink = sink ^ m_data[offset]; }
+
+        return m_size;
+    }
+
+}
@@ -0,0 +1,413 @@
+/**
+ * @file mo_catalog.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the mo_catalog class.
+ * @version 0.1
+ * @date 2023-02-14
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/extensions.hpp"
+#include "borr/mo_catalog.hpp"
+
+namespace borr {
+
+    using std::error_code;
+
+    namespace {
+
+        constexpr size_t    MO_HEADER_SIZE = 28; //!< The size of a .mo header (7 words)
+        constexpr size_t    MO_TABLE_ENTRY_SIZE = 8; //!< The size of a string table entry (length + offset)
+
+        /**
+         * @brief Gets the first prime number greater than or equal to a given number.
+         */
+        uint32_t nextPrime(uint32_t number) {
+            const auto isPrime = [](uint32_t candidate) {
+                if (candidate < 2) { return false; }
+                for (uint32_t divisor = 2; divisor * divisor <= candidate; divisor++) {
+                    if (candidate % divisor == 0) { return false; }
+                }
+                return true;
+            };
+
+            while (!isPrime(number)) { number++; }
+            return number;
+        }
+
+        /**
+         * @brief Strips everything from the first NUL byte; used to separate singular and plural forms.
+         */
+        string_view firstForm(string_view str) {
+            return str.substr(0, str.find('\0'));
+        }
+
+    }
+
+    /**
+     * @brief Maps a .mo file into memory and validates it.
+     *
+     * If the file can't be mapped, it is read into memory instead.
+     *
+     * @param path The path to the .mo file.
+     *
+     * @return std::shared_ptr<const mo_catalog> The mapped catalog.
+     *
+     * @throws fs::filesystem_error If the file couldn't be opened.
+     * @throws runtime_error If the file isn't a valid .mo file.
+     */
+    std::shared_ptr<const mo_catalog> mo_catalog::fromFile(const fs::path& path) {
+        auto catalog = std::shared_ptr<mo_catalog>(new mo_catalog());
+
+        catalog->m_file = mapped_file::fromFile(path);
+        catalog->m_data = catalog->m_file->data();
+        catalog->m_size = catalog->m_file->size();
+
+        catalog->validate();
+        return catalog;
+    }
+
+    /**
+     * @brief Writes a .mo file which is compatible with GNU gettext.
+     *
+     * The originals are sorted and a hash table is generated, the same way msgfmt does.
+     * If the same context and msgid are passed more than once, the first entry is used.
+     *
+     * @param path The path to write the file to.
+     * @param entries The messages to write.
+     *
+     * @throws fs::filesystem_error If the file couldn't be written.
+     */
+    void mo_catalog::writeFile(const fs::path& path, vector<moentry_t> entries) {
+        const auto keyOf = [](const moentry_t& entry) {
+            return entry.context.empty() ? entry.msgid : entry.context + CONTEXT_SEPARATOR + entry.msgid;
+        };
+
+        std::stable_sort(entries.begin(), entries.end(), [&](const moentry_t& a, const moentry_t& b) { return keyOf(a) < keyOf(b); });
+        entries.erase(std::unique(entries.begin(), entries.end(), [&](const moentry_t& a, const moentry_t& b) { return keyOf(a) == keyOf(b); }), entries.end());
+
+        const auto stringCount = static_cast<uint32_t>(entries.size());
+        const auto hashSize = nextPrime(std::max<uint32_t>(3, stringCount * 4 / 3));
+
+        vector<uint32_t> hashTable(hashSize, 0);
+        for (uint32_t i = 0; i < stringCount; i++) {
+            const auto hash = hashString(entries[i].context, firstForm(entries[i].msgid));
+            auto index = hash % hashSize;
+            const auto increment = 1 + (hash % (hashSize - 2));
+
+            while (hashTable[index] != 0) {
+                index = index >= hashSize - increment ? index - (hashSize - increment) : index + increment;
+            }
+            hashTable[index] = i + 1;
+        }
+
+        const uint32_t originalsOffset = MO_HEADER_SIZE;
+        const uint32_t translationsOffset = originalsOffset + stringCount * MO_TABLE_ENTRY_SIZE;
+        const uint32_t hashOffset = translationsOffset + stringCount * MO_TABLE_ENTRY_SIZE;
+        uint32_t stringOffset = hashOffset + hashSize * sizeof(uint32_t);
+
+        vector<uint32_t> words{ MO_MAGIC, 0, stringCount, originalsOffset, translationsOffset, hashSize, hashOffset };
+        string strings{};
+
+        const auto appendTable = [&](const auto& getString) {
+            for (const auto& entry : entries) {
+                const string str = getString(entry);
+                words.push_back(static_cast<uint32_t>(str.size()));
+                words.push_back(stringOffset);
+
+                strings += str;
+                strings += '\0';
+                stringOffset += static_cast<uint32_t>(str.size() + 1);
+            }
+        };
+        appendTable(keyOf);
+        appendTable([](const moentry_t& entry) { return entry.msgstr; });
+        words.insert(words.end(), hashTable.begin(), hashTable.end());
+
+        std::ofstream outStream(path, std::ios::binary | std::ios::trunc);
+        if (!outStream.is_open()) {
+            throw fs::filesystem_error("Failed to write .mo file!", path, error_code(EACCES, std::generic_category()));
+        }
+
+        outStream.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+        outStream.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    }
+
+    /**
+     * @brief Hashes a message the same way GNU gettext does (hash_string() in gettext's hash-string.c).
+     *
+     * @param context The message context; may be empty.
+     * @param msgid The message ID.
+     *
+     * @return uint32_t The hash of "context\x04msgid", or of msgid if the context is empty.
+     */
+    uint32_t mo_catalog::hashString(string_view context, string_view msgid) {
+        uint32_t hashValue = 0;
+
+        const auto hashChar = [&](char c) {
+            hashValue = (hashValue << 4) + static_cast<uint8_t>(c);
+            if (const auto highBits = hashValue & 0xf0000000; highBits != 0) {
+                hashValue ^= highBits >> 24;
+                hashValue ^= highBits;
+            }
+        };
+
+        if (!context.empty()) {
+            std::for_each(context.begin(), context.end(), hashChar);
+            hashChar(CONTEXT_SEPARATOR);
+        }
+        std::for_each(msgid.begin(), msgid.end(), hashChar);
+
+        return hashValue;
+    }
+
+    /**
+     * @brief Finds the translation of a message.
+     *
+     * @param context The message context (section); empty for messages without context.
+     * @param msgid The message ID (field).
+     * @param outTranslation Out parameter containing the translation. Points into the mapped file.
+     *
+     * @return true If the message was found.
+     * @return false Otherwise.
+     */
+    bool mo_catalog::find(string_view context, string_view msgid, string_view& outTranslation) const {
+        size_t foundIndex = SIZE_MAX;
+
+        if (hasHashTable()) {
+            const auto hash = hashString(context, msgid);
+            auto index = hash % m_hashSize;
+            const auto increment = 1 + (hash % (m_hashSize - 2));
+
+            // a well-formed table always contains an empty slot, but don't trust the file
+            for (uint32_t probes = 0; probes < m_hashSize; probes++) {
+                const auto stringIndex = readWord(m_hashOffset + index * sizeof(uint32_t));
+                if (stringIndex == 0) { break; }
+
+                if (stringIndex - 1 < m_stringCount && matches(stringIndex - 1, context, msgid)) {
+                    foundIndex = stringIndex - 1;
+                    break;
+                }
+
+                index = index >= m_hashSize - increment ? index - (m_hashSize - increment) : index + increment;
+            }
+        } else {
+            const auto key = context.empty() ? string(msgid) : string(context) + CONTEXT_SEPARATOR + string(msgid);
+
+            size_t lower = 0;
+            size_t upper = m_stringCount;
+            while (lower < upper && foundIndex == SIZE_MAX) {
+                const auto middle = lower + (upper - lower) / 2;
+
+                string_view original{};
+                if (!getString(m_originalsOffset, middle, original)) { return false; }
+
+                const auto comparison = firstForm(original).compare(key);
+                if (comparison == 0) {
+                    foundIndex = middle;
+                } else if (comparison < 0) {
+                    lower = middle + 1;
+                } else {
+                    upper = middle;
+                }
+            }
+        }
+
+        if (foundIndex == SIZE_MAX) { return false; }
+
+        string_view translation{};
+        if (!getString(m_translationsOffset, foundIndex, translation)) { return false; }
+
+        outTranslation = firstForm(translation);
+        return true;
+    }
+
+    /**
+     * @brief Gets a single entry by its index; used to enumerate the catalog.
+     *
+     * @param index The index of the entry; must be less than size().
+     * @param outContext Out parameter containing the context of the message (may be empty).
+     * @param outMsgid Out parameter containing the message ID.
+     * @param outTranslation Out parameter containing the translation.
+     *
+     * @return true If the entry is valid.
+     * @return false Otherwise.
+     */
+    bool mo_catalog::getEntry(size_t index, string_view& outContext, string_view& outMsgid, string_view& outTranslation) const {
+        string_view original{};
+        string_view translation{};
+        if (index >= m_stringCount || !getString(m_originalsOffset, index, original) || !getString(m_translationsOffset, index, translation)) {
+            return false;
+        }
+
+        original = firstForm(original);
+        if (const auto separator = original.find(CONTEXT_SEPARATOR); separator != string_view::npos) {
+            outContext = original.substr(0, separator);
+            outMsgid = original.substr(separator + 1);
+        } else {
+            outContext = {};
+            outMsgid = original;
+        }
+
+        outTranslation = firstForm(translation);
+        return true;
+    }
+
+    /**
+     * @brief Gets the catalog header, which is stored as the translation of the empty msgid.
+     *
+     * @return string_view The header, or an empty view if the catalog has no header.
+     */
+    string_view mo_catalog::getHeader() const {
+        string_view header{};
+        find({}, {}, header);
+
+        return header;
+    }
+
+    /**
+     * @brief Gets a single field from the catalog header, such as "Language" or "Project-Id-Version".
+     *
+     * @param fieldName The name of the field, without the trailing colon.
+     *
+     * @return string The trimmed value of the field, or an empty string if the field doesn't exist.
+     */
+    string mo_catalog::getHeaderField(string_view fieldName) const {
+        const auto header = getHeader();
+
+        size_t lineStart = 0;
+        while (lineStart < header.size()) {
+            auto lineEnd = header.find('\n', lineStart);
+            if (lineEnd == string_view::npos) { lineEnd = header.size(); }
+
+            const auto line = header.substr(lineStart, lineEnd - lineStart);
+            if (line.size() > fieldName.size() && line.substr(0, fieldName.size()) == fieldName && line[fieldName.size()] == ':') {
+                return extensions::trim(string(line.substr(fieldName.size() + 1)));
+            }
+
+            lineStart = lineEnd + 1;
+        }
+
+        return {};
+    }
+
+    /**
+     * @brief Touches every page of the catalog, so later lookups don't cause page faults.
+     *
+     * @return size_t The amount of bytes which were touched.
+     */
+    size_t mo_catalog::prefault() const {
+        return m_file->prefault();
+    }
+
+    /**
+     * @brief Reads a 32-bit word from the file, swapping its bytes if necessary.
+     *
+     * @remarks The caller must ensure offset + 4 <= m_size.
+     */
+    uint32_t mo_catalog::readWord(size_t offset) const {
+        uint32_t word = 0;
+        std::memcpy(&word, m_data + offset, sizeof(word));
+
+        if (m_swapped) {
+            word = ((word & 0xff) << 24) | ((word & 0xff00) << 8) | ((word >> 8) & 0xff00) | (word >> 24);
+        }
+
+        return word;
+    }
+
+    /**
+     * @brief Gets a string from one of the string tables.
+     *
+     * @param tableOffset The offset of the table (originals or translations).
+     * @param index The index of the string.
+     * @param outString Out parameter containing the string, including any plural forms.
+     *
+     * @return true If the table entry points to a valid, NUL-terminated string.
+     * @return false Otherwise.
+     */
+    bool mo_catalog::getString(uint32_t tableOffset, size_t index, string_view& outString) const {
+        const auto entryOffset = tableOffset + index * MO_TABLE_ENTRY_SIZE;
+        const uint64_t length = readWord(entryOffset);
+        const uint64_t offset = readWord(entryOffset + sizeof(uint32_t));
+
+        if (offset + length >= m_size || m_data[offset + length] != '\0') { return false; }
+
+        outString = string_view(reinterpret_cast<const char*>(m_data + offset), static_cast<size_t>(length));
+        return true;
+    }
+
+    /**
+     * @brief Determines whether the original at a given index matches a context and msgid.
+     */
+    bool mo_catalog::matches(size_t index, string_view context, string_view msgid) const {
+        string_view original{};
+        if (!getString(m_originalsOffset, index, original)) { return false; }
+
+        original = firstForm(original);
+        if (context.empty()) { return original == msgid; }
+
+        return original.size() == context.size() + 1 + msgid.size() &&
+               original.substr(0, context.size()) == context &&
+               original[context.size()] == CONTEXT_SEPARATOR &&
+               original.substr(context.size() + 1) == msgid;
+    }
+
+    /**
+     * @brief Validates the header and ensures all tables lie within the file.
+     *
+     * Individual strings are validated when they are accessed.
+     *
+     * @throws runtime_error If the file isn't a valid .mo file.
+     */
+    void mo_catalog::validate() {
+        if (m_size < MO_HEADER_SIZE) {
+            throw std::runtime_error("Invalid .mo file: file is too small!");
+        }
+
+        uint32_t magic = 0;
+        std::memcpy(&magic, m_data, sizeof(magic));
+        if (magic != MO_MAGIC && magic != MO_MAGIC_SWAPPED) {
+            throw std::runtime_error("Invalid .mo file: magic number mismatch!");
+        }
+        m_swapped = magic == MO_MAGIC_SWAPPED;
+
+        if (const auto majorRevision = readWord(4) >> 16; majorRevision > 1) {
+            throw std::runtime_error("Unsupported .mo file revision!");
+        }
+
+        m_stringCount = readWord(8);
+        m_originalsOffset = readWord(12);
+        m_translationsOffset = readWord(16);
+        m_hashSize = readWord(20);
+        m_hashOffset = readWord(24);
+
+        const auto tableFits = [&](uint64_t offset, uint64_t entryCount, uint64_t entrySize) {
+            return offset + entryCount * entrySize <= m_size;
+        };
+
+        if (!tableFits(m_originalsOffset, m_stringCount, MO_TABLE_ENTRY_SIZE) || !tableFits(m_translationsOffset, m_stringCount, MO_TABLE_ENTRY_SIZE)) {
+            throw std::runtime_error("Invalid .mo file: string tables exceed file size!");
+        }
+
+        if (hasHashTable() && !tableFits(m_hashOffset, m_hashSize, sizeof(uint32_t))) {
+            throw std::runtime_error("Invalid .mo file: hash table exceeds file size!");
+        }
+    }
+
+}
@@ -0,0 +1,192 @@
+/**
+ * @file openmetrics.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the OpenMetrics serialisation.
+ * @version 0.1
+ * @date 2023-02-19
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/language.hpp"
+#include "borr/openmetrics.hpp"
+
+namespace borr::openmetrics {
+
+    namespace {
+
+        using counter_t = lang_metrics::counter_t;
+
+        /**
+         * @brief A consistent-enough view of a single language, taken once per scrape.
+         */
+        struct snapshot_t {
+            string      label{}; //!< The escaped lang_id
+            langstats_t stats{}; //!< Key counts and memory usage
+            uint64_t    counters[static_cast<size_t>(counter_t::Count)]{}; //!< The values of all counters
+            uint64_t    lastLoadNanoseconds{0}; //!< The duration of the last load
+
+            uint64_t    get(counter_t counter) const { return counters[static_cast<size_t>(counter)]; }
+        };
+
+        using valuegetter_t = std::function<double(const snapshot_t&)>;
+
+        /**
+         * @brief Writes a single metric family with one sample per language.
+         *
+         * Counters get the "_total" suffix on their samples, as required by OpenMetrics.
+         */
+        void writeFamily(std::ostream& outStream, const vector<snapshot_t>& snapshots, string_view name, string_view type, string_view unit, string_view help, const valuegetter_t& getValue) {
+            outStream << "# TYPE " << name << ' ' << type << '\n';
+            if (!unit.empty()) { outStream << "# UNIT " << name << ' ' << unit << '\n'; }
+            outStream << "# HELP " << name << ' ' << help << '\n';
+
+            const auto suffix = type == "counter" ? "_total" : "";
+            for (const auto& snapshot : snapshots) {
+                outStream << name << suffix << "{lang=\"" << snapshot.label << "\"} ";
+
+                // counters are written exactly; fractional values (seconds, ratios) with nanosecond precision
+                const auto value = getValue(snapshot);
+                if (std::isnan(value)) {
+                    outStream << "NaN";
+                } else if (value == std::floor(value) && std::fabs(value) < 1e18) {
+                    outStream << static_cast<int64_t>(value);
+                } else {
+                    outStream << value;
+                }
+                outStream << '\n';
+            }
+        }
+
+    }
+
+    /**
+     * @brief Serialises the metrics of the given languages into the OpenMetrics text format.
+     *
+     * @param languages The languages to include. Each language is labelled with its lang_id.
+     *
+     * @return string The exposition, terminated by "# EOF".
+     */
+    string format(const vector<const language*>& languages) {
+        std::ostringstream outStream{};
+        write(outStream, languages);
+
+        return outStream.str();
+    }
+
+    /**
+     * @brief Writes the metrics of the given languages in the OpenMetrics text format.
+     *
+     * Counters are read with relaxed atomic loads, so scraping never blocks (or is blocked by) concurrent lookups.
+     * Key counts are computed once per load and resident bytes are kept up to date by eviction, so scraping doesn't walk
+     * the translation tables; see language::getStats().
+     *
+     * @remarks Languages must not be reloaded while they are being scraped, just as they must not be reloaded while being read.
+     *
+     * @param outStream The stream to write to.
+     * @param languages The languages to include. Each language is labelled with its lang_id.
+     */
+    void write(std::ostream& outStream, const vector<const language*>& languages) {
+        vector<snapshot_t> snapshots{};
+        snapshots.reserve(languages.size());
+
+        for (const auto lang : languages) {
+            if (lang == nullptr) { continue; }
+
+            snapshot_t snapshot{};
+            snapshot.label = escapeLabelValue(lang->getLangId());
+            snapshot.stats = lang->getStats();
+
+            const auto& metrics = lang->getMetrics();
+            for (size_t i = 0; i < static_cast<size_t>(counter_t::Count); i++) {
+                snapshot.counters[i] = metrics.get(static_cast<counter_t>(i));
+            }
+            snapshot.lastLoadNanoseconds = metrics.getLastLoadNanoseconds();
+
+            snapshots.push_back(std::move(snapshot));
+        }
+
+        // metric values must not be affected by the caller's locale
+        const auto previousLocale = outStream.imbue(std::locale::classic());
+        const auto previousPrecision = outStream.precision(9);
+
+        const auto counterOf = [](counter_t counter) { return [counter](const snapshot_t& snapshot) { return static_cast<double>(snapshot.get(counter)); }; };
+
+        writeFamily(outStream, snapshots, "borr_sections", "gauge", "", "The amount of sections of a language.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.stats.sections); });
+        writeFamily(outStream, snapshots, "borr_keys", "gauge", "", "The amount of translations of a language.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.stats.keys); });
+        writeFamily(outStream, snapshots, "borr_resident_bytes", "gauge", "bytes", "The estimated heap memory held by a language.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.stats.residentBytes); });
+        writeFamily(outStream, snapshots, "borr_mo_mapped_bytes", "gauge", "bytes", "The size of the gettext catalog mapped by a language.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.stats.moMappedBytes); });
+
+        writeFamily(outStream, snapshots, "borr_lookups", "counter", "", "Translation lookups.", counterOf(counter_t::Lookups));
+        writeFamily(outStream, snapshots, "borr_lookup_misses", "counter", "", "Translation lookups which found no translation.", counterOf(counter_t::Misses));
+        writeFamily(outStream, snapshots, "borr_expansions", "counter", "", "Variables and references which were expanded.", counterOf(counter_t::Expansions));
+
+        writeFamily(outStream, snapshots, "borr_hot_index_lookups", "counter", "", "Lookups which consulted the hot index.", counterOf(counter_t::HotLookups));
+        writeFamily(outStream, snapshots, "borr_hot_index_hits", "counter", "", "Lookups which were answered by the hot index.", counterOf(counter_t::HotHits));
+        writeFamily(outStream, snapshots, "borr_hot_index_hit_ratio", "gauge", "", "The share of hot index lookups which were hits; NaN before the first lookup.",
+                    [](const snapshot_t& snapshot) {
+                        const auto lookups = snapshot.get(counter_t::HotLookups);
+                        return lookups == 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(snapshot.get(counter_t::HotHits)) / static_cast<double>(lookups);
+                    });
+
+        writeFamily(outStream, snapshots, "borr_evicted_sections", "gauge", "", "Sections which are currently evicted to stay within the memory budget.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.stats.evictedSections); });
+        writeFamily(outStream, snapshots, "borr_section_evictions", "counter", "", "Sections evicted to stay within the memory budget.", counterOf(counter_t::Evictions));
+        writeFamily(outStream, snapshots, "borr_section_rematerialisations", "counter", "", "Evicted sections which were loaded again on access.", counterOf(counter_t::Rematerialisations));
+
+        writeFamily(outStream, snapshots, "borr_loads", "counter", "", "Completed (re)loads of a language.", counterOf(counter_t::Loads));
+        writeFamily(outStream, snapshots, "borr_load_seconds", "counter", "seconds", "The total time spent (re)loading a language.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.get(counter_t::LoadNanoseconds)) / 1e9; });
+        writeFamily(outStream, snapshots, "borr_last_load_seconds", "gauge", "seconds", "The duration of the last load of a language.",
+                    [](const snapshot_t& snapshot) { return static_cast<double>(snapshot.lastLoadNanoseconds) / 1e9; });
+
+        outStream << "# EOF\n";
+
+        outStream.precision(previousPrecision);
+        outStream.imbue(previousLocale);
+    }
+
+    /**
+     * @brief Escapes a label value; backslashes, double quotes and line feeds must be escaped.
+     *
+     * @param value The raw label value.
+     *
+     * @return string The escaped label value, without surrounding quotes.
+     */
+    string escapeLabelValue(string_view value) {
+        string escaped{};
+        escaped.reserve(value.size());
+
+        for (const auto c : value) {
+            switch (c) {
+                case '\\': escaped += "\\\\"; break;
+                case '"':  escaped += "\\\""; break;
+                case '\n': escaped += "\\n"; break;
+                default:   escaped += c; break;
+            }
+        }
+
+        return escaped;
+    }
+
+}
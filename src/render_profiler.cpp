@@ -0,0 +1,156 @@
+/**
+ * @file render_profiler.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the render_profiler class.
+ * @version 0.1
+ * @date 2023-03-02
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/extensions.hpp"
+#include "borr/render_profiler.hpp"
+
+namespace borr {
+
+    /**
+     * @brief Constructs a new, empty render profiler.
+     *
+     * @param sampleRate One in sampleRate renders is sampled. A rate of 0 or 1 samples every render.
+     * @param capacity The maximum amount of keys which are kept. A capacity of 0 is treated as 1.
+     */
+    render_profiler::render_profiler(uint32_t sampleRate /*= DEFAULT_SAMPLE_RATE*/, size_t capacity /*= DEFAULT_CAPACITY*/):
+        m_sampleRate(std::max<uint32_t>(sampleRate, 1)), m_capacity(std::max<size_t>(capacity, 1)), m_samplerId(extensions::nextSamplerId()) { }
+
+    /**
+     * @brief Determines whether the current render should be sampled.
+     *
+     * Only one in getSampleRate() calls per thread returns true; each profiler counts its calls separately.
+     *
+     * @return true If the render should be timed.
+     * @return false Otherwise.
+     */
+    bool render_profiler::shouldSample() const {
+        return extensions::shouldSample(m_samplerId, m_sampleRate);
+    }
+
+    /**
+     * @brief Merges a sampled span into the profile.
+     *
+     * Spans of a key which is already kept update its slowest duration, total and sample count.
+     * A new key is only kept if there is room, or if it is slower than the fastest kept key, which it then replaces.
+     *
+     * @param span The span; its slowest, total and samples fields are taken as a single observation.
+     */
+    void render_profiler::add(const slowspan_t& span) {
+        std::lock_guard<std::mutex> lock(m_spansMutex);
+
+        spankey_t key{ span.section, span.field, span.variable };
+        if (const auto kept = m_spans.find(key); kept != m_spans.end()) {
+            auto& existing = kept->second;
+            if (span.slowest > existing.slowest) {
+                existing.slowest = span.slowest;
+                existing.lookup = span.lookup;
+                existing.depth = span.depth;
+            }
+            existing.total += span.slowest;
+            existing.samples++;
+
+            return;
+        }
+
+        if (m_spans.size() >= m_capacity) {
+            const auto fastest = std::min_element(m_spans.begin(), m_spans.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.slowest < rhs.second.slowest; });
+            if (fastest->second.slowest >= span.slowest) { return; }
+
+            m_spans.erase(fastest);
+        }
+
+        auto& added = m_spans.emplace(std::move(key), span).first->second;
+        added.total = span.slowest;
+        added.samples = 1;
+    }
+
+    /**
+     * @brief Removes all kept spans and resets the amount of sampled renders.
+     */
+    void render_profiler::clear() {
+        std::lock_guard<std::mutex> lock(m_spansMutex);
+
+        m_spans.clear();
+        m_renders = 0;
+    }
+
+    /**
+     * @brief Gets all kept spans.
+     *
+     * @return vector<slowspan_t> The spans, slowest first.
+     */
+    vector<render_profiler::slowspan_t> render_profiler::getSlowest() const {
+        vector<slowspan_t> spans{};
+        {
+            std::lock_guard<std::mutex> lock(m_spansMutex);
+
+            spans.reserve(m_spans.size());
+            for (const auto& span : m_spans) { spans.push_back(span.second); }
+        }
+
+        std::stable_sort(spans.begin(), spans.end(), [](const slowspan_t& lhs, const slowspan_t& rhs) { return lhs.slowest > rhs.slowest; });
+        return spans;
+    }
+
+    /**
+     * @brief Writes the kept spans as a tab-separated table, slowest first.
+     *
+     * @code
+     * # slowest_ns	mean_ns	samples	kind	depth	section	field	variable
+     * 1843211	920410	4	expander	0	start_page	welcome	tenantName
+     * @endcode
+     *
+     * @param outStream The stream to write to.
+     */
+    void render_profiler::write(std::ostream& outStream) const {
+        outStream << "# slowest_ns\tmean_ns\tsamples\tkind\tdepth\tsection\tfield\tvariable\n";
+
+        for (const auto& span : getSlowest()) {
+            outStream << span.slowest.count() << '\t'
+                      << (span.samples == 0 ? 0 : span.total.count() / static_cast<int64_t>(span.samples)) << '\t'
+                      << span.samples << '\t'
+                      << getSpanKindName(span.kind) << '\t'
+                      << span.depth << '\t'
+                      << span.section << '\t' << span.field << '\t' << span.variable << '\n';
+        }
+    }
+
+    /**
+     * @brief Gets the name of a span kind.
+     *
+     * @param kind The kind.
+     *
+     * @return string_view The lowercase name of the kind.
+     */
+    string_view getSpanKindName(render_profiler::spankind_t kind) {
+        using spankind_t = render_profiler::spankind_t;
+
+        switch (kind) {
+            case spankind_t::Render:    return "render";
+            case spankind_t::Expander:  return "expander";
+            case spankind_t::Dynamic:   return "dynamic";
+            case spankind_t::Reference: return "reference";
+        }
+
+        return "unknown";
+    }
+
+}
@@ -0,0 +1,414 @@
+/**
+ * @file search_index.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains the implementation of the search_index class.
+ * @version 0.1
+ * @date 2023-03-04
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+/////////////////////
+// SYSTEM INCLUDES //
+/////////////////////
+// stl
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/////////////////////
+// LOCAL  INCLUDES //
+/////////////////////
+#include "borr/language.hpp"
+#include "borr/search_index.hpp"
+
+namespace borr {
+
+    namespace {
+
+        constexpr size_t    TRIGRAM_LENGTH = 3;
+        constexpr size_t    PARTITIONS = 256; //!< Posting lists are sorted and encoded per first byte of their trigram
+
+        /**
+         * @brief Folds ASCII letters to lower case; all other bytes (including UTF-8 sequences) are compared as they are.
+         */
+        constexpr char fold(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+        /**
+         * @brief Determines whether a byte is part of a word: ASCII letters and digits, and every byte of a UTF-8 sequence.
+         */
+        constexpr bool isWordByte(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || static_cast<uint8_t>(c) >= 0x80;
+        }
+
+        constexpr uint32_t getTrigram(char first, char second, char third) {
+            return (static_cast<uint32_t>(static_cast<uint8_t>(fold(first))) << 16) |
+                   (static_cast<uint32_t>(static_cast<uint8_t>(fold(second))) << 8) |
+                    static_cast<uint32_t>(static_cast<uint8_t>(fold(third)));
+        }
+
+        /**
+         * @brief Gets the sorted, unique trigrams of a string.
+         */
+        void getTrigrams(string_view str, vector<uint32_t>& outTrigrams) {
+            outTrigrams.clear();
+            if (str.size() < TRIGRAM_LENGTH) { return; }
+
+            for (size_t i = 0; i + TRIGRAM_LENGTH <= str.size(); i++) { outTrigrams.push_back(getTrigram(str[i], str[i + 1], str[i + 2])); }
+
+            std::sort(outTrigrams.begin(), outTrigrams.end());
+            outTrigrams.erase(std::unique(outTrigrams.begin(), outTrigrams.end()), outTrigrams.end());
+        }
+
+        /**
+         * @brief Finds a folded needle in a haystack, ignoring the case of ASCII letters.
+         */
+        size_t findFolded(string_view haystack, string_view foldedNeedle, size_t start = 0) {
+            if (start > haystack.size()) { return string_view::npos; }
+
+            const auto found = std::search(haystack.begin() + static_cast<std::ptrdiff_t>(start), haystack.end(), foldedNeedle.begin(), foldedNeedle.end(),
+                                           [](char lhs, char rhs) { return fold(lhs) == rhs; });
+            return found == haystack.end() ? string_view::npos : static_cast<size_t>(found - haystack.begin());
+        }
+
+        /**
+         * @brief Determines whether a haystack contains a folded word, delimited by non-word bytes or the bounds of the haystack.
+         */
+        bool containsWord(string_view haystack, string_view foldedWord) {
+            for (auto pos = findFolded(haystack, foldedWord); pos != string_view::npos; pos = findFolded(haystack, foldedWord, pos + 1)) {
+                const auto end = pos + foldedWord.size();
+                if ((pos == 0 || !isWordByte(haystack[pos - 1])) && (end == haystack.size() || !isWordByte(haystack[end]))) { return true; }
+            }
+
+            return false;
+        }
+
+        void appendVarint(vector<uint8_t>& output, uint32_t value) {
+            while (value >= 0x80) {
+                output.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+
+            output.push_back(static_cast<uint8_t>(value));
+        }
+
+        uint32_t readVarint(const uint8_t*& input) {
+            uint32_t value = 0;
+            for (uint32_t shift = 0;; shift += 7) {
+                const auto byte = *input++;
+                value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) { return value; }
+            }
+        }
+
+        /**
+         * @brief Runs task(0) to task(tasks - 1) on up to the given amount of threads, including the calling thread.
+         */
+        void forEachTask(size_t tasks, size_t threads, const std::function<void(size_t)>& task) {
+            std::atomic<size_t> nextTask{0};
+            const auto worker = [&] {
+                for (auto index = nextTask++; index < tasks; index = nextTask++) { task(index); }
+            };
+
+            threads = std::max<size_t>(1, std::min(threads, tasks));
+            vector<std::thread> workers{};
+            for (size_t i = 1; i < threads; i++) { workers.emplace_back(worker); }
+            worker();
+            for (auto& thread : workers) { thread.join(); }
+        }
+
+    }
+
+    /**
+     * @brief Indexes all translations of the given languages.
+     *
+     * The values are copied serially; extracting the trigrams and sorting and encoding the posting lists is spread across threads.
+     * Under a memory budget, evicted sections are re-materialised one at a time while they are copied.
+     *
+     * @param languages The languages to index; nullptrs are skipped. Hits are ordered like the languages.
+     * @param options Controls the amount of threads.
+     *
+     * @return search_index The index.
+     *
+     * @throws runtime_error If the languages contain more than 2^32 - 1 translations.
+     */
+    search_index search_index::fromLanguages(const vector<const language*>& languages, const indexopts_t& options /*= {}*/) {
+        search_index index{};
+
+        // copy all translations
+        std::map<string, uint32_t, std::less<>> sectionIds{};
+        for (const auto lang : languages) {
+            if (lang == nullptr) { continue; }
+
+            const auto languageId = static_cast<uint32_t>(index.m_langIds.size());
+            index.m_langIds.push_back(lang->getLangId());
+
+            string lastSection{};
+            uint32_t sectionId = UINT32_MAX;
+            lang->visitTranslations([&](const string& section, const string& field, const entry_t& entry) {
+                if (index.m_documents.size() >= UINT32_MAX) { throw std::runtime_error("Too many translations for a search index!"); }
+
+                // translations are visited section by section
+                if (sectionId == UINT32_MAX || lastSection != section) {
+                    sectionId = sectionIds.emplace(section, static_cast<uint32_t>(sectionIds.size())).first->second;
+                    if (sectionId == index.m_sections.size()) { index.m_sections.push_back(section); }
+                    lastSection = section;
+                }
+
+                document_t document{ languageId, sectionId, index.m_pool.size(), 0, static_cast<uint32_t>(field.size()), static_cast<uint32_t>(entry.value.size()) };
+                index.m_pool += field;
+                document.valueOffset = index.m_pool.size();
+                index.m_pool += entry.value;
+
+                index.m_documents.push_back(document);
+            });
+        }
+
+        const auto threads = options.threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : options.threads;
+        const auto chunkSize = std::max<size_t>(1, options.chunkSize);
+        const auto chunks = (index.m_documents.size() + chunkSize - 1) / chunkSize;
+
+        // extract the (trigram, translation) pairs of each chunk, bucketed by the first byte of the trigram;
+        // each pair holds the remaining two bytes of the trigram and the translation, and buckets keep the order of the translations
+        vector<std::array<vector<uint64_t>, PARTITIONS>> chunkBuckets(chunks);
+        forEachTask(chunks, threads, [&](size_t chunk) {
+            auto& buckets = chunkBuckets[chunk];
+            vector<uint32_t> trigrams{};
+
+            const auto end = std::min(index.m_documents.size(), (chunk + 1) * chunkSize);
+            for (auto document = chunk * chunkSize; document < end; document++) {
+                getTrigrams(index.getValue(static_cast<uint32_t>(document)), trigrams);
+                for (const auto trigram : trigrams) { buckets[trigram >> 16].push_back((static_cast<uint64_t>(trigram & 0xffff) << 32) | document); }
+            }
+        });
+
+        // group the pairs of each partition by trigram with a stable counting sort, so translations stay sorted, and encode the posting lists
+        struct partition_t {
+            vector<posting_t>   postings{};
+            vector<uint8_t>     data{};
+        };
+
+        std::array<partition_t, PARTITIONS> partitions{};
+        forEachTask(PARTITIONS, threads, [&](size_t partitionIndex) {
+            constexpr size_t SUFFIXES = 1 << 16;
+
+            const auto isEmpty = std::all_of(chunkBuckets.begin(), chunkBuckets.end(), [partitionIndex](const auto& buckets) { return buckets[partitionIndex].empty(); });
+            if (isEmpty) { return; }
+
+            vector<size_t> starts(SUFFIXES + 1, 0);
+            for (const auto& buckets : chunkBuckets) {
+                for (const auto pair : buckets[partitionIndex]) { starts[(pair >> 32) + 1]++; }
+            }
+            for (size_t suffix = 0; suffix < SUFFIXES; suffix++) { starts[suffix + 1] += starts[suffix]; }
+
+            vector<uint32_t> documents(starts.back());
+            auto next = starts;
+            for (auto& buckets : chunkBuckets) {
+                auto& bucket = buckets[partitionIndex];
+                for (const auto pair : bucket) { documents[next[pair >> 32]++] = static_cast<uint32_t>(pair); }
+
+                // every bucket is only read by the task of its partition
+                vector<uint64_t>().swap(bucket);
+            }
+
+            auto& partition = partitions[partitionIndex];
+            for (size_t suffix = 0; suffix < SUFFIXES; suffix++) {
+                if (starts[suffix] == starts[suffix + 1]) { continue; }
+
+                partition.postings.push_back({ static_cast<uint32_t>((partitionIndex << 16) | suffix), static_cast<uint32_t>(starts[suffix + 1] - starts[suffix]), partition.data.size() });
+
+                uint32_t previous = 0;
+                for (auto i = starts[suffix]; i < starts[suffix + 1]; i++) {
+                    appendVarint(partition.data, documents[i] - previous);
+                    previous = documents[i];
+                }
+            }
+        });
+        chunkBuckets.clear();
+
+        for (auto& partition : partitions) {
+            const auto offset = index.m_postingData.size();
+            for (auto& posting : partition.postings) {
+                posting.offset += offset;
+                index.m_postings.push_back(posting);
+            }
+
+            index.m_postingData.insert(index.m_postingData.end(), partition.data.begin(), partition.data.end());
+        }
+
+        return index;
+    }
+
+    /**
+     * @brief Finds all translations containing a string, ignoring the case of ASCII letters.
+     *
+     * @param needle The string to find. An empty needle matches nothing.
+     * @param maxHits The maximum amount of hits to return; 0 returns all hits.
+     *
+     * @return vector<searchhit_t> The matching translations, ordered by language, section and field.
+     */
+    vector<search_index::searchhit_t> search_index::findSubstring(string_view needle, size_t maxHits /*= DEFAULT_MAX_HITS*/) const {
+        if (needle.empty()) { return {}; }
+
+        string folded(needle);
+        std::transform(folded.begin(), folded.end(), folded.begin(), fold);
+
+        return collectHits({ folded }, maxHits, [&folded](string_view value) { return findFolded(value, folded) != string_view::npos; });
+    }
+
+    /**
+     * @brief Finds all translations containing all of the given words, in any order, ignoring the case of ASCII letters.
+     *
+     * Words consist of ASCII letters and digits and UTF-8 sequences; everything else separates words,
+     * so "file save" matches "Save the file?" but not "Saved files".
+     *
+     * @param words The words to find. A query without words matches nothing.
+     * @param maxHits The maximum amount of hits to return; 0 returns all hits.
+     *
+     * @return vector<searchhit_t> The matching translations, ordered by language, section and field.
+     */
+    vector<search_index::searchhit_t> search_index::findWords(string_view words, size_t maxHits /*= DEFAULT_MAX_HITS*/) const {
+        vector<string> terms{};
+        for (size_t pos = 0; pos < words.size();) {
+            if (!isWordByte(words[pos])) {
+                pos++;
+                continue;
+            }
+
+            auto& term = terms.emplace_back();
+            for (; pos < words.size() && isWordByte(words[pos]); pos++) { term += fold(words[pos]); }
+        }
+
+        if (terms.empty()) { return {}; }
+
+        return collectHits(terms, maxHits, [&terms](string_view value) {
+            return std::all_of(terms.begin(), terms.end(), [&value](const string& term) { return containsWord(value, term); });
+        });
+    }
+
+    /**
+     * @brief Gets an estimate of the memory used by the index, including the copied values.
+     */
+    size_t search_index::getMemoryUsage() const {
+        size_t bytes = sizeof(search_index) + m_pool.capacity() +
+                       m_documents.capacity() * sizeof(document_t) +
+                       m_postings.capacity() * sizeof(posting_t) +
+                       m_postingData.capacity();
+
+        for (const auto& langId : m_langIds) { bytes += sizeof(string) + langId.capacity(); }
+        for (const auto& section : m_sections) { bytes += sizeof(string) + section.capacity(); }
+
+        return bytes;
+    }
+
+    /**
+     * @brief Intersects the posting lists of all trigrams of the given terms, shortest list first.
+     *
+     * @param terms The folded terms.
+     * @param outCandidates Receives the sorted translations containing all trigrams.
+     *
+     * @return true If the terms contain trigrams.
+     * @return false If all terms are too short to contain a trigram; all translations are candidates.
+     */
+    bool search_index::findCandidates(const vector<string>& terms, candidates_t& outCandidates) const {
+        outCandidates.clear();
+
+        vector<uint32_t> termTrigrams{};
+        vector<const posting_t*> postings{};
+        for (const auto& term : terms) {
+            getTrigrams(term, termTrigrams);
+            for (const auto trigram : termTrigrams) {
+                const auto posting = findPosting(trigram);
+                if (posting == nullptr) { return true; } // no translation contains the trigram
+
+                postings.push_back(posting);
+            }
+        }
+
+        if (postings.empty()) { return false; }
+
+        std::sort(postings.begin(), postings.end(), [](const posting_t* lhs, const posting_t* rhs) { return lhs->count < rhs->count; });
+        postings.erase(std::unique(postings.begin(), postings.end()), postings.end());
+
+        const auto* input = m_postingData.data() + postings.front()->offset;
+        outCandidates.reserve(postings.front()->count);
+        for (uint32_t i = 0, document = 0; i < postings.front()->count; i++) {
+            document += readVarint(input);
+            outCandidates.push_back(document);
+        }
+
+        candidates_t kept{};
+        for (size_t list = 1; list < postings.size() && !outCandidates.empty(); list++) {
+            input = m_postingData.data() + postings[list]->offset;
+            kept.clear();
+
+            size_t candidate = 0;
+            for (uint32_t i = 0, document = 0; i < postings[list]->count && candidate < outCandidates.size(); i++) {
+                document += readVarint(input);
+                while (candidate < outCandidates.size() && outCandidates[candidate] < document) { candidate++; }
+                if (candidate < outCandidates.size() && outCandidates[candidate] == document) { kept.push_back(document); }
+            }
+
+            outCandidates.swap(kept);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Finds the posting list of a trigram.
+     *
+     * @return const posting_t* The posting list, or nullptr if no translation contains the trigram.
+     */
+    const search_index::posting_t* search_index::findPosting(uint32_t trigram) const {
+        const auto found = std::lower_bound(m_postings.begin(), m_postings.end(), trigram, [](const posting_t& posting, uint32_t value) { return posting.trigram < value; });
+        return found == m_postings.end() || found->trigram != trigram ? nullptr : &*found;
+    }
+
+    /**
+     * @brief Gets the value of an indexed translation.
+     */
+    string_view search_index::getValue(uint32_t document) const {
+        const auto& entry = m_documents[document];
+        return string_view(m_pool).substr(entry.valueOffset, entry.valueLength);
+    }
+
+    /**
+     * @brief Gets an indexed translation as a hit.
+     */
+    search_index::searchhit_t search_index::getHit(uint32_t document) const {
+        const auto& entry = m_documents[document];
+        return { m_langIds[entry.language], m_sections[entry.section], string_view(m_pool).substr(entry.fieldOffset, entry.fieldLength), getValue(document) };
+    }
+
+    /**
+     * @brief Verifies the candidates of the given terms and collects the translations which match.
+     *
+     * @param terms The folded terms; their trigrams select the candidates.
+     * @param maxHits The maximum amount of hits; 0 collects all hits.
+     * @param matches Determines whether a candidate's value matches the query.
+     *
+     * @return vector<searchhit_t> The matching translations, in index order.
+     */
+    template<typename Predicate>
+    vector<search_index::searchhit_t> search_index::collectHits(const vector<string>& terms, size_t maxHits, const Predicate& matches) const {
+        candidates_t candidates{};
+        const auto indexed = findCandidates(terms, candidates);
+        const auto count = indexed ? candidates.size() : m_documents.size();
+
+        vector<searchhit_t> hits{};
+        for (size_t i = 0; i < count && (maxHits == 0 || hits.size() < maxHits); i++) {
+            const auto document = indexed ? candidates[i] : static_cast<uint32_t>(i);
+            if (matches(getValue(document))) { hits.push_back(getHit(document)); }
+        }
+
+        return hits;
+    }
+
+}
@@ -0,0 +1,117 @@
+/**
+ * @file AccessProfileTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for access profiles and the profile-guided hot index.
+ * @version 0.1
+ * @date 2023-02-12
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "borr/access_profile.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+
+using borr::access_profile;
+
+namespace fs = std::filesystem;
+
+namespace {
+    const string TEST_LANG = R"(
+        lang_id = "test_lang"
+        lang_ver = "1.0.0"
+        lang_desc = "This is a test"
+
+        [menu]
+        open = "Open"
+        close = "Close"
+        title = "${menu:open} or ${menu:close}"
+
+        [about]
+        text[] = "Line 1"
+        text[] = "Line 2"
+    )";
+}
+
+TEST(AccessProfileTests, testSampledRecording) {
+    access_profile profile(4);
+
+    for (size_t i = 0; i < 400; i++) { profile.record("menu", "open"); }
+
+    // every fourth access is recorded with a weight of four
+    ASSERT_EQ(profile.getCount("menu", "open"), 400);
+    ASSERT_EQ(profile.getCount("menu", "close"), 0);
+
+    // every profile samples its own accesses, even when several are used alternately
+    access_profile other(4);
+    for (size_t i = 0; i < 400; i++) {
+        profile.record("menu", "close");
+        other.record("menu", "close");
+    }
+    ASSERT_EQ(profile.getCount("menu", "close"), 400);
+    ASSERT_EQ(other.getCount("menu", "close"), 400);
+}
+
+TEST(AccessProfileTests, testHottestOrder) {
+    access_profile profile(1);
+    profile.add("menu", "open", 10);
+    profile.add("menu", "close", 1000);
+    profile.add("about", "text", 100);
+
+    const auto hottest = profile.getHottest(2);
+    ASSERT_EQ(hottest.size(), 2);
+    ASSERT_EQ(hottest[0], borr::keypair_t("menu", "close"));
+    ASSERT_EQ(hottest[1], borr::keypair_t("about", "text"));
+}
+
+TEST(AccessProfileTests, testSaveAndLoad) {
+    const auto profilePath = fs::temp_directory_path() / "borr_access_profile_test.txt";
+
+    access_profile profile(1);
+    profile.add("menu", "open", 10);
+    profile.add("about", "text", 3);
+    ASSERT_NO_THROW(profile.save(profilePath));
+
+    const auto loaded = access_profile::fromFile(profilePath);
+    ASSERT_EQ(loaded.size(), 2);
+    ASSERT_EQ(loaded.getCount("menu", "open"), 10);
+    ASSERT_EQ(loaded.getCount("about", "text"), 3);
+
+    fs::remove(profilePath);
+
+    ASSERT_THROW(access_profile::fromFile(profilePath), fs::filesystem_error);
+}
+
+TEST(AccessProfileTests, testProfileGuidedLayout) {
+    borr::language lang;
+    ASSERT_NO_THROW(borr::language::fromString(TEST_LANG, lang));
+
+    auto profile = std::make_shared<access_profile>(1);
+    lang.setAccessProfile(profile);
+
+    for (size_t i = 0; i < 10; i++) { lang.getString("menu", "title"); }
+    lang.getString("about", "text");
+    lang.getString("menu", "does_not_exist");
+
+    ASSERT_EQ(profile->getCount("menu", "title"), 10);
+    ASSERT_EQ(profile->getCount("about", "text"), 1);
+
+    lang.setAccessProfile(nullptr);
+    ASSERT_EQ(lang.applyAccessProfile(*profile), 2); // the missing key isn't laid out
+
+    ASSERT_EQ(lang.getString("menu", "title"), "Open or Close");
+    ASSERT_EQ(lang.getString("menu", "title", false), "${menu:open} or ${menu:close}");
+    ASSERT_EQ(lang.getString("about", "text"), "Line 1\nLine 2");
+    ASSERT_EQ(lang.getString("menu", "open"), "Open");
+    ASSERT_FALSE(lang.getString("menu", "does_not_exist").has_value());
+
+    const borr::language copy = lang;
+    ASSERT_EQ(copy.getString("menu", "title"), "Open or Close");
+}
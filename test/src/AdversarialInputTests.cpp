@@ -0,0 +1,163 @@
+/**
+ * @file AdversarialInputTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains tests ensuring that parsing and expansion stay linear on pathological input.
+ * @version 0.1
+ * @date 2023-02-26
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/extensions.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::language;
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr size_t ONE_MB = 1024 * 1024;
+    constexpr double MAX_SECONDS = 2.0; //!< A linear pass over a few MB takes milliseconds; backtracking takes minutes
+
+    const string HEADER = "lang_id = \"en_GB\"\nlang_ver = \"1.0.0\"\nlang_desc = \"Adversarial\"\n\n[test]\n";
+
+    /**
+     * @brief A single pathological borrfile.
+     */
+    struct corpusentry_t {
+        string  name;
+        string  borrfile;
+    };
+
+    string repeat(const string& str, size_t count) {
+        string repeated{};
+        repeated.reserve(str.size() * count);
+        for (size_t i = 0; i < count; i++) { repeated += str; }
+
+        return repeated;
+    }
+
+    vector<corpusentry_t> getCorpus(size_t size) {
+        return {
+            { "long_line",              HEADER + "long_line = \"" + string(size, 'a') + "\"\n" },
+            { "unterminated_quote",     HEADER + "unterminated = \"" + string(size, 'a') + "\n" },
+            { "quotes",                 HEADER + "quotes = \"" + string(size, '"') + "\n" },
+            { "hashes",                 HEADER + string(size, '#') + "x\n" + "hashes = \"" + string(size, '#') + "\" #" + string(size, '#') + "\n" },
+            { "variable_openers",       HEADER + "openers = \"" + repeat("${", size / 2) + "\"\n" },
+            { "nested_braces",          HEADER + "nested = \"" + repeat("${", size / 4) + repeat("}", size / 4) + "\"\n" },
+            { "variables",              HEADER + "variables = \"" + repeat("${abcd}", size / 7) + "\"\n" },
+            { "references",             HEADER + "target = \"x\"\nreferences = \"" + repeat("${test:target}", size / 14) + "\"\n" },
+            { "unterminated_variables", HEADER + "unterminated_variables = \"" + repeat("${test:target", size / 13) + "\"\n" },
+            { "whitespace",             HEADER + "whitespace" + string(size, ' ') + "= \"x\"\n" },
+            { "long_section",           HEADER + "[" + string(size, 'a') + "]\nfield = \"x\"\n" },
+            { "long_field",             HEADER + string(size, 'a') + " = \"x\"\n" },
+            { "many_lines",             HEADER + repeat("field[] = \"line\"\n", size / 17) },
+        };
+    }
+
+    /**
+     * @brief Parses a borrfile and renders all of its translations.
+     */
+    void parseAndRender(const string& borrfile) {
+        const auto lang = language::fromString(borrfile);
+        for (const auto& sectionName : lang.getSectionNames()) {
+            const auto section = lang.getSection(sectionName);
+            for (const auto& field : *section) { lang.getString(sectionName, field.first); }
+        }
+    }
+
+    double measureSeconds(const std::function<void()>& func) {
+        const auto startTime = clock_type::now();
+        func();
+        return std::chrono::duration<double>(clock_type::now() - startTime).count();
+    }
+
+}
+
+class AdversarialInputTests: public testing::Test, public language { };
+
+TEST_F(AdversarialInputTests, testMatchesRegexGrammar) {
+    namespace rc = std::regex_constants;
+    const std::regex sectionRegex(SECTION_REGEX.data(), rc::optimize);
+    const std::regex translationRegex(TRANSLATION_REGEX.data(), rc::optimize);
+    const std::regex variableRegex(VARIABLE_REGEX.data(), rc::optimize);
+    const std::regex commentRegex(R"(#[^\n]+[^"]$)", rc::optimize);
+
+    // short random lines over the characters the grammar cares about, so every branch is hit
+    const string alphabet = "ab_Z09[]= \t\"#${}:\\`\n";
+    std::mt19937 random(20230226);
+    std::uniform_int_distribution<size_t> lengthDist(0, 24);
+    std::uniform_int_distribution<size_t> charDist(0, alphabet.size() - 1);
+
+    const vector<string> fixedLines = {
+        "[section]", "[a]", "[ab]", "[]", "[a_b]", "[a1]", "field = \"value\"", "f = \"value\"", "field[] = \"value\"",
+        "field=\"value\"", "field = \"\"", "field = \"va\"lue\"", "field = \"value\" # comment", "field = \"value\"#c\"",
+        "${var_name}", "${test:test_01}", "${0bla}", "${ab}", "${a:b}", "${ab:cd}",
+    };
+
+    for (size_t i = 0; i < 20000 + fixedLines.size(); i++) {
+        string line{};
+        if (i < fixedLines.size()) {
+            line = fixedLines[i];
+        } else {
+            const auto length = lengthDist(random);
+            for (size_t j = 0; j < length; j++) { line += alphabet[charDist(random)]; }
+        }
+
+        string name{};
+        string value{};
+        ASSERT_EQ(isSection(line, name), std::regex_match(borr::extensions::trim(line), sectionRegex)) << line;
+        ASSERT_EQ(isTranslation(line, name, value), std::regex_match(line, translationRegex)) << line;
+
+        std::smatch variableMatch{};
+        const auto hasVariable = std::regex_search(line, variableMatch, variableRegex);
+        ASSERT_EQ(containsVariable(line, name), hasVariable) << line;
+        if (hasVariable) { ASSERT_EQ("${" + name + "}", variableMatch.str()) << line; }
+
+        auto expected = line;
+        std::smatch commentMatch{};
+        if (std::regex_search(expected, commentMatch, commentRegex)) { expected.erase(static_cast<size_t>(commentMatch.position(0))); }
+        ASSERT_EQ(removeInlineComments(line), borr::extensions::trim(expected)) << line;
+    }
+}
+
+TEST_F(AdversarialInputTests, testTimeBounds) {
+    for (const auto& entry : getCorpus(ONE_MB)) {
+        const auto seconds = measureSeconds([&] { parseAndRender(entry.borrfile); });
+        EXPECT_LT(seconds, MAX_SECONDS) << entry.name;
+    }
+}
+
+TEST_F(AdversarialInputTests, testLinearScaling) {
+    constexpr size_t SMALL = ONE_MB / 4;
+    constexpr size_t REPETITIONS = 3;
+
+    const auto smallCorpus = getCorpus(SMALL);
+    const auto largeCorpus = getCorpus(SMALL * 4);
+
+    for (size_t i = 0; i < smallCorpus.size(); i++) {
+        double smallSeconds = MAX_SECONDS;
+        double largeSeconds = MAX_SECONDS;
+        for (size_t j = 0; j < REPETITIONS; j++) {
+            smallSeconds = std::min(smallSeconds, measureSeconds([&] { parseAndRender(smallCorpus[i].borrfile); }));
+            largeSeconds = std::min(largeSeconds, measureSeconds([&] { parseAndRender(largeCorpus[i].borrfile); }));
+        }
+
+        // four times the input may take four times as long; quadratic work would take sixteen times as long
+        EXPECT_LT(largeSeconds, smallSeconds * 10 + 0.005) << smallCorpus[i].name;
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ * @file BundleCacheTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for content fingerprints and the bundle cache.
+ * @version 0.1
+ * @date 2023-03-03
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/bundle_cache.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::bundle_cache;
+using borr::bundleformat_t;
+using borr::language;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    const string SOURCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[test]
+app_name = "libborr"
+title = "Welcome to ${test:app_name}"
+path = "C:\temp"
+
+[other]
+greeting = "Hello"
+)";
+
+}
+
+TEST(BundleCacheTests, testFingerprint) {
+    const auto lang = language::fromString(SOURCE);
+    ASSERT_NE(lang.getFingerprint(), 0);
+
+    // equal contents give equal fingerprints, regardless of the source
+    ASSERT_EQ(language::fromString(SOURCE).getFingerprint(), lang.getFingerprint());
+    ASSERT_EQ(language(lang).getFingerprint(), lang.getFingerprint());
+
+    const auto packPath = fs::temp_directory_path() / "borr_bundle_cache_test.borrpack";
+    lang.toPackFile(packPath);
+    ASSERT_EQ(language::fromPackFile(fs::directory_entry(packPath)).getFingerprint(), lang.getFingerprint());
+    fs::remove(packPath);
+
+    // any change to the header or a translation changes the fingerprint
+    auto changed = SOURCE;
+    changed.replace(changed.find("Hello"), 5, "Hallo");
+    ASSERT_NE(language::fromString(changed).getFingerprint(), lang.getFingerprint());
+
+    changed = SOURCE;
+    changed.replace(changed.find("1.0.0"), 5, "1.0.1");
+    ASSERT_NE(language::fromString(changed).getFingerprint(), lang.getFingerprint());
+}
+
+TEST(BundleCacheTests, testRender) {
+    const auto lang = language::fromString(SOURCE);
+
+    const auto json = bundle_cache::render(lang, { "test", "missing" });
+    ASSERT_EQ(json.contentType, bundle_cache::JSON_CONTENT_TYPE);
+    ASSERT_EQ(json.etag, bundle_cache::getETag(json.body));
+    ASSERT_NE(json.body.find(R"({"lang_id":"en_GB","fingerprint":")"), string::npos);
+    ASSERT_NE(json.body.find(R"(","sections":{"test":{"app_name":"libborr","path":"C:\\temp","title":"Welcome to libborr"}}})"), string::npos);
+
+    const auto binary = bundle_cache::render(lang, {}, bundleformat_t::Binary);
+    ASSERT_EQ(binary.contentType, bundle_cache::BINARY_CONTENT_TYPE);
+    ASSERT_NE(binary.etag, json.etag);
+
+    uint64_t fingerprint = 0;
+    vector<string> decoded{};
+    ASSERT_TRUE(bundle_cache::visitBinary(binary.body, fingerprint, [&decoded](auto section, auto field, auto value) {
+        decoded.push_back(string(section) + ":" + string(field) + "=" + string(value));
+    }));
+    ASSERT_EQ(fingerprint, lang.getFingerprint());
+    ASSERT_EQ(decoded, vector<string>({ "other:greeting=Hello", "test:app_name=libborr", "test:path=C:\\temp", "test:title=Welcome to libborr" }));
+
+    ASSERT_FALSE(bundle_cache::visitBinary(binary.body.substr(0, binary.body.size() - 1), fingerprint, [](auto, auto, auto) { }));
+    ASSERT_FALSE(bundle_cache::visitBinary(json.body, fingerprint, [](auto, auto, auto) { }));
+}
+
+TEST(BundleCacheTests, testCache) {
+    auto lang = language::fromString(SOURCE);
+    bundle_cache cache(2);
+
+    const auto first = cache.get(lang, { "test", "other" });
+    ASSERT_EQ(cache.get(lang, { "other", "test", "other" }), first);
+    ASSERT_EQ(cache.getHits(), 1);
+    ASSERT_EQ(cache.getMisses(), 1);
+
+    // a copy has the same contents, so it shares the bundle
+    ASSERT_EQ(cache.get(language(lang), { "test", "other" }), first);
+
+    // reloading with different contents replaces the stale bundle
+    auto changed = SOURCE;
+    changed.replace(changed.find("Hello"), 5, "Hallo");
+    language::fromString(changed, lang);
+
+    const auto reloaded = cache.get(lang, { "test", "other" });
+    ASSERT_NE(reloaded->etag, first->etag);
+    ASSERT_NE(reloaded->body.find("Hallo"), string::npos);
+    ASSERT_EQ(cache.size(), 1);
+
+    // the oldest bundle is evicted first
+    cache.get(lang, { "test" });
+    cache.get(lang, { "other" });
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_NE(cache.get(lang, { "test", "other" }), reloaded);
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.getHits(), 0);
+}
+
+TEST(BundleCacheTests, testIfNoneMatch) {
+    const string etag = R"("0123456789abcdef")";
+
+    ASSERT_TRUE(bundle_cache::matchesIfNoneMatch(etag, etag));
+    ASSERT_TRUE(bundle_cache::matchesIfNoneMatch(R"("other", W/"0123456789abcdef")", etag));
+    ASSERT_TRUE(bundle_cache::matchesIfNoneMatch(" * ", etag));
+    ASSERT_FALSE(bundle_cache::matchesIfNoneMatch("", etag));
+    ASSERT_FALSE(bundle_cache::matchesIfNoneMatch(R"("other", ,"0123456789abcdee")", etag));
+}
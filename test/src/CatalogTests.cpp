@@ -0,0 +1,143 @@
+/**
+ * @file CatalogTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the catalog class and its Accept-Language negotiation.
+ * @version 0.1
+ * @date 2023-02-23
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/catalog.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::catalog;
+using borr::language;
+
+namespace {
+
+    language makeLanguage(const string& langId) {
+        return language::fromString("lang_id = \"" + langId + "\"\nlang_ver = \"1.0.0\"\nlang_desc = \"" + langId + "\"\n\n[test]\nname = \"" + langId + "\"\n");
+    }
+
+    string negotiatedId(const catalog& cat, const string& header) {
+        const auto lang = cat.negotiate(header);
+        return lang == nullptr ? "" : lang->getLangId();
+    }
+
+}
+
+TEST(CatalogTests, testParseAcceptLanguage) {
+    ASSERT_EQ(catalog::canonicaliseTag(" en_GB.UTF-8 "), "en-gb");
+    ASSERT_EQ(catalog::canonicaliseTag("de_DE@euro"), "de-de");
+
+    const auto ranges = catalog::parseAcceptLanguage("fr;q=0.5, de-CH , en;Q=0.9, *;q=0.1, xx;q=2, de;q=0.5");
+    ASSERT_EQ(ranges.size(), 5);
+    ASSERT_EQ(ranges[0].tag, "de-ch");
+    ASSERT_EQ(ranges[1].tag, "en");
+    ASSERT_DOUBLE_EQ(ranges[1].quality, 0.9);
+    ASSERT_EQ(ranges[2].tag, "fr"); // equal quality keeps the header order
+    ASSERT_EQ(ranges[3].tag, "de");
+    ASSERT_EQ(ranges[4].tag, "*");
+
+    ASSERT_TRUE(catalog::parseAcceptLanguage("").empty());
+    ASSERT_TRUE(catalog::parseAcceptLanguage(" , ;q=1").empty());
+}
+
+TEST(CatalogTests, testNegotiate) {
+    catalog cat{};
+    cat.addLanguage(makeLanguage("en_GB"));
+    cat.addLanguage(makeLanguage("de"));
+    cat.addLanguage(makeLanguage("fr_FR"));
+
+    ASSERT_EQ(cat.size(), 3);
+    ASSERT_NE(cat.getLanguage("EN-gb"), nullptr);
+    ASSERT_EQ(cat.negotiate("it"), nullptr);
+
+    ASSERT_EQ(negotiatedId(cat, "en-GB,en;q=0.8"), "en_GB");
+    ASSERT_EQ(negotiatedId(cat, "de-CH-1996"), "de"); // truncation
+    ASSERT_EQ(negotiatedId(cat, "it, fr-CA;q=0.8, de;q=0.5"), "de"); // exact (truncated) matches beat primary subtag matches
+    ASSERT_EQ(negotiatedId(cat, "it, fr-CA;q=0.8"), "fr_FR");
+    ASSERT_EQ(negotiatedId(cat, "de;q=0, en-US"), "en_GB");
+
+    cat.setDefaultLanguage("en-gb");
+    ASSERT_EQ(negotiatedId(cat, "it"), "en_GB");
+    ASSERT_EQ(negotiatedId(cat, ""), "en_GB");
+    ASSERT_EQ(negotiatedId(cat, "*;q=0.5, en;q=0"), "de");
+
+    // replacing the default language keeps it the default
+    cat.addLanguage(makeLanguage("en-GB"));
+    ASSERT_EQ(cat.size(), 3);
+    ASSERT_EQ(negotiatedId(cat, "it"), "en-GB");
+
+    ASSERT_TRUE(cat.removeLanguage("en_gb"));
+    ASSERT_FALSE(cat.removeLanguage("en_gb"));
+    ASSERT_EQ(cat.getDefaultLanguage(), nullptr);
+    ASSERT_EQ(cat.negotiate("it"), nullptr);
+}
+
+TEST(CatalogTests, testNegotiationCache) {
+    catalog cat{ 32 };
+    cat.addLanguage(makeLanguage("en_GB"));
+    cat.addLanguage(makeLanguage("de"));
+
+    ASSERT_EQ(negotiatedId(cat, "de-AT"), "de");
+    ASSERT_EQ(negotiatedId(cat, "de-AT"), "de");
+    ASSERT_EQ(cat.getCachedHeaderCount(), 1);
+
+    // changing the languages invalidates cached results
+    cat.addLanguage(makeLanguage("de_AT"));
+    ASSERT_EQ(cat.getCachedHeaderCount(), 0);
+    ASSERT_EQ(negotiatedId(cat, "de-AT"), "de_AT");
+
+    // the cache is bounded
+    for (size_t i = 0; i < 1000; i++) { cat.negotiate("x" + std::to_string(i) + ", en"); }
+    ASSERT_LE(cat.getCachedHeaderCount(), 32);
+
+    // long headers aren't cached
+    cat.negotiate(string(catalog::MAX_CACHED_HEADER_LENGTH + 1, 'a'));
+    ASSERT_LE(cat.getCachedHeaderCount(), 32);
+
+    catalog uncached{ 0 };
+    uncached.addLanguage(makeLanguage("de"));
+    ASSERT_EQ(negotiatedId(uncached, "de-AT"), "de");
+    ASSERT_EQ(uncached.getCachedHeaderCount(), 0);
+}
+
+TEST(CatalogTests, testConcurrentNegotiation) {
+    catalog cat{ 64 };
+    cat.addLanguage(makeLanguage("en_GB"));
+    cat.addLanguage(makeLanguage("de"));
+    cat.addLanguage(makeLanguage("fr"));
+    cat.setDefaultLanguage("en_GB");
+
+    const vector<std::pair<string, string>> expected = {
+        { "de-CH, en;q=0.5", "de" }, { "fr-BE", "fr" }, { "it", "en_GB" }, { "en-US", "en_GB" },
+    };
+
+    constexpr size_t THREADS = 4;
+    vector<std::thread> threads{};
+    vector<size_t> failures(THREADS, 0);
+    for (size_t i = 0; i < THREADS; i++) {
+        threads.emplace_back([&, i] {
+            for (size_t j = 0; j < 2000; j++) {
+                const auto& request = expected[(i + j) % expected.size()];
+                if (negotiatedId(cat, request.first) != request.second) { failures[i]++; }
+                // distinct headers force insertions and evictions
+                cat.negotiate("x" + std::to_string(j % 200) + ", fr");
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (const auto failure : failures) { ASSERT_EQ(failure, 0); }
+    ASSERT_LE(cat.getCachedHeaderCount(), 64);
+}
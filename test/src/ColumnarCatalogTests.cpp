@@ -0,0 +1,115 @@
+/**
+ * @file ColumnarCatalogTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the columnar_catalog class.
+ * @version 0.1
+ * @date 2023-02-24
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/catalog.hpp"
+#include "borr/columnar_catalog.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::catalog;
+using borr::columnar_catalog;
+using borr::language;
+
+namespace {
+
+    const string EN_SOURCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[test]
+greeting = "Hello"
+farewell = "Goodbye"
+colour = "Colour"
+)";
+
+    const string DE_SOURCE = R"(
+lang_id = "de_DE"
+lang_ver = "1.0.0"
+lang_desc = "Deutsch"
+
+[test]
+greeting = "Hallo"
+umlaut = "Ä"
+)";
+
+    const string DE_CH_SOURCE = R"(
+lang_id = "de_CH"
+lang_ver = "1.0.0"
+lang_desc = "Schweizerdeutsch"
+
+[test]
+greeting = "Grüezi"
+)";
+
+}
+
+TEST(ColumnarCatalogTests, testColumns) {
+    catalog languages{};
+    languages.addLanguage(language::fromString(EN_SOURCE));
+    languages.addLanguage(language::fromString(DE_SOURCE));
+    languages.addLanguage(language::fromString(DE_CH_SOURCE));
+
+    const columnar_catalog columns{ languages };
+    ASSERT_EQ(columns.getLocaleCount(), 3);
+    ASSERT_EQ(columns.getKeyCount(), 4);
+
+    const auto en = columns.getLocaleIndex("en-gb");
+    const auto de = columns.getLocaleIndex("de_DE");
+    const auto deCh = columns.getLocaleIndex("de_CH");
+    ASSERT_NE(en, columnar_catalog::INVALID_LOCALE);
+    ASSERT_EQ(columns.getLocaleId(de), "de_DE");
+    ASSERT_EQ(columns.getLocaleIndex("fr"), columnar_catalog::INVALID_LOCALE);
+
+    const auto greeting = columns.getKeyId("test", "greeting");
+    ASSERT_NE(greeting, columnar_catalog::INVALID_KEY);
+    ASSERT_EQ(columns.getKeyName(greeting).second, "greeting");
+    ASSERT_EQ(columns.getKeyId("test", "missing"), columnar_catalog::INVALID_KEY);
+
+    const auto values = columns.getAllValues(greeting);
+    ASSERT_EQ(values.size(), 3);
+    ASSERT_EQ(values[en], "Hello");
+    ASSERT_EQ(values[de], "Hallo");
+    ASSERT_EQ(values[deCh], "Grüezi");
+
+    const auto umlaut = columns.getKeyId("test", "umlaut");
+    ASSERT_EQ(columns.getMissingLocales(umlaut), (vector<size_t>{ std::min(en, deCh), std::max(en, deCh) }));
+    ASSERT_EQ(columns.getMissingKeys(deCh).size(), 3);
+    ASSERT_TRUE(columns.getMissingKeys(en).size() == 1 && columns.getMissingKeys(en)[0] == umlaut);
+
+    // fallback chains
+    const auto farewell = columns.getKeyId("test", "farewell");
+    ASSERT_EQ(columns.getValue(umlaut, { deCh, de, en }), "Ä");
+    ASSERT_EQ(columns.getValue(farewell, { deCh, de, en }), "Goodbye");
+    ASSERT_FALSE(columns.getValue(farewell, { deCh, de }).has_value());
+    ASSERT_FALSE(columns.getValue(columnar_catalog::INVALID_KEY, en).has_value());
+}
+
+TEST(ColumnarCatalogTests, testReplaceLanguage) {
+    columnar_catalog columns{};
+    const auto en = columns.addLanguage(language::fromString(EN_SOURCE));
+    columns.addLanguage(language::fromString(DE_SOURCE));
+
+    // languages added later extend every column
+    const auto umlaut = columns.getKeyId("test", "umlaut");
+    ASSERT_FALSE(columns.getValue(umlaut, en).has_value());
+
+    auto updated = EN_SOURCE;
+    updated.replace(updated.find("Hello"), 5, "Hi");
+    ASSERT_EQ(columns.addLanguage(language::fromString(updated)), en);
+    ASSERT_EQ(columns.getLocaleCount(), 2);
+    ASSERT_EQ(columns.getValue(columns.getKeyId("test", "greeting"), en), "Hi");
+}
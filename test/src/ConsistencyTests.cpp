@@ -0,0 +1,108 @@
+/**
+ * @file ConsistencyTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the consistency checks between languages.
+ * @version 0.1
+ * @date 2023-02-25
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/consistency.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::language;
+
+namespace consistency = borr::consistency;
+
+namespace {
+
+    const string REFERENCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[about]
+text[] = "First line"
+text[] = "Second line"
+text[] = "Third line"
+
+[test]
+app_name = "libborr"
+items = "${count} items in ${test:app_name}"
+only_reference = "Missing elsewhere"
+title = "Title"
+)";
+
+    const string TRANSLATION = R"(
+lang_id = "de_DE"
+lang_ver = "1.0.0"
+lang_desc = "Deutsch"
+
+[about]
+text[] = "Erste Zeile"
+text[] = "Zweite Zeile"
+
+[test]
+app_name = "libborr"
+items = "Elemente in ${test:app_name} ${total}"
+only_translation = "Extra"
+title = "Titel"
+)";
+
+}
+
+TEST(ConsistencyTests, testCheckLanguage) {
+    const auto reference = language::fromString(REFERENCE);
+    const auto translation = language::fromString(TRANSLATION);
+
+    ASSERT_TRUE(consistency::checkLanguage(reference, reference).isConsistent());
+
+    const auto report = consistency::checkLanguage(reference, translation);
+    ASSERT_EQ(report.langId, "de_DE");
+    ASSERT_EQ(report.getIssueCount(), 4);
+
+    ASSERT_EQ(report.missingKeys, (vector<consistency::keyname_t>{ { "test", "only_reference" } }));
+    ASSERT_EQ(report.extraKeys, (vector<consistency::keyname_t>{ { "test", "only_translation" } }));
+
+    ASSERT_EQ(report.variableMismatches.size(), 1);
+    ASSERT_EQ(report.variableMismatches[0].key.second, "items");
+    ASSERT_EQ(report.variableMismatches[0].missingVariables, vector<string>{ "count" });
+    ASSERT_EQ(report.variableMismatches[0].extraVariables, vector<string>{ "total" });
+
+    ASSERT_EQ(report.lineCountMismatches.size(), 1);
+    ASSERT_EQ(report.lineCountMismatches[0].key.first, "about");
+    ASSERT_EQ(report.lineCountMismatches[0].referenceLines, 3);
+    ASSERT_EQ(report.lineCountMismatches[0].lines, 2);
+}
+
+TEST(ConsistencyTests, testParallelCheck) {
+    const auto reference = language::fromString(REFERENCE);
+    const auto translation = language::fromString(TRANSLATION);
+
+    vector<const language*> languages{};
+    for (size_t i = 0; i < 8; i++) { languages.push_back(i % 2 == 0 ? &translation : &reference); }
+
+    const auto reports = consistency::check(reference, languages, 4);
+    ASSERT_EQ(reports.size(), languages.size());
+    for (size_t i = 0; i < reports.size(); i++) {
+        ASSERT_EQ(reports[i].isConsistent(), i % 2 != 0);
+        ASSERT_EQ(reports[i].langId, languages[i]->getLangId());
+    }
+
+    const auto json = consistency::toJson(reference.getLangId(), { reports[0] });
+    ASSERT_NE(json.find(R"("reference": "en_GB")"), string::npos);
+    ASSERT_NE(json.find(R"("missing_keys": ["test:only_reference"])"), string::npos);
+    ASSERT_NE(json.find(R"({ "key": "test:items", "missing": ["count"], "extra": ["total"] })"), string::npos);
+    ASSERT_NE(json.find(R"({ "key": "about:text", "reference_lines": 3, "lines": 2 })"), string::npos);
+
+    ASSERT_EQ(consistency::toJson("en_GB", {}), "{\n  \"reference\": \"en_GB\",\n  \"languages\": []\n}\n");
+}
@@ -0,0 +1,139 @@
+/**
+ * @file ExpanderRegistryTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the expander registry and compiled templates.
+ * @version 0.1
+ * @date 2023-02-10
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/compiled_template.hpp"
+#include "borr/expander_registry.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::compiled_template;
+using borr::expander_registry;
+
+namespace {
+    string fooExpander(const string&) { return "foo"; }
+    string barExpander(const string&) { return "bar"; }
+}
+
+TEST(ExpanderRegistryTests, testFindBeforeAndAfterFreeze) {
+    expander_registry registry;
+
+    vector<string> names;
+    for (size_t i = 0; i < 500; i++) {
+        names.push_back("var_" + std::to_string(i));
+        ASSERT_TRUE(registry.addDefault(names.back(), fooExpander));
+    }
+
+    for (size_t i = 0; i < names.size(); i++) { ASSERT_EQ(registry.find(names[i]), i); }
+
+    registry.freeze();
+    ASSERT_TRUE(registry.isFrozen());
+
+    for (size_t i = 0; i < names.size(); i++) { ASSERT_EQ(registry.find(names[i]), i); }
+    ASSERT_EQ(registry.find("not_registered"), expander_registry::NPOS);
+    ASSERT_EQ(registry.find(""), expander_registry::NPOS);
+}
+
+TEST(ExpanderRegistryTests, testFrozenRegistryRejectsNewNames) {
+    expander_registry registry;
+    ASSERT_TRUE(registry.addDefault("date", fooExpander));
+    registry.freeze();
+
+    ASSERT_FALSE(registry.addCallback("new_var", [](const string&) { return "new"; }));
+    ASSERT_TRUE(registry.addCallback("date", [](const string&) { return "custom"; }));
+    ASSERT_EQ(registry.size(), 1);
+}
+
+TEST(ExpanderRegistryTests, testCustomExpandersOverrideDefaults) {
+    expander_registry registry;
+    ASSERT_TRUE(registry.addDefault("my_var", fooExpander));
+    ASSERT_FALSE(registry.addDefault("my_var", barExpander));
+    ASSERT_TRUE(registry.addCallback("my_var", barExpander));
+    ASSERT_FALSE(registry.addCallback("my_var", fooExpander));
+
+    string value;
+    ASSERT_TRUE(registry.invoke(registry.find("my_var"), "my_var", value));
+    ASSERT_EQ(value, "bar");
+
+    registry.removeCallback("my_var");
+    ASSERT_TRUE(registry.invoke(registry.find("my_var"), "my_var", value));
+    ASSERT_EQ(value, "foo");
+
+    ASSERT_FALSE(registry.invoke(expander_registry::NPOS, "my_var", value));
+}
+
+TEST(ExpanderRegistryTests, testIsVariableName) {
+    ASSERT_TRUE(compiled_template::isVariableName("var_name"));
+    ASSERT_TRUE(compiled_template::isVariableName("_Test"));
+    ASSERT_TRUE(compiled_template::isVariableName("test:test_01"));
+    ASSERT_TRUE(compiled_template::isVariableName("date"));
+
+    ASSERT_FALSE(compiled_template::isVariableName("0bla"));
+    ASSERT_FALSE(compiled_template::isVariableName("*broken_var"));
+    ASSERT_FALSE(compiled_template::isVariableName("test:0test"));
+    ASSERT_FALSE(compiled_template::isVariableName("a:b:c"));
+    ASSERT_FALSE(compiled_template::isVariableName(""));
+}
+
+TEST(ExpanderRegistryTests, testCompileAndBind) {
+    using segkind_t = compiled_template::segkind_t;
+
+    const string source = "Hello ${name_var}, see ${sect:field} and ${unknown_var}!";
+
+    auto tmpl = compiled_template::compile(source);
+    ASSERT_TRUE(tmpl.isCompiled());
+    ASSERT_TRUE(tmpl.hasVariables());
+    ASSERT_EQ(tmpl.getSegments().size(), 7);
+
+    expander_registry registry;
+    ASSERT_TRUE(registry.addDefault("name_var", fooExpander));
+    registry.freeze();
+    tmpl.bind(source, registry);
+
+    const auto& segments = tmpl.getSegments();
+    ASSERT_EQ(segments[0].kind, segkind_t::Literal);
+    ASSERT_EQ(source.substr(segments[0].offset, segments[0].length), "Hello ");
+    ASSERT_EQ(segments[1].kind, segkind_t::Expander);
+    ASSERT_EQ(segments[1].slot, 0);
+    ASSERT_EQ(segments[3].kind, segkind_t::Reference);
+    ASSERT_EQ(segments[3].separator, 4);
+    ASSERT_EQ(segments[5].kind, segkind_t::Empty);
+    ASSERT_EQ(source.substr(segments[6].offset, segments[6].length), "!");
+
+    ASSERT_FALSE(compiled_template::compile("No variables ${no} at all").hasVariables());
+}
+
+TEST(ExpanderRegistryTests, testReferencesAndDepthLimit) {
+    borr::language lang;
+    ASSERT_NO_THROW(borr::language::fromString(R"(
+        lang_id = "test_lang"
+        lang_ver = "1.0.0"
+        lang_desc = "This is a test"
+
+        [test]
+        app_name = "libborr"
+        title = "${test:app_name} - ${test:app_name}"
+        cycle_a = "a${test:cycle_b}"
+        cycle_b = "b${test:cycle_a}"
+    )", lang));
+
+    ASSERT_EQ(lang.getString("test", "title"), "libborr - libborr");
+    ASSERT_EQ(lang.getString("test", "title", false), "${test:app_name} - ${test:app_name}");
+
+    const auto cycle = lang.getString("test", "cycle_a");
+    ASSERT_TRUE(cycle.has_value());
+    ASSERT_EQ(cycle->size(), borr::language::MAX_EXPANSION_DEPTH + 1);
+}
@@ -84,4 +84,11 @@ TEST(ExtensionsTests, testSplitString_newLines) {
     ASSERT_TRUE(borr::extensions::splitString(borr::extensions::trim(STRING_TO_SPLIT), "\n", tokens));
 
     ASSERT_EQ(tokens.size(), 3);
-}
\ No newline at end of file
+}
+
+TEST(ExtensionsTests, testEscapeJson) {
+    ASSERT_EQ(borr::extensions::escapeJson("plain text"), "plain text");
+    ASSERT_EQ(borr::extensions::escapeJson(R"(say "hi" \o/)"), R"(say \"hi\" \\o/)");
+    ASSERT_EQ(borr::extensions::escapeJson("line one\nline two\t\x01"), R"(line one\nline two\t\u0001)");
+    ASSERT_EQ(borr::extensions::escapeJson("Schließen"), "Schließen");
+}
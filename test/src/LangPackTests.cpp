@@ -0,0 +1,145 @@
+/**
+ * @file LangPackTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for precompiled language packs.
+ * @version 0.1
+ * @date 2023-02-17
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/lang_pack.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::lang_pack;
+using borr::language;
+
+namespace fs = std::filesystem;
+
+class LangPackTests: public testing::Test {
+    protected:
+        void SetUp() override {
+            m_packPath = fs::temp_directory_path() / "borr_lang_pack_test.borrpack";
+        }
+
+        void TearDown() override { fs::remove(m_packPath); }
+
+        const string SOURCE = R"(
+lang_id = "de_DE"
+lang_ver = "1.2.3"
+lang_desc = "Deutsch"
+
+[menu]
+open = "Öffnen"
+close = "Schließen ${menu:open}"
+
+[about]
+text[] = "Zeile eins"
+text[] = "Zeile zwei"
+)";
+
+        fs::path m_packPath{};
+};
+
+TEST_F(LangPackTests, testRoundTrip) {
+    const auto sourceHash = lang_pack::hashContents(SOURCE);
+    language::fromString(SOURCE).toPackFile(m_packPath, sourceHash);
+
+    ASSERT_EQ(lang_pack::readSourceHash(m_packPath), sourceHash);
+
+    const auto lang = language::fromPackFile(fs::directory_entry(m_packPath));
+    ASSERT_EQ(lang.getLangId(), "de_DE");
+    ASSERT_EQ(lang.getLangDescription(), "Deutsch");
+    ASSERT_EQ(*lang.getLanguageVersion(), "v1.2.3");
+    ASSERT_EQ(lang.getSectionNames(), vector<string>({ "about", "menu" }));
+
+    ASSERT_EQ(lang.getString("menu", "close"), "Schließen Öffnen");
+    ASSERT_EQ(lang.getString("menu", "close", false), "Schließen ${menu:open}");
+    ASSERT_EQ(lang.getString("about", "text"), "Zeile eins\nZeile zwei");
+    ASSERT_FALSE(lang.getString("menu", "save").has_value());
+}
+
+TEST_F(LangPackTests, testSourceHash) {
+    ASSERT_NE(lang_pack::hashContents(SOURCE), lang_pack::hashContents(SOURCE + "\n"));
+    ASSERT_FALSE(lang_pack::readSourceHash(m_packPath).has_value());
+
+    std::ofstream(m_packPath) << SOURCE;
+    ASSERT_FALSE(lang_pack::readSourceHash(m_packPath).has_value());
+}
+
+TEST_F(LangPackTests, testInvalidPacks) {
+    language::fromString(SOURCE).toPackFile(m_packPath);
+
+    vector<char> contents{};
+    {
+        std::ifstream inStream(m_packPath, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(inStream), std::istreambuf_iterator<char>());
+    }
+
+    // truncate the string pool
+    std::ofstream(m_packPath, std::ios::binary | std::ios::trunc).write(contents.data(), static_cast<std::streamsize>(contents.size() - 4));
+    language lang = language::fromString(SOURCE);
+    ASSERT_THROW(language::fromPackFile(fs::directory_entry(m_packPath), lang), std::runtime_error);
+    ASSERT_TRUE(lang.getSectionNames().empty());
+
+    // wrong magic
+    contents[0] = 'X';
+    std::ofstream(m_packPath, std::ios::binary | std::ios::trunc).write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    ASSERT_THROW(language::fromPackFile(fs::directory_entry(m_packPath)), std::runtime_error);
+
+    ASSERT_THROW(language::fromPackFile(fs::directory_entry(m_packPath.string() + ".missing")), fs::filesystem_error);
+}
+
+TEST_F(LangPackTests, testVisitSection) {
+    const auto pack = lang_pack::fromString(lang_pack::writeString({ "de_DE", "Deutsch", "1.2.3", 0 }, {
+        { "menu", "open", "Öffnen" }, { "about", "text", "Text" }, { "menu", "close", "Schließen" }, { "zzz", "a", "b" }
+    }));
+
+    ASSERT_EQ(pack->getMeta().langId, "de_DE");
+    ASSERT_EQ(pack->getEntryCount(), 4);
+    ASSERT_EQ(pack->getSectionNames(), vector<string>({ "about", "menu", "zzz" }));
+
+    vector<string> fields{};
+    ASSERT_TRUE(pack->visitSection("menu", [&](auto section, auto field, auto value) {
+        ASSERT_EQ(section, "menu");
+        fields.emplace_back(string(field) + "=" + string(value));
+    }));
+    ASSERT_EQ(fields, vector<string>({ "close=Schließen", "open=Öffnen" }));
+
+    ASSERT_FALSE(pack->visitSection("missing", [](auto, auto, auto) { FAIL(); }));
+    ASSERT_FALSE(pack->visitSection("", [](auto, auto, auto) { FAIL(); }));
+}
+
+TEST_F(LangPackTests, testMemoryBudget) {
+    language::fromString(SOURCE).toPackFile(m_packPath);
+
+    auto lang = language::fromPackFile(fs::directory_entry(m_packPath));
+    lang.setMemoryBudget(1);
+    ASSERT_EQ(lang.getStats().evictedSections, 2);
+
+    // sections are re-materialised from the mapped pack
+    ASSERT_EQ(lang.getString("menu", "close"), "Schließen Öffnen");
+    ASSERT_EQ(lang.getString("about", "text"), "Zeile eins\nZeile zwei");
+    ASSERT_EQ(lang.getStats().evictedSections, 2);
+
+    // overwriting the pack replaces the file, so the mapped pack keeps its contents
+    language::fromString(R"(lang_id = "de_DE"
+[menu]
+close = "Zu"
+)").toPackFile(m_packPath);
+    ASSERT_EQ(lang.getString("about", "text"), "Zeile eins\nZeile zwei");
+    ASSERT_EQ(lang.getString("menu", "close"), "Schließen Öffnen");
+    ASSERT_EQ(language::fromPackFile(fs::directory_entry(m_packPath)).getString("menu", "close"), "Zu");
+}
@@ -13,6 +13,11 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+
 using std::string;
 using std::vector;
 
@@ -233,4 +238,284 @@ TEST_F(LanguageClassTests, testVariableExpansion) {
     ASSERT_EQ(lang.getString("test", "test_03"), "The date is " + dateExpander(""));
     ASSERT_EQ(lang.getString("test", "test_04"), "The time is " + timeExpander(""));
 
-}
\ No newline at end of file
+}
+
+TEST_F(LanguageClassTests, testWarm) {
+    auto lang = std::make_unique<borr::language>();
+    ASSERT_NO_THROW(borr::language::fromString(R"(
+        lang_id = "test_lang"
+        lang_ver = "1.0.0"
+        lang_desc = "This is a test"
+
+        [test]
+        app_name = "libborr"
+        title = "Welcome to ${test:app_name}"
+        broken = "Missing: ${test:does_not_exist}"
+    )", *lang));
+
+    borr::warmopts_t options{};
+    options.hotKeys = { { "test", "title" }, { "test", "nope" } };
+
+    const auto stats = lang->warm(options);
+    ASSERT_EQ(stats.templatesCompiled, 3);
+    ASSERT_EQ(stats.referencesResolved, 1);
+    ASSERT_EQ(stats.hotKeysRendered, 1);
+    ASSERT_EQ(stats.hotKeysMissing, 1);
+    ASSERT_GT(stats.bytesTouched, 0);
+
+    ASSERT_EQ(lang->getString("test", "title"), "Welcome to libborr");
+    ASSERT_EQ(lang->getString("test", "broken"), "Missing: ");
+
+    // resolved references must follow the copy, not the original
+    const borr::language copy = *lang;
+    lang.reset();
+    ASSERT_EQ(copy.getString("test", "title"), "Welcome to libborr");
+}
+
+TEST_F(LanguageClassTests, testGetStats) {
+    const auto lang = borr::language::fromString(R"(
+        lang_id = "test_lang"
+        lang_ver = "1.0.0"
+        lang_desc = "This is a test"
+
+        [test]
+        app_name = "libborr"
+        title = "Welcome to ${test:app_name}"
+        about[] = "Line one"
+        about[] = "Line two"
+
+        [other]
+        x_field = "A translation long enough not to fit into the small string buffer"
+    )");
+
+    ASSERT_EQ(lang.getSectionNames(), vector<string>({ "other", "test" }));
+
+    const auto stats = lang.getStats();
+    ASSERT_EQ(stats.sections, 2);
+    ASSERT_EQ(stats.keys, 4);
+    ASSERT_EQ(stats.multilineKeys, 1);
+    ASSERT_EQ(stats.keysWithVariables, 1);
+    ASSERT_EQ(stats.keyBytes, string("othertestapp_nametitleaboutx_field").size());
+    ASSERT_GT(stats.residentBytes, stats.keyBytes + stats.valueBytes);
+    ASSERT_EQ(stats.moMappedBytes, 0);
+}
+
+TEST_F(LanguageClassTests, testFromStream) {
+    const string contents = "lang_id = \"test_lang\"\r\nlang_ver = \"1.0.0\"\n\n[test]\napp_name = \"libborr\"\r\n"
+                            "title = \"Welcome to ${test:app_name}\"\nabout[] = \"Line one\"\nabout[] = \"Line two\"";
+    const auto expected = borr::language::fromString(contents);
+
+    // buffers smaller than a line must still split lines correctly
+    for (const size_t bufferSize : { 1, 5, 16, 4096 }) {
+        std::istringstream inStream(contents);
+        const auto lang = borr::language::fromStream(inStream, { bufferSize });
+
+        ASSERT_EQ(lang.getLangId(), "test_lang");
+        ASSERT_EQ(lang.getString("test", "title"), expected.getString("test", "title"));
+        ASSERT_EQ(lang.getString("test", "about"), "Line one\nLine two");
+    }
+
+    std::istringstream longLines(contents);
+    ASSERT_THROW(borr::language::fromStream(longLines, { 8, 20 }), std::runtime_error);
+
+    std::istringstream empty("\n\n");
+    ASSERT_THROW(borr::language::fromStream(empty), std::runtime_error);
+}
+
+TEST_F(LanguageClassTests, testRenderMemoisation) {
+    size_t invocations = 0;
+    ASSERT_NO_THROW(borr::language::addVarExpansionCallback("countingExpander", [&](const string&) {
+        invocations++;
+        return "expensive";
+    }));
+
+    const auto lang = borr::language::fromString(R"(
+        lang_id = "test_lang"
+        lang_ver = "1.0.0"
+        lang_desc = "This is a test"
+
+        [test]
+        app_name = "libborr"
+        header = "${countingExpander} ${test:app_name}"
+        footer = "${test:app_name} - ${countingExpander}"
+        page = "${test:header} ${countingExpander} ${countingExpander} ${test:footer} ${test:app_name}"
+    )");
+
+    ASSERT_EQ(lang.getString("test", "page"), "expensive libborr expensive expensive libborr - expensive libborr");
+    ASSERT_EQ(invocations, 1);
+
+    // the memo only lives for a single top-level render
+    ASSERT_EQ(lang.getString("test", "header"), "expensive libborr");
+    ASSERT_EQ(invocations, 2);
+
+    borr::language::removeVarExpansionCallback("countingExpander");
+}
+
+TEST_F(LanguageClassTests, testGetSectionExpanded) {
+    size_t invocations = 0;
+    ASSERT_NO_THROW(borr::language::addVarExpansionCallback("sectionExpander", [&](const string&) {
+        invocations++;
+        return "expensive";
+    }));
+
+    const auto lang = borr::language::fromString(R"(
+        lang_id = "test_lang"
+        lang_ver = "1.0.0"
+        lang_desc = "This is a test"
+
+        [test]
+        app_name = "libborr"
+        header = "${sectionExpander} ${test:app_name}"
+        footer = "${test:app_name} - ${sectionExpander}"
+    )");
+
+    vector<std::pair<string, string>> fields{};
+    ASSERT_TRUE(lang.getSectionExpanded("test", [&](const string& field, std::string_view value) { fields.emplace_back(field, string(value)); }));
+
+    // fields arrive in sorted order and the memo is shared by the whole section
+    ASSERT_EQ(fields.size(), 3);
+    ASSERT_EQ(fields[0], std::make_pair(string("app_name"), string("libborr")));
+    ASSERT_EQ(fields[1], std::make_pair(string("footer"), string("libborr - expensive")));
+    ASSERT_EQ(fields[2], std::make_pair(string("header"), string("expensive libborr")));
+    ASSERT_EQ(invocations, 1);
+
+    ASSERT_FALSE(lang.getSectionExpanded("missing", [](const string&, std::string_view) { FAIL(); }));
+
+    borr::language::removeVarExpansionCallback("sectionExpander");
+}
+
+TEST_F(LanguageClassTests, testGetSectionExpandedParallel) {
+    std::ostringstream source{};
+    source << "lang_id = \"test_lang\"\nlang_ver = \"1.0.0\"\nlang_desc = \"This is a test\"\n\n[big]\n";
+    source << "app_name = \"libborr\"\n";
+    for (size_t i = 0; i < 1000; i++) {
+        source << "field_" << i << " = \"" << (i % 3 == 0 ? "Plain " : "Uses ${big:app_name} ") << i << "\"\n";
+    }
+
+    const auto lang = borr::language::fromString(source.str());
+
+    std::map<string, string> serial{};
+    ASSERT_TRUE(lang.getSectionExpanded("big", [&](const string& field, std::string_view value) { serial.emplace(field, value); }));
+    ASSERT_EQ(serial.size(), 1001);
+    ASSERT_EQ(serial.at("field_1"), "Uses libborr 1");
+    ASSERT_EQ(serial.at("field_3"), "Plain 3");
+
+    borr::expandopts_t options{};
+    options.threads = 4;
+    options.parallelThreshold = 1;
+    options.chunkSize = 64;
+
+    vector<std::pair<string, string>> parallel{};
+    ASSERT_TRUE(lang.getSectionExpanded("big", [&](const string& field, std::string_view value) { parallel.emplace_back(field, string(value)); }, options));
+    const vector<std::pair<string, string>> expected(serial.begin(), serial.end());
+    ASSERT_EQ(parallel, expected);
+
+    for (const auto& field : serial) { ASSERT_EQ(lang.getString("big", field.first), field.second); }
+}
+
+TEST_F(LanguageClassTests, testGetSectionExpandedThrowingExpander) {
+    ASSERT_TRUE(borr::language::addVarExpansionCallback("sectionThrower", [](const string&) -> string { throw std::runtime_error("expander failed"); }));
+
+    std::ostringstream source{};
+    source << "lang_id = \"test_lang\"\nlang_ver = \"1.0.0\"\nlang_desc = \"This is a test\"\n\n[big]\n";
+    for (size_t i = 0; i < 100; i++) { source << "field_" << i << " = \"Throws ${sectionThrower} " << i << "\"\n"; }
+
+    const auto lang = borr::language::fromString(source.str());
+
+    borr::expandopts_t options{};
+    options.threads = 4;
+    options.parallelThreshold = 1;
+    options.chunkSize = 8;
+
+    // serial and parallel mode both pass the exception to the caller
+    ASSERT_THROW(lang.getSectionExpanded("big", [](const string&, std::string_view) { }), std::runtime_error);
+    ASSERT_THROW(lang.getSectionExpanded("big", [](const string&, std::string_view) { }, options), std::runtime_error);
+
+    borr::language::removeVarExpansionCallback("sectionThrower");
+}
+
+TEST_F(LanguageClassTests, testRenderMemoOverflow) {
+    borr::render_memo memo{};
+    for (size_t i = 0; i < borr::render_memo::INLINE_CAPACITY * 2; i++) {
+        ASSERT_EQ(memo.insert("var_" + std::to_string(i), std::to_string(i)), std::to_string(i));
+    }
+
+    ASSERT_EQ(memo.size(), borr::render_memo::INLINE_CAPACITY * 2);
+    for (size_t i = 0; i < borr::render_memo::INLINE_CAPACITY * 2; i++) {
+        const auto value = memo.find("var_" + std::to_string(i));
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, std::to_string(i));
+    }
+    ASSERT_EQ(memo.find("var_x"), nullptr);
+}
+
+TEST_F(LanguageClassTests, testPeekMetadata) {
+    const auto langPath = std::filesystem::temp_directory_path() / "borr_peek_metadata_test.borr";
+    const auto packPath = std::filesystem::temp_directory_path() / "borr_peek_metadata_test.borrpack";
+
+    std::ofstream(langPath) << R"(
+# the header
+lang_id = "en_GB"
+lang_ver = "1.2.3"
+lang_desc = "British English" # inline comment
+lang_author = "Simon Cahill"
+lang_keys = "2"
+
+[test]
+test_01 = "Hello"
+lang_hidden = "not a header field"
+)";
+
+    const auto meta = borr::language::peekMetadata(langPath);
+    ASSERT_EQ(meta.langId, "en_GB");
+    ASSERT_EQ(*meta.langVer, "v1.2.3");
+    ASSERT_EQ(meta.langDescription, "British English");
+    ASSERT_EQ(meta.fields.size(), 1);
+    ASSERT_EQ(meta.fields.at("lang_author"), "Simon Cahill");
+    ASSERT_EQ(meta.sizeHints.keys, 2);
+
+    borr::language::fromFile(std::filesystem::directory_entry(langPath)).toPackFile(packPath);
+    const auto packMeta = borr::language::peekMetadata(packPath);
+    ASSERT_EQ(packMeta.langId, "en_GB");
+    ASSERT_EQ(*packMeta.langVer, "v1.2.3");
+    ASSERT_TRUE(packMeta.fields.empty());
+
+    std::filesystem::remove(langPath);
+    std::filesystem::remove(packPath);
+
+    ASSERT_THROW(borr::language::peekMetadata(langPath), std::filesystem::filesystem_error);
+}
+
+TEST_F(LanguageClassTests, testSizeHints) {
+    const auto langPath = std::filesystem::temp_directory_path() / "borr_size_hints_test.borr";
+
+    // invalid hints are ignored; wrong hints never change what is loaded
+    std::ofstream(langPath) << R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+lang_sections = "-1"
+lang_keys = "4194304"
+
+[test]
+test_01 = "One"
+test_02 = "Two"
+)";
+
+    const auto meta = borr::language::peekMetadata(langPath);
+    ASSERT_EQ(meta.sizeHints.sections, 0);
+    ASSERT_EQ(meta.sizeHints.keys, 4194304);
+    ASSERT_TRUE(meta.fields.empty());
+
+    const auto wrongHints = borr::language::fromFile(std::filesystem::directory_entry(langPath));
+    ASSERT_EQ(wrongHints.getStats().sections, 1);
+    ASSERT_EQ(wrongHints.getStats().keys, 2);
+    ASSERT_EQ(wrongHints.getString("test", "test_02"), "Two");
+    ASSERT_FALSE(wrongHints.getString("", "lang_keys").has_value());
+
+    std::filesystem::remove(langPath);
+
+    std::ofstream(langPath) << "lang_id = \"en_GB\"\nlang_keys = \"99999999999\"\n[test]\ntest_01 = \"One\"\n";
+    ASSERT_EQ(borr::language::peekMetadata(langPath).sizeHints.keys, 0);
+    std::filesystem::remove(langPath);
+}
@@ -0,0 +1,146 @@
+/**
+ * @file LoadTraceTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the load tracer.
+ * @version 0.1
+ * @date 2023-03-01
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::language;
+using borr::loadevent_t;
+using borr::loadphase_t;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    const string SOURCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[test]
+app_name = "libborr"
+title = "Welcome to ${test:app_name}"
+
+[other]
+greeting = "Hello"
+
+[test]
+late = "Reopened section"
+)";
+
+    /**
+     * @brief A completed phase, with its name copied so it outlives the event.
+     */
+    struct recorded_t {
+        loadphase_t phase;
+        string      name;
+        size_t      items;
+    };
+
+    /**
+     * @brief Records all events while in scope.
+     */
+    class trace_recorder {
+        public:
+            trace_recorder() {
+                language::setLoadTracer([this](const loadevent_t& event) {
+                    ASSERT_GE(event.duration.count(), 0);
+                    events.push_back({ event.phase, string(event.name), event.items });
+                });
+            }
+
+            ~trace_recorder() { language::setLoadTracer({}); }
+
+            vector<recorded_t> get(loadphase_t phase) const {
+                vector<recorded_t> matching{};
+                for (const auto& event : events) {
+                    if (event.phase == phase) { matching.push_back(event); }
+                }
+
+                return matching;
+            }
+
+            vector<recorded_t> events{};
+    };
+
+}
+
+TEST(LoadTraceTests, testFromString) {
+    trace_recorder recorder{};
+    const auto lang = language::fromString(SOURCE);
+
+    // every section block is reported, in order
+    const auto sections = recorder.get(loadphase_t::Section);
+    ASSERT_EQ(sections.size(), 3);
+    ASSERT_EQ(sections[0].name, "test");
+    ASSERT_EQ(sections[0].items, 2);
+    ASSERT_EQ(sections[1].name, "other");
+    ASSERT_EQ(sections[2].name, "test");
+    ASSERT_EQ(sections[2].items, 3);
+
+    ASSERT_EQ(recorder.get(loadphase_t::Parse).size(), 1);
+    ASSERT_EQ(recorder.get(loadphase_t::Link).at(0).items, 4);
+    ASSERT_EQ(recorder.get(loadphase_t::Residency).size(), 1);
+    ASSERT_TRUE(recorder.get(loadphase_t::Read).empty());
+
+    // the load is reported last
+    ASSERT_EQ(recorder.events.back().phase, loadphase_t::Load);
+    ASSERT_EQ(recorder.events.back().name, "string");
+    ASSERT_EQ(recorder.events.back().items, 4);
+    ASSERT_EQ(borr::getPhaseName(loadphase_t::Section), "section");
+}
+
+TEST(LoadTraceTests, testFromFileAndPack) {
+    const auto langPath = fs::temp_directory_path() / "borr_load_trace_test.borr";
+    const auto packPath = fs::temp_directory_path() / "borr_load_trace_test.borrpack";
+    std::ofstream(langPath) << SOURCE;
+
+    {
+        trace_recorder recorder{};
+        language::fromFile(fs::directory_entry(langPath)).toPackFile(packPath);
+
+        // fromFile() reads through fromStream(), but only one load is reported
+        ASSERT_EQ(recorder.get(loadphase_t::Load).size(), 1);
+        ASSERT_EQ(recorder.get(loadphase_t::Load).at(0).name, langPath.string());
+        ASSERT_EQ(recorder.get(loadphase_t::Read).at(0).items, SOURCE.size());
+
+        // the final read only reaches EOF, but is completed like all others
+        ASSERT_EQ(recorder.get(loadphase_t::Read).size(), 2);
+        ASSERT_EQ(recorder.get(loadphase_t::Read).back().items, 0);
+
+        recorder.events.clear();
+        const auto pack = language::fromPackFile(fs::directory_entry(packPath));
+        ASSERT_EQ(recorder.get(loadphase_t::Load).at(0).name, packPath.string());
+        ASSERT_EQ(recorder.get(loadphase_t::Read).size(), 1);
+        ASSERT_EQ(recorder.get(loadphase_t::Parse).at(0).items, 4);
+        ASSERT_EQ(recorder.get(loadphase_t::Section).size(), 2);
+    }
+
+    // failed loads report no load event, and removing the tracer stops reporting
+    trace_recorder recorder{};
+    ASSERT_THROW(language::fromString(""), std::runtime_error);
+    ASSERT_TRUE(recorder.get(loadphase_t::Load).empty());
+
+    language::setLoadTracer({});
+    language::fromFile(fs::directory_entry(langPath));
+    ASSERT_TRUE(recorder.get(loadphase_t::Load).empty());
+
+    fs::remove(langPath);
+    fs::remove(packPath);
+}
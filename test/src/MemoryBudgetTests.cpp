@@ -0,0 +1,158 @@
+/**
+ * @file MemoryBudgetTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the memory budget of languages.
+ * @version 0.1
+ * @date 2023-02-20
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::lang_metrics;
+using borr::language;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    /**
+     * @brief Gets the name of the n-th section; section names may only contain letters and underscores.
+     */
+    string sectionName(size_t index) {
+        string name = "section_";
+        do {
+            name += static_cast<char>('a' + index % 26);
+            index /= 26;
+        } while (index > 0);
+
+        return name;
+    }
+
+    /**
+     * @brief Generates a language with the given amount of sections, each of which references the previous section.
+     */
+    string generateSource(size_t sections) {
+        string source = "lang_id = \"en_GB\"\nlang_ver = \"1.0.0\"\nlang_desc = \"British English\"\n";
+
+        for (size_t i = 0; i < sections; i++) {
+            source += "[" + sectionName(i) + "]\n";
+            source += "title = \"Title number " + std::to_string(i) + " with a value too long for small strings\"\n";
+            source += "text[] = \"First line of section " + std::to_string(i) + "\"\n";
+            source += "text[] = \"Second line of section " + std::to_string(i) + "\"\n";
+            if (i > 0) { source += "ref = \"See ${" + sectionName(i - 1) + ":title}\"\n"; }
+        }
+
+        return source;
+    }
+
+    const string TITLE_0 = "Title number 0 with a value too long for small strings";
+
+}
+
+TEST(MemoryBudgetTests, testEvictionAndRematerialisation) {
+    constexpr size_t SECTIONS = 64;
+    const auto source = generateSource(SECTIONS);
+    const auto reference = language::fromString(source);
+
+    auto lang = language::fromString(source);
+    const auto fullSize = lang.getStats().residentBytes;
+
+    lang.setMemoryBudget(fullSize / 8);
+    ASSERT_EQ(lang.getMemoryBudget(), fullSize / 8);
+
+    auto stats = lang.getStats();
+    ASSERT_LE(stats.residentBytes, fullSize / 8);
+    ASSERT_GT(stats.evictedSections, 0);
+    ASSERT_EQ(stats.sections + stats.evictedSections, SECTIONS);
+    ASSERT_EQ(stats.keys, reference.getStats().keys); // key counts include evicted sections
+    ASSERT_EQ(lang.getSectionNames().size(), SECTIONS);
+
+    // every lookup returns exactly what the unbudgeted language returns
+    for (const auto& section : reference.getSectionNames()) {
+        for (const auto& field : { "title", "text", "ref", "missing" }) {
+            ASSERT_EQ(lang.getString(section, field), reference.getString(section, field)) << section << ":" << field;
+            ASSERT_EQ(lang.getString(section, field, false), reference.getString(section, field, false)) << section << ":" << field;
+        }
+        ASSERT_EQ(lang.getSection(section), reference.getSection(section));
+    }
+
+    ASSERT_LE(lang.getStats().residentBytes, fullSize / 8);
+    ASSERT_GT(lang.getMetrics().get(lang_metrics::counter_t::Evictions), 0);
+    ASSERT_GT(lang.getMetrics().get(lang_metrics::counter_t::Rematerialisations), 0);
+
+    // evicted sections are part of copies and packs
+    const auto copy = lang;
+    ASSERT_EQ(copy.getString(sectionName(0), "title"), TITLE_0);
+
+    const auto packPath = fs::temp_directory_path() / "borr_memory_budget_test.borrpack";
+    lang.toPackFile(packPath);
+    ASSERT_EQ(language::fromPackFile(fs::directory_entry(packPath)).getStats().keys, reference.getStats().keys);
+    fs::remove(packPath);
+
+    // removing the budget brings back every section
+    lang.setMemoryBudget(0);
+    stats = lang.getStats();
+    ASSERT_EQ(stats.evictedSections, 0);
+    ASSERT_EQ(stats.keys, reference.getStats().keys);
+}
+
+TEST(MemoryBudgetTests, testPinnedSections) {
+    auto lang = language::fromString(generateSource(32));
+    lang.pinSection(sectionName(0));
+    ASSERT_TRUE(lang.isSectionPinned(sectionName(0)));
+
+    // a budget of one byte evicts everything which may be evicted
+    lang.setMemoryBudget(1);
+    auto stats = lang.getStats();
+    ASSERT_EQ(stats.sections, 1);
+    ASSERT_EQ(stats.evictedSections, 31);
+
+    const auto evictions = lang.getMetrics().get(lang_metrics::counter_t::Evictions);
+    ASSERT_EQ(lang.getString(sectionName(0), "title"), TITLE_0);
+    ASSERT_EQ(lang.getMetrics().get(lang_metrics::counter_t::Evictions), evictions);
+
+    // pins and the budget survive reloads
+    language::fromString(generateSource(32), lang);
+    ASSERT_EQ(lang.getStats().sections, 1);
+    ASSERT_EQ(lang.getString(sectionName(1), "ref"), "See " + TITLE_0);
+
+    lang.unpinSection(sectionName(0));
+    ASSERT_FALSE(lang.isSectionPinned(sectionName(0)));
+    ASSERT_EQ(lang.getStats().sections, 0);
+}
+
+TEST(MemoryBudgetTests, testConcurrentReaders) {
+    constexpr size_t SECTIONS = 32;
+    constexpr size_t THREADS = 4;
+    const auto source = generateSource(SECTIONS);
+    const auto reference = language::fromString(source);
+
+    auto lang = language::fromString(source);
+    lang.setMemoryBudget(lang.getStats().residentBytes / 4);
+
+    vector<std::thread> readers{};
+    vector<size_t> mismatches(THREADS, 0);
+    for (size_t i = 0; i < THREADS; i++) {
+        readers.emplace_back([&, i] {
+            for (size_t j = 0; j < 500; j++) {
+                const auto section = sectionName((j * 7 + i * 13) % SECTIONS);
+                if (lang.getString(section, "ref") != reference.getString(section, "ref")) { mismatches[i]++; }
+            }
+        });
+    }
+    for (auto& reader : readers) { reader.join(); }
+
+    ASSERT_EQ(mismatches, vector<size_t>(THREADS, 0));
+}
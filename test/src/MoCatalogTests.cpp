@@ -0,0 +1,149 @@
+/**
+ * @file MoCatalogTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for memory-mapped gettext catalogs.
+ * @version 0.1
+ * @date 2023-02-14
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/language.hpp"
+#include "borr/mo_catalog.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::mo_catalog;
+using borr::moentry_t;
+
+namespace fs = std::filesystem;
+
+class MoCatalogTests: public testing::Test {
+    protected:
+        void SetUp() override {
+            m_moPath = fs::temp_directory_path() / "borr_mo_catalog_test.mo";
+
+            mo_catalog::writeFile(m_moPath, {
+                { "", "", "Project-Id-Version: borr tests 1.0\nLanguage: de_DE\nContent-Type: text/plain; charset=UTF-8\n" },
+                { "", "Hello", "Hallo" },
+                { "", "Goodbye", "Auf Wiedersehen" },
+                { "menu", "Open", "Öffnen" },
+                { "menu", "Close", "Schließen" },
+                { "door", "Open", "Offen" },
+                { "", string("One file\0%d files", 17), string("Eine Datei\0%d Dateien", 21) },
+            });
+        }
+
+        void TearDown() override { fs::remove(m_moPath); }
+
+        vector<char> readFile() const {
+            std::ifstream inStream(m_moPath, std::ios::binary);
+            return vector<char>(std::istreambuf_iterator<char>(inStream), std::istreambuf_iterator<char>());
+        }
+
+        void writeFile(const vector<char>& contents) const {
+            std::ofstream outStream(m_moPath, std::ios::binary | std::ios::trunc);
+            outStream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+
+        fs::path m_moPath{};
+};
+
+TEST_F(MoCatalogTests, testHashMatchesGettext) {
+    // values computed with hash_string() from GNU gettext
+    ASSERT_EQ(mo_catalog::hashString("", ""), 0);
+    ASSERT_EQ(mo_catalog::hashString("", "a"), 0x61);
+    ASSERT_EQ(mo_catalog::hashString("", "Hello"), 0x4ec32f);
+    ASSERT_EQ(mo_catalog::hashString("", "A very long string which will overflow the hash"), 0xeaa67d8);
+}
+
+TEST_F(MoCatalogTests, testLookup) {
+    const auto catalog = mo_catalog::fromFile(m_moPath);
+    ASSERT_TRUE(catalog->hasHashTable());
+    ASSERT_EQ(catalog->size(), 7);
+
+    std::string_view translation{};
+    ASSERT_TRUE(catalog->find("", "Hello", translation));
+    ASSERT_EQ(translation, "Hallo");
+    ASSERT_TRUE(catalog->find("menu", "Open", translation));
+    ASSERT_EQ(translation, "Öffnen");
+    ASSERT_TRUE(catalog->find("door", "Open", translation));
+    ASSERT_EQ(translation, "Offen");
+    ASSERT_FALSE(catalog->find("", "Open", translation));
+    ASSERT_FALSE(catalog->find("menu", "Hello", translation));
+
+    ASSERT_EQ(catalog->getHeaderField("Language"), "de_DE");
+    ASSERT_EQ(catalog->getHeaderField("Missing-Field"), "");
+}
+
+TEST_F(MoCatalogTests, testLanguageLookupApi) {
+    const auto lang = borr::language::fromMoFile(fs::directory_entry(m_moPath));
+
+    ASSERT_EQ(lang.getLangId(), "de_DE");
+    ASSERT_EQ(lang.getLangDescription(), "borr tests 1.0");
+
+    ASSERT_EQ(lang.getString("", "Hello"), "Hallo");
+    ASSERT_EQ(lang.getString("menu", "Close"), "Schließen");
+    ASSERT_EQ(lang.getString("", "One file"), "Eine Datei");
+    ASSERT_FALSE(lang.getString("menu", "Save").has_value());
+    ASSERT_FALSE(lang.getString("", "").has_value());
+
+    const auto section = lang.getSection("menu");
+    ASSERT_TRUE(section.has_value());
+    ASSERT_EQ(section->size(), 2);
+    ASSERT_EQ(section->at("Open"), "Öffnen");
+
+    ASSERT_FALSE(lang.getSection("does_not_exist").has_value());
+}
+
+TEST_F(MoCatalogTests, testSwappedByteOrderAndNoHashTable) {
+    auto contents = readFile();
+
+    // swap all header and table words, then remove the hash table
+    uint32_t stringsStart = 0;
+    std::memcpy(&stringsStart, contents.data() + 24, sizeof(stringsStart)); // hash table offset
+    uint32_t hashSize = 0;
+    std::memcpy(&hashSize, contents.data() + 20, sizeof(hashSize));
+    stringsStart += hashSize * 4;
+
+    for (size_t offset = 0; offset + 4 <= stringsStart; offset += 4) {
+        std::swap(contents[offset], contents[offset + 3]);
+        std::swap(contents[offset + 1], contents[offset + 2]);
+    }
+    std::memset(contents.data() + 20, 0, 4);
+    writeFile(contents);
+
+    const auto catalog = mo_catalog::fromFile(m_moPath);
+    ASSERT_FALSE(catalog->hasHashTable());
+
+    std::string_view translation{};
+    ASSERT_TRUE(catalog->find("menu", "Close", translation));
+    ASSERT_EQ(translation, "Schließen");
+    ASSERT_TRUE(catalog->find("", "Goodbye", translation));
+    ASSERT_EQ(translation, "Auf Wiedersehen");
+    ASSERT_FALSE(catalog->find("", "Nope", translation));
+}
+
+TEST_F(MoCatalogTests, testInvalidFiles) {
+    auto contents = readFile();
+
+    writeFile({ 'n', 'o', 'p', 'e' });
+    ASSERT_THROW(mo_catalog::fromFile(m_moPath), std::runtime_error);
+
+    // string count far larger than the file
+    std::memset(contents.data() + 8, 0xff, 4);
+    writeFile(contents);
+    ASSERT_THROW(mo_catalog::fromFile(m_moPath), std::runtime_error);
+
+    ASSERT_THROW(mo_catalog::fromFile(m_moPath.string() + ".missing"), fs::filesystem_error);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file OpenMetricsTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the metrics kept by languages and their OpenMetrics exposition.
+ * @version 0.1
+ * @date 2023-02-19
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/language.hpp"
+#include "borr/openmetrics.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::lang_metrics;
+using borr::language;
+
+namespace {
+
+    const string SOURCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[test]
+app_name = "libborr"
+title = "Welcome to ${test:app_name}"
+)";
+
+    bool containsLine(const string& exposition, const string& line) {
+        return exposition.find(line + "\n") != string::npos;
+    }
+
+}
+
+TEST(OpenMetricsTests, testCounters) {
+    auto lang = language::fromString(SOURCE);
+    using counter_t = lang_metrics::counter_t;
+
+    ASSERT_EQ(lang.getString("test", "title"), "Welcome to libborr");
+    ASSERT_EQ(lang.getString("test", "app_name"), "libborr");
+    ASSERT_FALSE(lang.getString("test", "missing").has_value());
+
+    const auto& metrics = lang.getMetrics();
+    ASSERT_EQ(metrics.get(counter_t::Lookups), 3);
+    ASSERT_EQ(metrics.get(counter_t::Misses), 1);
+    ASSERT_EQ(metrics.get(counter_t::Expansions), 1);
+    ASSERT_EQ(metrics.get(counter_t::Loads), 1);
+    ASSERT_EQ(metrics.get(counter_t::HotLookups), 0);
+
+    // reloads accumulate
+    language::fromString(SOURCE, lang);
+    ASSERT_EQ(lang.getMetrics().get(counter_t::Loads), 2);
+    ASSERT_EQ(lang.getMetrics().get(counter_t::Lookups), 3);
+
+    const auto copy = lang;
+    ASSERT_EQ(copy.getMetrics().get(counter_t::Loads), 2);
+}
+
+TEST(OpenMetricsTests, testExposition) {
+    auto lang = language::fromString(SOURCE);
+    lang.getString("test", "title");
+    lang.getString("test", "missing");
+
+    const auto exposition = borr::openmetrics::format({ &lang });
+
+    ASSERT_TRUE(containsLine(exposition, "# TYPE borr_keys gauge"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_keys{lang="en_GB"} 2)"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_sections{lang="en_GB"} 1)"));
+    ASSERT_TRUE(containsLine(exposition, "# TYPE borr_lookups counter"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_lookups_total{lang="en_GB"} 2)"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_lookup_misses_total{lang="en_GB"} 1)"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_expansions_total{lang="en_GB"} 1)"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_loads_total{lang="en_GB"} 1)"));
+    ASSERT_TRUE(containsLine(exposition, R"(borr_hot_index_hit_ratio{lang="en_GB"} NaN)"));
+    ASSERT_TRUE(containsLine(exposition, "# UNIT borr_resident_bytes bytes"));
+
+    ASSERT_EQ(exposition.substr(exposition.size() - 6), "# EOF\n");
+
+    ASSERT_EQ(borr::openmetrics::escapeLabelValue("a\"b\\c\nd"), R"(a\"b\\c\nd)");
+}
+
+TEST(OpenMetricsTests, testScrapeWhileReading) {
+    const auto lang = language::fromString(SOURCE);
+    constexpr size_t THREADS = 4;
+    constexpr size_t LOOKUPS = 2000;
+
+    vector<std::thread> readers{};
+    for (size_t i = 0; i < THREADS; i++) {
+        readers.emplace_back([&] {
+            for (size_t j = 0; j < LOOKUPS; j++) { lang.getString("test", "app_name"); }
+        });
+    }
+
+    for (size_t i = 0; i < 10; i++) { ASSERT_FALSE(borr::openmetrics::format({ &lang }).empty()); }
+    for (auto& reader : readers) { reader.join(); }
+
+    ASSERT_EQ(lang.getMetrics().get(lang_metrics::counter_t::Lookups), THREADS * LOOKUPS);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file RenderProfilerTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the sampling render profiler.
+ * @version 0.1
+ * @date 2023-03-02
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/language.hpp"
+#include "borr/render_profiler.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::language;
+using borr::render_profiler;
+
+using spankind_t = render_profiler::spankind_t;
+
+namespace {
+
+    const string SOURCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[test]
+app_name = "libborr"
+middle = "${test:app_name} by ${profilerSlowExpander}"
+title = "Welcome to ${test:middle}"
+plain = "Nothing to expand"
+)";
+
+    const render_profiler::slowspan_t* findSpan(const vector<render_profiler::slowspan_t>& spans, const string& field, const string& variable) {
+        for (const auto& span : spans) {
+            if (span.field == field && span.variable == variable) { return &span; }
+        }
+
+        return nullptr;
+    }
+
+}
+
+TEST(RenderProfilerTests, testBreakdown) {
+    ASSERT_NO_THROW(language::addVarExpansionCallback("profilerSlowExpander", [](const string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return "a slow callback";
+    }));
+
+    auto lang = language::fromString(SOURCE);
+    const auto profiler = std::make_shared<render_profiler>(1);
+    lang.setRenderProfiler(profiler);
+
+    ASSERT_EQ(lang.getString("test", "title"), "Welcome to libborr by a slow callback");
+    ASSERT_EQ(lang.getString("test", "title", false), "Welcome to ${test:middle}");
+    ASSERT_EQ(profiler->getSampledRenders(), 1);
+
+    const auto spans = profiler->getSlowest();
+    const auto render = findSpan(spans, "title", "");
+    const auto reference = findSpan(spans, "title", "test:middle");
+    const auto callback = findSpan(spans, "title", "profilerSlowExpander");
+    const auto nested = findSpan(spans, "title", "test:app_name");
+
+    ASSERT_NE(render, nullptr);
+    ASSERT_NE(reference, nullptr);
+    ASSERT_NE(callback, nullptr);
+    ASSERT_NE(nested, nullptr);
+
+    // the nested callback is attributed to the translation which was requested, one level down
+    ASSERT_EQ(render->kind, spankind_t::Render);
+    ASSERT_EQ(reference->kind, spankind_t::Reference);
+    ASSERT_EQ(reference->depth, 0);
+    ASSERT_EQ(callback->kind, spankind_t::Expander);
+    ASSERT_EQ(callback->depth, 1);
+    ASSERT_GE(callback->slowest, std::chrono::milliseconds(2));
+    ASSERT_GE(reference->slowest, callback->slowest);
+    ASSERT_GE(render->slowest, reference->slowest);
+    ASSERT_LE(render->lookup, render->slowest);
+
+    // slowest first
+    ASSERT_EQ(spans.front().kind, spankind_t::Render);
+
+    std::ostringstream report{};
+    profiler->write(report);
+    ASSERT_NE(report.str().find("\texpander\t1\ttest\ttitle\tprofilerSlowExpander\n"), string::npos);
+
+    language::removeVarExpansionCallback("profilerSlowExpander");
+}
+
+TEST(RenderProfilerTests, testSamplingAndCapacity) {
+    auto lang = language::fromString(SOURCE);
+    const auto profiler = std::make_shared<render_profiler>(5, 2);
+    lang.setRenderProfiler(profiler);
+
+    for (size_t i = 0; i < 10; i++) { lang.getString("test", "plain"); }
+    ASSERT_EQ(profiler->getSampledRenders(), 2);
+    ASSERT_EQ(profiler->getSlowest().size(), 1);
+    ASSERT_EQ(profiler->getSlowest().front().samples, 2);
+
+    // at most two keys are kept, and a key only replaces a faster one
+    profiler->add({ "test", "slow", {}, spankind_t::Render, std::chrono::seconds(1) });
+    profiler->add({ "test", "fast", {}, spankind_t::Render, std::chrono::nanoseconds(0) });
+    profiler->add({ "test", "slower", {}, spankind_t::Render, std::chrono::seconds(2) });
+
+    const auto spans = profiler->getSlowest();
+    ASSERT_EQ(spans.size(), 2);
+    ASSERT_EQ(spans[0].field, "slower");
+    ASSERT_EQ(spans[1].field, "slow");
+
+    profiler->clear();
+    ASSERT_TRUE(profiler->getSlowest().empty());
+    ASSERT_EQ(profiler->getSampledRenders(), 0);
+
+    lang.setRenderProfiler(nullptr);
+    for (size_t i = 0; i < 10; i++) { lang.getString("test", "title"); }
+    ASSERT_TRUE(profiler->getSlowest().empty());
+
+    // every profiler samples its own renders, even when several are used alternately
+    render_profiler first(2);
+    render_profiler second(2);
+    size_t firstSamples = 0;
+    for (size_t i = 0; i < 10; i++) {
+        if (first.shouldSample()) { firstSamples++; }
+        second.shouldSample();
+    }
+    ASSERT_EQ(firstSamples, 5);
+}
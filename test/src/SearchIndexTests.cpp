@@ -0,0 +1,140 @@
+/**
+ * @file SearchIndexTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for the full-text search index.
+ * @version 0.1
+ * @date 2023-03-04
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/catalog.hpp"
+#include "borr/language.hpp"
+#include "borr/search_index.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::catalog;
+using borr::language;
+using borr::indexopts_t;
+using borr::search_index;
+
+namespace {
+
+    const string EN_SOURCE = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[errors]
+save_failed = "The file could not be saved!"
+load_failed = "The file could not be loaded."
+disk_full = "Saving failed: the disk is full"
+
+[start_page]
+welcome = "Welcome to ${start_page:app}"
+app = "libborr"
+)";
+
+    const string DE_SOURCE = R"(
+lang_id = "de_DE"
+lang_ver = "1.0.0"
+lang_desc = "Deutsch"
+
+[errors]
+save_failed = "Die Datei konnte nicht gespeichert werden!"
+disk_full = "Speichern fehlgeschlagen: Die Festplatte ist voll"
+)";
+
+    /**
+     * @brief Formats hits as lang_id:section:field, in order.
+     */
+    vector<string> getKeys(const vector<search_index::searchhit_t>& hits) {
+        vector<string> keys{};
+        for (const auto& hit : hits) { keys.push_back(string(hit.langId) + ":" + string(hit.section) + ":" + string(hit.field)); }
+
+        return keys;
+    }
+
+}
+
+TEST(SearchIndexTests, testSubstring) {
+    const auto en = language::fromString(EN_SOURCE);
+    const auto de = language::fromString(DE_SOURCE);
+
+    // one chunk per translation, so the postings of several chunks are merged
+    indexopts_t options{};
+    options.threads = 3;
+    options.chunkSize = 1;
+
+    const auto index = search_index::fromLanguages({ &en, nullptr, &de }, options);
+    ASSERT_EQ(index.getDocumentCount(), 7);
+    ASSERT_GT(index.getTrigramCount(), 0);
+    ASSERT_GT(index.getPostingBytes(), 0);
+    ASSERT_GT(index.getMemoryUsage(), index.getPostingBytes());
+
+    // case-insensitive, ordered by language, section and field
+    ASSERT_EQ(getKeys(index.findSubstring("FILE COULD")), vector<string>({ "en_GB:errors:load_failed", "en_GB:errors:save_failed" }));
+    ASSERT_EQ(getKeys(index.findSubstring("die ")), vector<string>({ "de_DE:errors:disk_full", "de_DE:errors:save_failed" }));
+    ASSERT_EQ(getKeys(index.findSubstring("${start_page")), vector<string>({ "en_GB:start_page:welcome" }));
+
+    // candidates containing all trigrams are verified
+    ASSERT_TRUE(index.findSubstring("saved!!").empty());
+    ASSERT_TRUE(index.findSubstring("the file is full").empty());
+    ASSERT_TRUE(index.findSubstring("xyz").empty());
+    ASSERT_TRUE(index.findSubstring("").empty());
+
+    // needles without trigrams scan all values; maxHits limits the result
+    ASSERT_EQ(index.findSubstring("!").size(), 2);
+    ASSERT_EQ(index.findSubstring("e", 3).size(), 3);
+    ASSERT_EQ(index.findSubstring("e", 0).size(), 6);
+
+    const auto hit = index.findSubstring("voll").at(0);
+    ASSERT_EQ(hit.value, "Speichern fehlgeschlagen: Die Festplatte ist voll");
+}
+
+TEST(SearchIndexTests, testWords) {
+    const auto en = language::fromString(EN_SOURCE);
+    const auto index = search_index::fromLanguages({ &en });
+
+    ASSERT_EQ(getKeys(index.findWords("file the")), vector<string>({ "en_GB:errors:load_failed", "en_GB:errors:save_failed" }));
+    ASSERT_EQ(getKeys(index.findWords("Saved")), vector<string>({ "en_GB:errors:save_failed" }));
+    ASSERT_EQ(getKeys(index.findWords("saving, FULL")), vector<string>({ "en_GB:errors:disk_full" }));
+
+    // words must match entirely
+    ASSERT_TRUE(index.findWords("save").empty());
+    ASSERT_TRUE(index.findWords("fil").empty());
+    ASSERT_EQ(getKeys(index.findWords("is")), vector<string>({ "en_GB:errors:disk_full" }));
+    ASSERT_TRUE(index.findWords(" ,!").empty());
+}
+
+TEST(SearchIndexTests, testCatalog) {
+    catalog translations{};
+    translations.addLanguage(language::fromString(EN_SOURCE));
+
+    const auto first = translations.getSearchIndex();
+    ASSERT_EQ(first->getDocumentCount(), 5);
+    ASSERT_EQ(translations.getSearchIndex(), first);
+
+    // adding a language rebuilds the index on the next call; the previous index stays valid while it's held
+    translations.addLanguage(language::fromString(DE_SOURCE));
+    const auto second = translations.getSearchIndex();
+    ASSERT_EQ(second->getDocumentCount(), 7);
+    ASSERT_EQ(getKeys(second->findWords("datei")), vector<string>({ "de_DE:errors:save_failed" }));
+    ASSERT_EQ(first->getDocumentCount(), 5);
+
+    translations.removeLanguage("de-de");
+    ASSERT_EQ(translations.getSearchIndex()->getDocumentCount(), 5);
+
+    // replacing a language rebuilds the index as well
+    auto changed = EN_SOURCE;
+    changed.replace(changed.find("libborr"), 7, "borrdemo");
+    translations.addLanguage(language::fromString(changed));
+    ASSERT_EQ(getKeys(translations.getSearchIndex()->findWords("borrdemo")), vector<string>({ "en_GB:start_page:app" }));
+}
@@ -0,0 +1,149 @@
+/**
+ * @file StableKeyTests.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains unit tests for stable key IDs and key handles.
+ * @version 0.1
+ * @date 2023-02-28
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "borr/extensions.hpp"
+#include "borr/key_index.hpp"
+#include "borr/language.hpp"
+
+using std::string;
+using std::vector;
+
+using borr::key_handle;
+using borr::key_index;
+using borr::lang_metrics;
+using borr::language;
+
+namespace {
+
+    const string VERSION_1 = R"(
+lang_id = "en_GB"
+lang_ver = "1.0.0"
+lang_desc = "British English"
+
+[test]
+app_name = "libborr"
+title = "Welcome to ${test:app_name}"
+removed = "Only in the first version"
+)";
+
+    const string VERSION_2 = R"(
+lang_id = "en_GB"
+lang_ver = "1.1.0"
+lang_desc = "British English"
+
+[added]
+greeting = "Hello"
+
+[test]
+app_name = "libborr 2"
+title = "Welcome back to ${test:app_name}"
+)";
+
+}
+
+TEST(StableKeyTests, testStableKey) {
+    // the stable key is the FNV-1a hash of "section:field", so it can be computed anywhere
+    ASSERT_EQ(language::getStableKey("test", "title"), borr::extensions::fnv1a("test:title"));
+    ASSERT_NE(language::getStableKey("test", "title"), language::getStableKey("test", "app_name"));
+    ASSERT_NE(language::getStableKey("ab", "cd"), language::getStableKey("abc", "d"));
+
+    const auto lang = language::fromString(VERSION_1);
+    ASSERT_EQ(lang.getString(language::getStableKey("test", "title")), "Welcome to libborr");
+    ASSERT_EQ(lang.getString(language::getStableKey("test", "title"), false), "Welcome to ${test:app_name}");
+    ASSERT_FALSE(lang.getString(language::getStableKey("test", "missing")).has_value());
+    ASSERT_FALSE(lang.getString(key_index::INVALID_KEY).has_value());
+}
+
+TEST(StableKeyTests, testHandlesSurviveReload) {
+    auto lang = language::fromString(VERSION_1);
+
+    key_handle title("test", "title");
+    key_handle removed("test", "removed");
+    key_handle added("added", "greeting");
+    const auto titleKey = title.getKey();
+
+    ASSERT_EQ(lang.getString(title), "Welcome to libborr");
+    ASSERT_EQ(lang.getString(removed), "Only in the first version");
+    ASSERT_FALSE(lang.getString(added).has_value());
+    ASSERT_FALSE(lang.getString(added).has_value());
+
+    const auto generation = lang.getGeneration();
+    language::fromString(VERSION_2, lang);
+    ASSERT_NE(lang.getGeneration(), generation);
+
+    // the same handles and IDs resolve against the new version
+    ASSERT_EQ(lang.getString(title), "Welcome back to libborr 2");
+    ASSERT_EQ(lang.getString(titleKey), "Welcome back to libborr 2");
+    ASSERT_FALSE(lang.getString(removed).has_value());
+    ASSERT_EQ(lang.getString(added), "Hello");
+    ASSERT_EQ(title.getKey(), titleKey);
+
+    // a copy has different entries, so handles are resolved again
+    const auto copy = lang;
+    ASSERT_NE(copy.getGeneration(), lang.getGeneration());
+    ASSERT_EQ(copy.getString(title), "Welcome back to libborr 2");
+    ASSERT_EQ(lang.getString(title), "Welcome back to libborr 2");
+
+    // cached misses are still counted as misses
+    ASSERT_EQ(lang.getMetrics().get(lang_metrics::counter_t::Misses), 3);
+}
+
+TEST(StableKeyTests, testHandlesUnderMemoryBudget) {
+    constexpr size_t SECTIONS = 32;
+
+    string source = "lang_id = \"en_GB\"\nlang_ver = \"1.0.0\"\nlang_desc = \"British English\"\n";
+    vector<string> sections{};
+    for (size_t i = 0; i < SECTIONS; i++) {
+        sections.push_back(string("section_") + static_cast<char>('a' + i % 26) + static_cast<char>('a' + i / 26));
+        source += "[" + sections.back() + "]\n";
+        source += "title = \"Title number " + std::to_string(i) + " with a value too long for small strings\"\n";
+    }
+
+    auto lang = language::fromString(source);
+    vector<key_handle> handles{};
+    for (const auto& section : sections) {
+        handles.emplace_back(section, "title");
+        ASSERT_TRUE(lang.getString(handles.back()).has_value());
+    }
+
+    // enabling the budget starts a new generation, as cached entries may now be evicted
+    const auto generation = lang.getGeneration();
+    lang.setMemoryBudget(lang.getStats().residentBytes / 8);
+    ASSERT_NE(lang.getGeneration(), generation);
+
+    for (size_t round = 0; round < 2; round++) {
+        for (size_t i = 0; i < SECTIONS; i++) {
+            ASSERT_EQ(lang.getString(handles[i]), "Title number " + std::to_string(i) + " with a value too long for small strings");
+        }
+    }
+    ASSERT_GT(lang.getMetrics().get(lang_metrics::counter_t::Evictions), 0);
+}
+
+TEST(StableKeyTests, testCollisions) {
+    key_index index{};
+    index.add("test", "title", nullptr);
+    index.add("test", "app_name", nullptr);
+    index.add("test", "title", nullptr);
+    index.finalise();
+
+    key_index::keyref_t ref{};
+    ASSERT_EQ(index.size(), 3);
+    ASSERT_EQ(index.getCollisionCount(), 2);
+    ASSERT_FALSE(index.find(key_index::getStableKey("test", "title"), ref));
+
+    ASSERT_TRUE(index.find(key_index::getStableKey("test", "app_name"), ref));
+    ASSERT_EQ(ref.section, "test");
+    ASSERT_EQ(ref.field, "app_name");
+}
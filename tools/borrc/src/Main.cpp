@@ -0,0 +1,359 @@
+/**
+ * @file Main.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains borrc; the compiler turning trees of borrfiles into language packs.
+ * @version 0.1
+ * @date 2023-02-17
+ *
+ * borrc compiles every borrfile it is given (or finds in the directories it is given) into a language pack,
+ * which can be loaded with language::fromPackFile().
+ * Files are compiled in parallel; files whose content hash matches the hash stored in their existing pack are skipped.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors
+ */
+
+#include <borr/lang_pack.hpp>
+#include <borr/language.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::exception;
+using std::string;
+using std::vector;
+
+using borr::lang_pack;
+using borr::language;
+
+namespace fs = std::filesystem;
+
+using clock_type = std::chrono::steady_clock;
+
+const string SHORT_OPTS = R"(hd:fj:o:qs:)";
+const option LONG_OPTS[] = {
+    { "help",       no_argument,        nullptr,    'h' },
+    { "depfile",    required_argument,  nullptr,    'd' },
+    { "force",      no_argument,        nullptr,    'f' },
+    { "jobs",       required_argument,  nullptr,    'j' },
+    { "output",     required_argument,  nullptr,    'o' },
+    { "quiet",      no_argument,        nullptr,    'q' },
+    { "stamp",      required_argument,  nullptr,    's' },
+    { nullptr,      no_argument,        nullptr,     0  }
+};
+
+const vector<string> SOURCE_EXTENSIONS = { ".borr", ".lang" };
+
+/**
+ * @brief The outcome of compiling a single borrfile.
+ */
+enum class jobstatus_t {
+    Compiled,
+    UpToDate,
+    Failed
+};
+
+/**
+ * @brief A single borrfile to compile.
+ */
+struct job_t {
+    fs::path    input{}; //!< The borrfile
+    fs::path    output{}; //!< The language pack
+    jobstatus_t status{jobstatus_t::Failed}; //!< The outcome
+    double      milliseconds{0}; //!< The time it took to hash (and compile) the file
+    string      error{}; //!< The error message, if compilation failed
+};
+
+void    printHelp(const string&);
+bool    collectJobs(const vector<string>& inputs, const fs::path& outputDir, vector<job_t>& outJobs);
+void    runJob(job_t& job, bool force);
+void    printTimings(const vector<job_t>& jobs);
+bool    writeDepfile(const fs::path& depfile, const fs::path& stamp, const vector<job_t>& jobs);
+string  escapeDepPath(const fs::path& path);
+
+int main(int32_t argc, char** argv) {
+    int32_t currentOpt = 0;
+
+    fs::path outputDir{};
+    fs::path depfile{};
+    fs::path stamp{};
+    bool force = false;
+    bool quiet = false;
+    size_t jobCount = std::max(1u, std::thread::hardware_concurrency());
+
+    while ((currentOpt = getopt_long(argc, argv, SHORT_OPTS.c_str(), LONG_OPTS, nullptr)) != -1) {
+        switch (currentOpt) {
+            case 'h':
+                printHelp(argv[0]);
+                return 0;
+            case 'd':
+                depfile = optarg;
+                break;
+            case 'f':
+                force = true;
+                break;
+            case 'j':
+                try {
+                    jobCount = std::max<size_t>(1, std::stoul(optarg));
+                } catch (const exception&) {
+                    cerr << "Invalid job count " << optarg << endl;
+                    return 1;
+                }
+                break;
+            case 'o':
+                outputDir = optarg;
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            case 's':
+                stamp = optarg;
+                break;
+            default:
+                printHelp(argv[0]);
+                return 1;
+        }
+    }
+
+    if (outputDir.empty() || optind >= argc) {
+        cerr << "No output directory or no borrfiles passed!" << endl;
+        printHelp(argv[0]);
+        return 1;
+    }
+
+    vector<job_t> jobs{};
+    if (!collectJobs(vector<string>(argv + optind, argv + argc), outputDir, jobs)) { return 1; }
+
+    const auto startTime = clock_type::now();
+
+    // every worker takes the next job until none are left, so large files don't hold up a fixed partition
+    std::atomic<size_t> nextJob{0};
+    const auto worker = [&] {
+        for (auto index = nextJob++; index < jobs.size(); index = nextJob++) {
+            runJob(jobs[index], force);
+        }
+    };
+
+    jobCount = std::min(jobCount, std::max<size_t>(1, jobs.size()));
+    vector<std::thread> workers{};
+    for (size_t i = 1; i < jobCount; i++) { workers.emplace_back(worker); }
+    worker();
+    for (auto& thread : workers) { thread.join(); }
+
+    const auto totalTime = std::chrono::duration<double, std::milli>(clock_type::now() - startTime).count();
+
+    if (!quiet) { printTimings(jobs); }
+
+    size_t compiled = 0;
+    size_t upToDate = 0;
+    size_t failed = 0;
+    for (const auto& job : jobs) {
+        switch (job.status) {
+            case jobstatus_t::Compiled: compiled++; break;
+            case jobstatus_t::UpToDate: upToDate++; break;
+            case jobstatus_t::Failed:
+                failed++;
+                cerr << "error: " << job.input.string() << ": " << job.error << endl;
+                break;
+        }
+    }
+
+    cout << compiled << " compiled, " << upToDate << " up to date, " << failed << " failed in "
+         << std::fixed << std::setprecision(2) << totalTime << " ms (" << jobCount << " jobs)" << endl;
+
+    if (failed != 0) { return 1; }
+
+    if (!depfile.empty() && !writeDepfile(depfile, stamp, jobs)) { return 1; }
+
+    if (!stamp.empty()) {
+        std::ofstream stampStream(stamp, std::ios::trunc);
+        if (!stampStream.is_open()) {
+            cerr << "Failed to write stamp file " << stamp.string() << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void printHelp(const string& bin) {
+    cout << "Usage: " << bin << " -h" << endl
+         << "Usage: " << bin << " -o<outdir> [-j<jobs>] [-f] [-q] [-d<depfile> [-s<stamp>]] <borrfile|directory>..." << endl << endl
+         << "Compiles borrfiles into language packs (" << lang_pack::FILE_EXTENSION << "), which can be loaded with language::fromPackFile()." << endl
+         << "Directories are searched recursively for *.borr and *.lang files; their structure is mirrored in the output directory." << endl << endl
+         << "Arguments:" << endl
+         << "\t--help, -h\t\tDisplays this menu and exits" << endl
+         << "\t--output, -o<dir>\tWrite language packs to dir" << endl
+         << "\t--jobs, -j<jobs>\tCompile up to jobs files in parallel (default: number of CPUs)" << endl
+         << "\t--force, -f\t\tCompile all files, even if their contents haven't changed" << endl
+         << "\t--quiet, -q\t\tDon't print per-file timings" << endl
+         << "\t--depfile, -d<file>\tWrite a Makefile-style depfile for CMake/Ninja" << endl
+         << "\t--stamp, -s<file>\tTouch file on success; the depfile then lists it as the only target" << endl;
+}
+
+/**
+ * @brief Collects all borrfiles to compile and determines their output paths.
+ *
+ * @return true If all inputs exist and no two inputs compile to the same pack.
+ */
+bool collectJobs(const vector<string>& inputs, const fs::path& outputDir, vector<job_t>& outJobs) {
+    const auto isSource = [](const fs::path& path) {
+        return std::find(SOURCE_EXTENSIONS.begin(), SOURCE_EXTENSIONS.end(), path.extension().string()) != SOURCE_EXTENSIONS.end();
+    };
+    const auto addJob = [&](const fs::path& input, const fs::path& relative) {
+        auto output = outputDir / relative;
+        output.replace_extension(lang_pack::FILE_EXTENSION);
+        outJobs.push_back({ input, output });
+    };
+
+    for (const auto& input : inputs) {
+        const fs::path inputPath(input);
+        std::error_code error{};
+
+        if (fs::is_directory(inputPath, error)) {
+            vector<fs::path> sources{};
+            for (const auto& entry : fs::recursive_directory_iterator(inputPath)) {
+                if (entry.is_regular_file() && isSource(entry.path())) { sources.push_back(entry.path()); }
+            }
+
+            // keep the output (and the depfile) independent of directory iteration order
+            std::sort(sources.begin(), sources.end());
+            for (const auto& source : sources) { addJob(source, source.lexically_relative(inputPath)); }
+        } else if (fs::is_regular_file(inputPath, error)) {
+            addJob(inputPath, inputPath.filename());
+        } else {
+            cerr << "No such file or directory: " << input << endl;
+            return false;
+        }
+    }
+
+    // e.g. a/en.borr and b/en.lang would both be compiled to en.borrpack, losing one of them
+    std::map<fs::path, const job_t*> outputs{};
+    for (const auto& job : outJobs) {
+        const auto [existing, inserted] = outputs.emplace(job.output.lexically_normal(), &job);
+        if (!inserted) {
+            cerr << "Multiple files compile to " << job.output << ": " << existing->second->input << " and " << job.input << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compiles a single borrfile, unless its pack is up to date.
+ *
+ * Packs are written to a temporary file first and renamed into place (see lang_pack::writeFile()),
+ * so an interrupted run never leaves a truncated pack which looks up to date.
+ * Up-to-date packs which are older than their borrfile are touched, so they satisfy the dependencies of a depfile.
+ */
+void runJob(job_t& job, bool force) {
+    const auto startTime = clock_type::now();
+
+    try {
+        std::ifstream inStream(job.input, std::ios::binary);
+        if (!inStream.is_open()) { throw std::runtime_error("Failed to open file!"); }
+
+        std::stringstream contents{};
+        contents << inStream.rdbuf();
+        const auto source = contents.str();
+        const auto sourceHash = lang_pack::hashContents(source);
+
+        if (!force && lang_pack::readSourceHash(job.output) == sourceHash) {
+            // a borrfile saved without changes is newer than its pack; without a touch, make would run borrc on every build
+            if (fs::last_write_time(job.output) < fs::last_write_time(job.input)) {
+                fs::last_write_time(job.output, fs::file_time_type::clock::now());
+            }
+
+            job.status = jobstatus_t::UpToDate;
+        } else {
+            language lang{};
+            language::fromString(source, lang);
+
+            fs::create_directories(job.output.parent_path());
+            lang.toPackFile(job.output, sourceHash);
+
+            job.status = jobstatus_t::Compiled;
+        }
+    } catch (const exception& ex) {
+        job.status = jobstatus_t::Failed;
+        job.error = ex.what();
+    }
+
+    job.milliseconds = std::chrono::duration<double, std::milli>(clock_type::now() - startTime).count();
+}
+
+/**
+ * @brief Prints the time each file took, slowest first.
+ */
+void printTimings(const vector<job_t>& jobs) {
+    vector<const job_t*> sorted{};
+    for (const auto& job : jobs) { sorted.push_back(&job); }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const job_t* a, const job_t* b) { return a->milliseconds > b->milliseconds; });
+
+    for (const auto job : sorted) {
+        const auto status = job->status == jobstatus_t::Compiled ? "compiled" :
+                            job->status == jobstatus_t::UpToDate ? "up to date" : "FAILED";
+
+        cout << std::setw(10) << std::fixed << std::setprecision(2) << job->milliseconds << " ms  "
+             << std::left << std::setw(10) << status << std::right << "  "
+             << job->input.string() << " -> " << job->output.string() << endl;
+    }
+}
+
+/**
+ * @brief Writes a Makefile-style depfile, as understood by CMake's add_custom_command(DEPFILE) and Ninja.
+ *
+ * Without a stamp file, every pack depends on its borrfile; runJob() keeps up-to-date packs newer than their borrfiles.
+ * With a stamp file, the stamp depends on all borrfiles, so newly added files are noticed as well.
+ */
+bool writeDepfile(const fs::path& depfile, const fs::path& stamp, const vector<job_t>& jobs) {
+    std::ofstream outStream(depfile, std::ios::trunc);
+    if (!outStream.is_open()) {
+        cerr << "Failed to write depfile " << depfile.string() << endl;
+        return false;
+    }
+
+    if (!stamp.empty()) {
+        outStream << escapeDepPath(stamp) << ":";
+        for (const auto& job : jobs) { outStream << " \\\n  " << escapeDepPath(job.input); }
+        outStream << endl;
+    } else {
+        for (const auto& job : jobs) {
+            outStream << escapeDepPath(job.output) << ": " << escapeDepPath(job.input) << endl;
+        }
+    }
+
+    return outStream.good();
+}
+
+/**
+ * @brief Escapes spaces, '#' and '$' in a path for use in a depfile.
+ */
+string escapeDepPath(const fs::path& path) {
+    string escaped{};
+    for (const auto c : path.generic_string()) {
+        if (c == ' ' || c == '#') {
+            escaped += '\\';
+        } else if (c == '$') {
+            escaped += '$';
+        }
+        escaped += c;
+    }
+
+    return escaped;
+}
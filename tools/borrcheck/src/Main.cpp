@@ -0,0 +1,178 @@
+/**
+ * @file Main.cpp
+ * @author Simon Cahill (contact@simonc.eu)
+ * @brief Contains borrcheck; the consistency checker comparing translations with a reference language.
+ * @version 0.1
+ * @date 2023-02-25
+ *
+ * borrcheck loads a reference language and any amount of translations (borrfiles or language packs) in parallel,
+ * and reports missing and extra keys, mismatched variables and differing line counts of multiline translations as JSON.
+ *
+ * @copyright Copyright (c) 2023 Simon Cahill and Contributors
+ */
+
+#include <borr/consistency.hpp>
+#include <borr/lang_pack.hpp>
+#include <borr/language.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::exception;
+using std::string;
+using std::vector;
+
+using borr::lang_pack;
+using borr::language;
+
+namespace fs = std::filesystem;
+
+const string SHORT_OPTS = R"(hj:o:q)";
+const option LONG_OPTS[] = {
+    { "help",       no_argument,        nullptr,    'h' },
+    { "jobs",       required_argument,  nullptr,    'j' },
+    { "output",     required_argument,  nullptr,    'o' },
+    { "quiet",      no_argument,        nullptr,    'q' },
+    { nullptr,      no_argument,        nullptr,     0  }
+};
+
+/**
+ * @brief A single language to load.
+ */
+struct input_t {
+    fs::path    path{}; //!< The borrfile or language pack
+    language    lang{}; //!< The loaded language
+    string      error{}; //!< The error message, if loading failed
+};
+
+void    printHelp(const string&);
+void    loadInput(input_t& input);
+
+int main(int32_t argc, char** argv) {
+    int32_t currentOpt = 0;
+
+    fs::path outputFile{};
+    bool quiet = false;
+    size_t jobCount = std::max(1u, std::thread::hardware_concurrency());
+
+    while ((currentOpt = getopt_long(argc, argv, SHORT_OPTS.c_str(), LONG_OPTS, nullptr)) != -1) {
+        switch (currentOpt) {
+            case 'h':
+                printHelp(argv[0]);
+                return 0;
+            case 'j':
+                try {
+                    jobCount = std::max<size_t>(1, std::stoul(optarg));
+                } catch (const exception&) {
+                    cerr << "Invalid job count " << optarg << endl;
+                    return 1;
+                }
+                break;
+            case 'o':
+                outputFile = optarg;
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                printHelp(argv[0]);
+                return 1;
+        }
+    }
+
+    if (argc - optind < 2) {
+        cerr << "A reference language and at least one translation must be passed!" << endl;
+        printHelp(argv[0]);
+        return 1;
+    }
+
+    // parsing borrfiles is by far the most expensive part, so languages are loaded in parallel as well
+    vector<input_t> inputs(static_cast<size_t>(argc - optind));
+    for (size_t i = 0; i < inputs.size(); i++) { inputs[i].path = argv[optind + static_cast<int32_t>(i)]; }
+
+    std::atomic<size_t> nextInput{0};
+    const auto worker = [&] {
+        for (auto index = nextInput++; index < inputs.size(); index = nextInput++) { loadInput(inputs[index]); }
+    };
+
+    vector<std::thread> workers{};
+    for (size_t i = 1; i < std::min(jobCount, inputs.size()); i++) { workers.emplace_back(worker); }
+    worker();
+    for (auto& thread : workers) { thread.join(); }
+
+    bool failed = false;
+    for (const auto& input : inputs) {
+        if (input.error.empty()) { continue; }
+
+        cerr << "error: " << input.path.string() << ": " << input.error << endl;
+        failed = true;
+    }
+    if (failed) { return 1; }
+
+    vector<const language*> translations{};
+    for (size_t i = 1; i < inputs.size(); i++) { translations.push_back(&inputs[i].lang); }
+
+    const auto& reference = inputs.front().lang;
+    const auto reports = borr::consistency::check(reference, translations, jobCount);
+
+    if (outputFile.empty()) {
+        borr::consistency::writeJson(cout, reference.getLangId(), reports);
+    } else {
+        std::ofstream outStream(outputFile, std::ios::trunc);
+        borr::consistency::writeJson(outStream, reference.getLangId(), reports);
+        if (!outStream.good()) {
+            cerr << "Failed to write " << outputFile.string() << endl;
+            return 1;
+        }
+    }
+
+    size_t inconsistent = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (reports[i].isConsistent()) { continue; }
+
+        inconsistent++;
+        if (!quiet) { cerr << inputs[i + 1].path.string() << ": " << reports[i].getIssueCount() << " issue(s)" << endl; }
+    }
+
+    return inconsistent == 0 ? 0 : 2;
+}
+
+void printHelp(const string& bin) {
+    cout << "Usage: " << bin << " -h" << endl
+         << "Usage: " << bin << " [-j<jobs>] [-o<file>] [-q] <reference> <translation>..." << endl << endl
+         << "Checks translations (borrfiles or " << lang_pack::FILE_EXTENSION << " language packs) against a reference language and reports" << endl
+         << "missing and extra keys, mismatched variables and differing line counts of multiline translations as JSON." << endl
+         << "Exits with 0 if all translations are consistent, 2 if any aren't and 1 on errors." << endl << endl
+         << "Arguments:" << endl
+         << "\t--help, -h\t\tDisplays this menu and exits" << endl
+         << "\t--jobs, -j<jobs>\tLoad and check up to jobs languages in parallel (default: number of CPUs)" << endl
+         << "\t--output, -o<file>\tWrite the JSON report to file instead of stdout" << endl
+         << "\t--quiet, -q\t\tDon't print a summary of inconsistent translations" << endl;
+}
+
+/**
+ * @brief Loads a single language; packs are recognised by their extension.
+ */
+void loadInput(input_t& input) {
+    try {
+        const fs::directory_entry file(input.path);
+        if (input.path.extension().string() == lang_pack::FILE_EXTENSION) {
+            language::fromPackFile(file, input.lang);
+        } else {
+            language::fromFile(file, input.lang);
+        }
+    } catch (const exception& ex) {
+        input.error = ex.what();
+    }
+}